@@ -0,0 +1,163 @@
+#include "EnemyBench.h"
+#include "GameWorld.h"
+#include "Graphics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace EnemyBench {
+
+namespace {
+
+constexpr float WORLD_WIDTH = 32000.0f;
+constexpr float WORLD_HEIGHT = 24000.0f;
+constexpr float STEP = 1.0f / 120.0f;
+
+// Enemies keep this far from where the player starts, so no run ends in a
+// game over
+constexpr float CLEAR_RADIUS = 800.0f;
+
+constexpr float MAX_ENEMY_SPEED = 140.0f;
+
+struct RunResult {
+  double enemySeconds = 0.0;   // "Enemies" system
+  double contactSeconds = 0.0; // "Enemy contact" system
+  double updatedEnemies = 0.0; // Near plus mid-range updates, summed
+};
+
+float nextFloat(uint32_t &seed) {
+  seed = seed * 1664525u + 1013904223u;
+  return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+}
+
+std::unique_ptr<GameWorld> createWorld(int enemyCount) {
+  auto world = std::make_unique<GameWorld>();
+
+  // Tile map setup is chatty
+  std::streambuf *coutBuffer = std::cout.rdbuf();
+  std::cout.rdbuf(nullptr);
+  world->initializeEmpty(800, 600);
+  std::cout.rdbuf(coutBuffer);
+
+  world->setWorldSize(WORLD_WIDTH, WORLD_HEIGHT);
+  const glm::vec2 start(WORLD_WIDTH / 2.0f, WORLD_HEIGHT / 2.0f);
+  world->createPlayer(start.x, start.y);
+  // Fast enough to be on the player after the first step
+  world->setCameraFollowSpeed(1.0f / STEP);
+
+  const MovementPattern patterns[] = {
+      MovementPattern::HORIZONTAL, MovementPattern::VERTICAL,
+      MovementPattern::CIRCULAR, MovementPattern::PATROL};
+  uint32_t seed = 2024u;
+  for (int i = 0; i < enemyCount;) {
+    glm::vec2 position(nextFloat(seed) * (WORLD_WIDTH - 400.0f) + 200.0f,
+                       nextFloat(seed) * (WORLD_HEIGHT - 400.0f) + 200.0f);
+    if (glm::length(position - start) < CLEAR_RADIUS)
+      continue;
+
+    Enemy *enemy =
+        world->createEnemy(position.x, position.y, patterns[i % 4]);
+    enemy->setMovementSpeed(MAX_ENEMY_SPEED - nextFloat(seed) * 80.0f);
+    i++;
+  }
+  return world;
+}
+
+RunResult run(GameWorld &world, int steps) {
+  RunResult result;
+  const SystemScheduler &systems = world.getSystemScheduler();
+
+  for (int step = 0; step < steps; step++) {
+    // A slow circle around the start
+    float angle = step * STEP * 0.5f;
+    world.setPlayerInput(glm::vec2(std::cos(angle), std::sin(angle)),
+                         100.0f);
+    world.update(STEP);
+
+    for (const auto &system : systems.getSystems()) {
+      if (system.name == "Enemies")
+        result.enemySeconds += system.seconds;
+      else if (system.name == "Enemy contact")
+        result.contactSeconds += system.seconds;
+    }
+    result.updatedEnemies += static_cast<double>(
+        world.getNearEnemyCount() + world.getMidEnemyUpdateCount());
+  }
+  return result;
+}
+
+void printRun(const char *name, const RunResult &result, int steps) {
+  std::cout << "    " << std::left << std::setw(10) << name << std::right
+            << std::fixed << std::setprecision(1) << std::setw(10)
+            << result.enemySeconds * 1e6 / steps << std::setw(12)
+            << result.contactSeconds * 1e6 / steps << std::setprecision(0)
+            << std::setw(12) << result.updatedEnemies / steps << std::endl;
+}
+
+} // namespace
+
+bool runLod(int steps, int enemyCount) {
+  // No GL context; the pig texture stays a null stub
+  Graphics::setEnabled(false);
+
+  std::cout << "enemy lod (" << enemyCount << " enemies in a "
+            << static_cast<int>(WORLD_WIDTH) << "x"
+            << static_cast<int>(WORLD_HEIGHT) << " world, " << steps
+            << " steps)" << std::endl;
+  std::cout << "    tiers     enemies us  contact us  updated/step"
+            << std::endl;
+
+  std::unique_ptr<GameWorld> full = createWorld(enemyCount);
+  full->setEnemyLodEnabled(false);
+  RunResult fullResult = run(*full, steps);
+  printRun("off", fullResult, steps);
+
+  std::unique_ptr<GameWorld> tiered = createWorld(enemyCount);
+  RunResult tieredResult = run(*tiered, steps);
+  printRun("on", tieredResult, steps);
+
+  std::cout << "    speedup " << std::setprecision(1)
+            << (fullResult.enemySeconds + fullResult.contactSeconds) /
+                   (tieredResult.enemySeconds + tieredResult.contactSeconds)
+            << "x" << std::endl;
+
+  // Oscillating and circling enemies are functions of time, so catching up
+  // in one update has to land where stepping got to. Patrols work their
+  // position out from the distance left on the current leg, so they have to
+  // stay within a step's movement of it.
+  tiered->syncAllEnemies();
+  const auto &fullEnemies = full->getEnemies();
+  const auto &tieredEnemies = tiered->getEnemies();
+  float closedFormError = 0.0f;
+  float patrolError = 0.0f;
+  for (size_t i = 0; i < fullEnemies.size(); i++) {
+    const Rectangle &a = fullEnemies[i]->bounds;
+    const Rectangle &b = tieredEnemies[i]->bounds;
+    float error = std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+    if (fullEnemies[i]->getMovementPattern() == MovementPattern::PATROL) {
+      patrolError = std::max(patrolError, error);
+    } else {
+      closedFormError = std::max(closedFormError, error);
+    }
+  }
+  std::cout << "    largest difference after catching up: "
+            << std::setprecision(3) << closedFormError
+            << " px (patrol " << patrolError << " px)" << std::endl;
+
+  const bool gameOver = full->getGameStateManager().isGameOver() ||
+                        tiered->getGameStateManager().isGameOver();
+  if (closedFormError > 1.0f || patrolError > MAX_ENEMY_SPEED * STEP ||
+      gameOver) {
+    std::cerr << "Bench: enemy level of detail diverged from full-rate "
+                 "updates"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace EnemyBench
@@ -0,0 +1,14 @@
+#pragma once
+
+// Enemy level of detail benchmark: a world far larger than the view with
+// enemies spread all over it.
+namespace EnemyBench {
+
+// Runs steps simulation steps of a 32000x24000 world with enemyCount
+// enemies, once with every enemy updated every step and once with the
+// level of detail tiers, and reports the enemy and contact cost per step.
+// Returns false if, once caught up, an oscillating or circling enemy of the
+// tiered run is more than a pixel from where the full-rate run has it.
+bool runLod(int steps, int enemyCount = 100000);
+
+} // namespace EnemyBench
@@ -0,0 +1,190 @@
+#include "JobBench.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace JobBench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t ELEMENTS = 1 << 20;
+constexpr size_t BATCH = 1024;
+constexpr int STAGES = 16;
+constexpr int JOBS_PER_STAGE = 256;
+
+// Some integer work per element whose result doesn't depend on the order
+// elements are processed in
+uint64_t hashElement(uint32_t value) {
+  for (int i = 0; i < 48; i++) {
+    value ^= value << 13;
+    value ^= value >> 17;
+    value ^= value << 5;
+  }
+  return value;
+}
+
+struct GraphResult {
+  int orderErrors = 0;
+  int affinityErrors = 0;
+  uint64_t sum = 0;
+};
+
+// STAGES stages of JOBS_PER_STAGE jobs, each stage scheduled after the
+// previous one's counter. Every job reads the previous stage's output, and a
+// main-thread job per stage checks that it runs on the main thread.
+GraphResult runGraph() {
+  JobSystem &jobs = JobSystem::get();
+  std::vector<std::vector<uint64_t>> output(
+      STAGES, std::vector<uint64_t>(JOBS_PER_STAGE, 0));
+  std::vector<JobCounter> counters(STAGES);
+  std::atomic<int> orderErrors(0);
+  std::atomic<int> affinityErrors(0);
+
+  for (int stage = 0; stage < STAGES; stage++) {
+    JobCounter *after = stage > 0 ? &counters[stage - 1] : nullptr;
+    for (int job = 0; job < JOBS_PER_STAGE; job++) {
+      jobs.schedule(
+          [&, stage, job]() {
+            uint64_t input = 1;
+            if (stage > 0) {
+              input = output[stage - 1][job];
+              if (input == 0)
+                orderErrors++;
+            }
+            output[stage][job] =
+                hashElement(static_cast<uint32_t>(input + job)) | 1;
+          },
+          &counters[stage], after);
+    }
+    jobs.scheduleOnMainThread(
+        [&]() {
+          if (!jobs.isMainThread())
+            affinityErrors++;
+        },
+        &counters[stage], after);
+  }
+
+  jobs.wait(counters[STAGES - 1]);
+  // Earlier counters are done too, but a last job may still be in finish()
+  for (JobCounter &counter : counters) {
+    jobs.wait(counter);
+  }
+
+  GraphResult result;
+  result.orderErrors = orderErrors;
+  result.affinityErrors = affinityErrors;
+  for (uint64_t value : output[STAGES - 1]) {
+    result.sum += value;
+  }
+  return result;
+}
+
+} // namespace
+
+bool runScaling(int rounds, int maxThreads) {
+  std::vector<uint32_t> input(ELEMENTS);
+  for (size_t i = 0; i < ELEMENTS; i++) {
+    input[i] = static_cast<uint32_t>(i * 2654435761u + 1);
+  }
+
+  uint64_t expectedSum = 0;
+  for (uint32_t value : input) {
+    expectedSum += hashElement(value);
+  }
+
+  // Graph result of a run without workers as the reference
+  JobSystem &jobs = JobSystem::get();
+  jobs.shutdown();
+  const uint64_t expectedGraphSum = runGraph().sum;
+
+  const unsigned hardwareThreads =
+      std::max(1u, std::thread::hardware_concurrency());
+  const unsigned threadLimit =
+      maxThreads > 0 ? static_cast<unsigned>(maxThreads) : hardwareThreads;
+  std::cout << "jobs (parallelFor over " << ELEMENTS << " elements, graph of "
+            << STAGES << "x" << JOBS_PER_STAGE << " jobs, " << rounds
+            << " rounds, " << hardwareThreads << " hardware threads)"
+            << std::endl;
+  std::cout << "    threads  parallelFor ms  speedup    graph ms  speedup"
+            << "   steals" << std::endl;
+
+  // The output of std::cout from initialize/shutdown would break the table
+  std::streambuf *coutBuffer = std::cout.rdbuf();
+  double forBaseline = 0.0;
+  double graphBaseline = 0.0;
+  int failures = 0;
+  std::vector<uint64_t> partialSums(ELEMENTS / BATCH + 1);
+
+  for (unsigned threads = 1; threads <= threadLimit; threads++) {
+    std::cout.rdbuf(nullptr);
+    jobs.initialize(static_cast<int>(threads) - 1);
+    std::cout.rdbuf(coutBuffer);
+
+    double forSeconds = 0.0;
+    double graphSeconds = 0.0;
+    for (int round = 0; round < rounds; round++) {
+      std::fill(partialSums.begin(), partialSums.end(), 0);
+      auto t0 = Clock::now();
+      jobs.parallelFor(ELEMENTS, BATCH, [&](size_t begin, size_t end) {
+        uint64_t sum = 0;
+        for (size_t i = begin; i < end; i++) {
+          sum += hashElement(input[i]);
+        }
+        partialSums[begin / BATCH] = sum;
+      });
+      auto t1 = Clock::now();
+      GraphResult graph = runGraph();
+      auto t2 = Clock::now();
+
+      forSeconds += std::chrono::duration<double>(t1 - t0).count();
+      graphSeconds += std::chrono::duration<double>(t2 - t1).count();
+
+      uint64_t sum = 0;
+      for (uint64_t partial : partialSums) {
+        sum += partial;
+      }
+      if (sum != expectedSum || graph.sum != expectedGraphSum ||
+          graph.orderErrors || graph.affinityErrors) {
+        failures++;
+      }
+    }
+
+    forSeconds /= rounds;
+    graphSeconds /= rounds;
+    if (threads == 1) {
+      forBaseline = forSeconds;
+      graphBaseline = graphSeconds;
+    }
+
+    std::cout << "    " << std::setw(7) << threads << std::fixed
+              << std::setprecision(3) << std::setw(16) << forSeconds * 1e3
+              << std::setprecision(2) << std::setw(8)
+              << forBaseline / forSeconds << "x" << std::setprecision(3)
+              << std::setw(12) << graphSeconds * 1e3 << std::setprecision(2)
+              << std::setw(8) << graphBaseline / graphSeconds << "x"
+              << std::setw(9) << jobs.getStolenCount() << std::endl;
+
+    std::cout.rdbuf(nullptr);
+    jobs.shutdown();
+    std::cout.rdbuf(coutBuffer);
+  }
+
+  if (failures) {
+    std::cerr << "Bench: " << failures
+              << " job rounds gave wrong results (sums, stage order or "
+                 "main-thread affinity)"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace JobBench
@@ -0,0 +1,16 @@
+#pragma once
+
+// Job system benchmarks, run with 1 (the calling thread alone) up to all
+// hardware threads so the scaling shows.
+namespace JobBench {
+
+// Per thread count (1 to maxThreads, 0 = the hardware threads): a
+// parallelFor over 1M elements of hashing work, and a graph of small jobs in
+// dependent stages with a main-thread job at the end of each stage, rounds
+// times. Reports the time per round and the speedup
+// over one thread. Returns false if a sum differs from the serial one, a
+// stage starts before the one it depends on is done or a main-thread job
+// runs on another thread.
+bool runScaling(int rounds, int maxThreads = 0);
+
+} // namespace JobBench
@@ -0,0 +1,551 @@
+#include "RenderBench.h"
+#include "RenderLayers.h"
+#include "SpriteAnimation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <gl2d/gl2d.h>
+#include <gl2d/gl2dParticleSystem.h>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace RenderBench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int SCREEN_WIDTH = 800;
+constexpr int SCREEN_HEIGHT = 600;
+constexpr int TILE_SIZE = 32;
+
+// Stand-in texture ids; the renderer only looks at the id until it binds
+constexpr GLuint WHITE_TEXTURE = 1;
+constexpr GLuint PIG_TEXTURE = 2;
+constexpr GLuint FONT_TEXTURE = 3;
+constexpr GLuint FIRST_TILE_TEXTURE = 10;
+constexpr int TILE_TEXTURE_COUNT = 4;
+
+gl2d::Texture fakeTexture(GLuint id) {
+  gl2d::Texture texture;
+  texture.id = id;
+  return texture;
+}
+
+class FrameBuilder {
+public:
+  explicit FrameBuilder(gl2d::Renderer2D &renderer) : renderer(renderer) {}
+
+  // The quad's submission index goes into its texture coordinates so the
+  // order can be read back after sorting
+  void quad(uint32_t layer, GLuint textureId, float x, float y, float w,
+            float h) {
+    float index = static_cast<float>(keys.size());
+    renderer.setLayer(layer);
+    renderer.renderRectangle({x, y, w, h}, fakeTexture(textureId),
+                             gl2d::Color4f{1, 1, 1, 1}, {0, 0}, 0,
+                             {index, 0, index, 1});
+    keys.push_back((static_cast<uint64_t>(layer) << 32) | textureId);
+  }
+
+  std::vector<uint64_t> keys;
+
+private:
+  gl2d::Renderer2D &renderer;
+};
+
+// Same order of sections as GameWorld::render
+std::vector<uint64_t> submitFrame(gl2d::Renderer2D &renderer) {
+  FrameBuilder frame(renderer);
+
+  // Terrain in 3x3 patches, like hand made maps
+  for (int y = 0; y < SCREEN_HEIGHT / TILE_SIZE + 1; y++) {
+    for (int x = 0; x < SCREEN_WIDTH / TILE_SIZE + 1; x++) {
+      uint32_t patch = static_cast<uint32_t>((x / 3) * 7919 + (y / 3) * 104729);
+      patch = (patch ^ (patch >> 7)) * 2654435761u;
+      GLuint texture = FIRST_TILE_TEXTURE + (patch >> 16) % TILE_TEXTURE_COUNT;
+      frame.quad(RenderLayer::TILES, texture, x * TILE_SIZE, y * TILE_SIZE,
+                 TILE_SIZE, TILE_SIZE);
+    }
+  }
+
+  for (int i = 0; i < 30; i++) {
+    frame.quad(RenderLayer::OBJECTS, WHITE_TEXTURE, (i * 97) % SCREEN_WIDTH,
+               (i * 61) % SCREEN_HEIGHT, 20, 20);
+  }
+
+  for (int i = 0; i < 12; i++) {
+    frame.quad(RenderLayer::ENEMIES, PIG_TEXTURE, (i * 131) % SCREEN_WIDTH,
+               (i * 89) % SCREEN_HEIGHT, 32, 32);
+  }
+
+  frame.quad(RenderLayer::PATH, WHITE_TEXTURE, 400, 300, 12, 12);
+  frame.quad(RenderLayer::PATH, WHITE_TEXTURE, 403, 303, 6, 6);
+
+  frame.quad(RenderLayer::OVERLAY, WHITE_TEXTURE, 0, 0, SCREEN_WIDTH,
+             SCREEN_HEIGHT);
+  for (int i = 0; i < 40; i++) {
+    frame.quad(RenderLayer::OVERLAY_TEXT, FONT_TEXTURE, 250 + (i % 20) * 15,
+               220 + (i / 20) * 100, 14, 20);
+  }
+
+  return frame.keys;
+}
+
+// Draw calls internalFlush issues for the pending quads
+size_t countBatches(const gl2d::Renderer2D &renderer) {
+  const auto &textures = renderer.spriteTextures;
+  size_t batches = textures.empty() ? 0 : 1;
+  for (size_t i = 1; i < textures.size(); i++) {
+    if (textures[i].id != textures[i - 1].id)
+      batches++;
+  }
+  return batches;
+}
+
+// Glyph metrics in the layout of an stbtt pack, so text can be laid out
+// without loading a font into a texture
+struct SyntheticFont {
+  std::vector<stbtt_packedchar> glyphs;
+  gl2d::Font font;
+
+  SyntheticFont() : glyphs('~' - ' ' + 1) {
+    for (size_t i = 0; i < glyphs.size(); i++) {
+      stbtt_packedchar &glyph = glyphs[i];
+      unsigned short width = static_cast<unsigned short>(8 + i % 5);
+      unsigned short height = static_cast<unsigned short>(12 + i % 7);
+      glyph.x0 = static_cast<unsigned short>((i % 16) * 16);
+      glyph.y0 = static_cast<unsigned short>((i / 16) * 24);
+      glyph.x1 = glyph.x0 + width;
+      glyph.y1 = glyph.y0 + height;
+      glyph.xoff = 0.5f;
+      glyph.yoff = -static_cast<float>(height);
+      glyph.xadvance = width + 1.0f;
+    }
+    font.texture = fakeTexture(FONT_TEXTURE);
+    font.size = {256, 256};
+    font.packedCharsBuffer = glyphs.data();
+    font.packedCharsBufferSize = static_cast<int>(glyphs.size());
+    font.max_height = 20.0f;
+  }
+};
+
+} // namespace
+
+bool runBatching(int frames) {
+  gl2d::Renderer2D renderer;
+  renderer.updateWindowMetrics(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+  std::vector<uint64_t> keys = submitFrame(renderer);
+  size_t unsortedBatches = countBatches(renderer);
+  renderer.sortDrawData();
+  size_t sortedBatches = countBatches(renderer);
+
+  // Reference: stable sort of the submission indices by key
+  std::vector<uint32_t> expected(keys.size());
+  std::iota(expected.begin(), expected.end(), 0u);
+  std::stable_sort(expected.begin(), expected.end(),
+                   [&keys](uint32_t a, uint32_t b) {
+                     return keys[a] < keys[b];
+                   });
+
+  bool orderMatches = renderer.spriteTextures.size() == expected.size();
+  for (size_t i = 0; orderMatches && i < expected.size(); i++) {
+    uint32_t submitted = static_cast<uint32_t>(
+        renderer.vertices[i * 4].texturePosition.x);
+    orderMatches = submitted == expected[i] &&
+                   renderer.spriteTextures[i].id ==
+                       static_cast<GLuint>(keys[submitted] & 0xFFFFFFFFu);
+  }
+
+  double submitSeconds = 0.0;
+  double sortSeconds = 0.0;
+  for (int frame = 0; frame < frames; frame++) {
+    renderer.clearDrawData();
+    auto t0 = Clock::now();
+    submitFrame(renderer);
+    auto t1 = Clock::now();
+    renderer.sortDrawData();
+    auto t2 = Clock::now();
+    submitSeconds += std::chrono::duration<double>(t1 - t0).count();
+    sortSeconds += std::chrono::duration<double>(t2 - t1).count();
+  }
+
+  std::cout << "render batching (" << keys.size() << " quads)" << std::endl;
+  std::cout << "    draw calls " << unsortedBatches << " in submission order, "
+            << sortedBatches << " sorted" << std::endl;
+  std::cout << "    submit " << std::fixed << std::setprecision(3)
+            << submitSeconds * 1e6 / frames << " us/frame, sort "
+            << sortSeconds * 1e6 / frames << " us/frame" << std::endl;
+  std::cout << "    ordering " << (orderMatches ? "matches" : "DIFFERS FROM")
+            << " stable (layer, texture) order" << std::endl;
+
+  if (!orderMatches) {
+    std::cerr << "Bench: sorted quads are not in stable key order"
+              << std::endl;
+    return false;
+  }
+  if (sortedBatches >= unsortedBatches) {
+    std::cerr << "Bench: sorting did not reduce the draw calls" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool runSubmission(int frames) {
+  constexpr int QUADS = 100000;
+
+  gl2d::Renderer2D renderer;
+  renderer.updateWindowMetrics(SCREEN_WIDTH, SCREEN_HEIGHT);
+  gl2d::Camera camera;
+  camera.position = {120.0f, -40.0f};
+  renderer.setCamera(camera);
+
+  const gl2d::Texture texture = fakeTexture(PIG_TEXTURE);
+  const gl2d::Color4f color = {1.0f, 0.8f, 0.6f, 1.0f};
+
+  // Both paths get the same quads; the rotation varies so neither skips the
+  // rotation math
+  auto submit = [&](bool sprites) {
+    for (int i = 0; i < QUADS; i++) {
+      gl2d::Rect rect = {static_cast<float>(i % 1000),
+                         static_cast<float>(i / 1000) * 6.0f, 16.0f, 16.0f};
+      float rotation = static_cast<float>(i % 360);
+      if (sprites) {
+        renderer.renderSprite(rect, texture, color, {0, 0}, rotation);
+      } else {
+        renderer.renderRectangle(rect, texture, color, {0, 0}, rotation);
+      }
+    }
+  };
+
+  double seconds[2] = {};
+  size_t bytes[2] = {};
+  for (int frame = 0; frame < frames; frame++) {
+    for (int sprites = 0; sprites < 2; sprites++) {
+      renderer.clearDrawData();
+      auto t0 = Clock::now();
+      submit(sprites != 0);
+      seconds[sprites] +=
+          std::chrono::duration<double>(Clock::now() - t0).count();
+      bytes[sprites] =
+          renderer.vertices.size() * sizeof(gl2d::Vertex2D) +
+          renderer.spriteInstances.size() * sizeof(gl2d::SpriteInstance);
+    }
+  }
+
+  std::cout << "quad submission (" << QUADS << " rotated quads, " << frames
+            << " frames)" << std::endl;
+  const char *names[2] = {"renderRectangle", "renderSprite"};
+  for (int path = 0; path < 2; path++) {
+    std::cout << "    " << std::left << std::setw(16) << names[path]
+              << std::right << std::setw(10) << std::fixed
+              << std::setprecision(1) << seconds[path] * 1e6 / frames
+              << " us/100k" << std::setw(10) << bytes[path] / 1024
+              << " KiB uploaded" << std::endl;
+  }
+  if (seconds[1] > 0.0) {
+    std::cout << "    speedup " << std::setprecision(2)
+              << seconds[0] / seconds[1] << "x" << std::endl;
+  }
+  return true;
+}
+
+bool runText(int frames) {
+  constexpr int LABELS = 500;
+  constexpr int DYNAMIC_EVERY = 10;
+
+  SyntheticFont synthetic;
+  const gl2d::Font &font = synthetic.font;
+  const gl2d::Color4f color = {1.0f, 1.0f, 1.0f, 1.0f};
+
+  gl2d::Renderer2D renderer;
+  renderer.updateWindowMetrics(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+  std::vector<std::string> fixedText(LABELS);
+  for (int i = 0; i < LABELS; i++) {
+    fixedText[i] = "Enemy " + std::to_string(i) + " - patrol";
+  }
+
+  std::vector<gl2d::TextRun> prebuilt(LABELS);
+  for (int i = 0; i < LABELS; i++) {
+    gl2d::layoutText(prebuilt[i], fixedText[i].c_str(), font, 0.5f, 2, 3,
+                     true);
+  }
+
+  // Labels follow their enemies around; every tenth shows a changing value
+  std::string dynamicText;
+  auto submit = [&](int frame, bool usePrebuilt) {
+    for (int i = 0; i < LABELS; i++) {
+      glm::vec2 position = {static_cast<float>((i * 37 + frame) % 800),
+                            static_cast<float>((i * 23 + frame / 2) % 600)};
+      if (i % DYNAMIC_EVERY == 0) {
+        dynamicText = "HP " + std::to_string((frame * 7 + i) % 1000);
+        renderer.renderText(position, dynamicText.c_str(), font, color, 0.5f,
+                            2, 3, true);
+      } else if (usePrebuilt) {
+        renderer.renderTextRun(position, prebuilt[i], color);
+      } else {
+        renderer.renderText(position, fixedText[i].c_str(), font, color,
+                            0.5f, 2, 3, true);
+      }
+    }
+  };
+
+  // Same frame laid out fresh and from a warm cache must give the same
+  // sprites
+  renderer.textLayoutCaching = false;
+  submit(0, false);
+  std::vector<gl2d::SpriteInstance> expected = renderer.spriteInstances;
+  renderer.clearDrawData();
+  renderer.textLayoutCaching = true;
+  submit(0, false);
+  renderer.clearDrawData();
+  submit(0, false);
+  bool glyphsMatch =
+      renderer.spriteInstances.size() == expected.size() &&
+      std::memcmp(renderer.spriteInstances.data(), expected.data(),
+                  expected.size() * sizeof(gl2d::SpriteInstance)) == 0;
+  renderer.clearDrawData();
+  renderer.textLayoutCache.clear();
+
+  const char *names[3] = {"layout every call", "layout cache",
+                          "cache + prebuilt"};
+  double seconds[3] = {};
+  size_t glyphs = 0;
+  for (int mode = 0; mode < 3; mode++) {
+    renderer.textLayoutCaching = mode != 0;
+    renderer.textLayoutCache.hits = 0;
+    renderer.textLayoutCache.misses = 0;
+    for (int frame = 0; frame < frames; frame++) {
+      renderer.clearDrawData();
+      auto t0 = Clock::now();
+      submit(frame, mode == 2);
+      seconds[mode] +=
+          std::chrono::duration<double>(Clock::now() - t0).count();
+      // flush would do this
+      renderer.textLayoutCache.endFrame();
+    }
+    glyphs = renderer.spriteInstances.size();
+  }
+
+  const gl2d::TextLayoutCache &cache = renderer.textLayoutCache;
+  std::cout << "text layout (" << LABELS << " labels, " << glyphs
+            << " glyphs, " << frames << " frames)" << std::endl;
+  for (int mode = 0; mode < 3; mode++) {
+    std::cout << "    " << std::left << std::setw(18) << names[mode]
+              << std::right << std::setw(10) << std::fixed
+              << std::setprecision(1) << seconds[mode] * 1e6 / frames
+              << " us/frame" << std::endl;
+  }
+  std::cout << "    last run: " << cache.hits << " hits, " << cache.misses
+            << " misses, " << cache.size() << " cached runs" << std::endl;
+  std::cout << "    cached glyphs " << (glyphsMatch ? "match" : "DIFFER FROM")
+            << " a fresh layout" << std::endl;
+
+  if (!glyphsMatch) {
+    std::cerr << "Bench: cached text layout differs from a fresh one"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool runParticles(int frames) {
+  constexpr int LIVE = 100000;
+  constexpr int WAVE = 1000;
+  constexpr float DT = 1.0f / 60.0f;
+
+  gl2d::ParticleSettings settings;
+  settings.onCreateCount = WAVE;
+  settings.positionX = {-20.0f, 20.0f};
+  settings.positionY = {-20.0f, 20.0f};
+  settings.particleLifeTime = {0.5f, 1.5f};
+  settings.directionX = {-200.0f, 200.0f};
+  settings.directionY = {-200.0f, 200.0f};
+  settings.dragY = {100.0f, 300.0f};
+  settings.rotationSpeed = {-180.0f, 180.0f};
+  settings.createApearence.size = {2.0f, 6.0f};
+  settings.createApearence.color1 = {1.0f, 0.5f, 0.0f, 1.0f};
+  settings.createApearence.color2 = {1.0f, 1.0f, 0.5f, 1.0f};
+  // renderSprite's untextured overload needs gl2d::init for its white texture
+  gl2d::Texture white = fakeTexture(WHITE_TEXTURE);
+  settings.texturePtr = &white;
+
+  gl2d::ParticleSystem particles;
+  particles.initParticleSystem(LIVE);
+  particles.postProcessing = false;
+
+  gl2d::Renderer2D renderer;
+  renderer.updateWindowMetrics(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+  int frameIndex = 0;
+  int lowestLive = LIVE;
+  auto refill = [&]() {
+    while (particles.getLiveCount() < LIVE) {
+      int before = particles.getLiveCount();
+      glm::vec2 position = {
+          static_cast<float>((frameIndex * 37 + before) % SCREEN_WIDTH),
+          static_cast<float>((frameIndex * 23 + before) % SCREEN_HEIGHT)};
+      particles.emitParticleWave(&settings, position);
+      if (particles.getLiveCount() == before)
+        break;
+    }
+  };
+
+  // Reach the steady state where about a second's worth dies every second
+  for (int i = 0; i < 120; i++, frameIndex++) {
+    refill();
+    particles.applyMovement(DT);
+  }
+
+  const char *names[2] = {"scalar update", "sse update"};
+  double updateSeconds[2] = {};
+  double emitSeconds = 0.0;
+  double drawSeconds = 0.0;
+  size_t sprites = 0;
+  for (int mode = 0; mode < 2; mode++) {
+    particles.useSimd = mode == 1;
+    for (int frame = 0; frame < frames; frame++, frameIndex++) {
+      auto t0 = Clock::now();
+      refill();
+      auto t1 = Clock::now();
+      lowestLive = std::min(lowestLive, particles.getLiveCount());
+      particles.applyMovement(DT);
+      auto t2 = Clock::now();
+      renderer.clearDrawData();
+      particles.draw(renderer);
+      auto t3 = Clock::now();
+
+      emitSeconds += std::chrono::duration<double>(t1 - t0).count();
+      updateSeconds[mode] += std::chrono::duration<double>(t2 - t1).count();
+      drawSeconds += std::chrono::duration<double>(t3 - t2).count();
+      sprites = renderer.spriteInstances.size();
+    }
+  }
+  renderer.clearDrawData();
+
+  std::cout << "particles (" << LIVE << " live, " << frames
+            << " frames per update path, GL2D_SIMD " << GL2D_SIMD << ")"
+            << std::endl;
+  std::cout << "    " << std::left << std::setw(16) << "emit" << std::right
+            << std::setw(10) << std::fixed << std::setprecision(1)
+            << emitSeconds * 1e6 / (frames * 2) << " us/frame" << std::endl;
+  for (int mode = 0; mode < 2; mode++) {
+    std::cout << "    " << std::left << std::setw(16) << names[mode]
+              << std::right << std::setw(10) << std::fixed
+              << std::setprecision(1) << updateSeconds[mode] * 1e6 / frames
+              << " us/frame" << std::endl;
+  }
+  std::cout << "    " << std::left << std::setw(16) << "draw" << std::right
+            << std::setw(10) << std::fixed << std::setprecision(1)
+            << drawSeconds * 1e6 / (frames * 2) << " us/frame, " << sprites
+            << " sprites" << std::endl;
+
+  if (lowestLive < LIVE) {
+    std::cerr << "Bench: only " << lowestLive << " of " << LIVE
+              << " particles could be kept alive" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool runAnimation(int frames) {
+  constexpr int ENTITIES = 10000;
+  constexpr float DT = 1.0f / 60.0f;
+
+  // A few clips of an 8x8 sheet with uneven frame durations
+  const std::vector<std::vector<float>> durations = {
+      {0.18f, 0.12f, 0.18f, 0.12f},
+      {0.1f, 0.05f, 0.2f, 0.07f, 0.13f, 0.05f},
+      {0.08f},
+      {0.3f, 0.02f, 0.3f}};
+  // A single duration is shared by 6 frames
+  auto frameCount = [&](size_t clip) {
+    return durations[clip].size() == 1 ? 6u
+                                       : uint32_t(durations[clip].size());
+  };
+  AnimationLibrary library;
+  int firstCell = 0;
+  for (size_t c = 0; c < durations.size(); c++) {
+    int count = static_cast<int>(frameCount(c));
+    library.addSheetClip("clip" + std::to_string(c), 8, 8, firstCell, count,
+                         durations[c], c != 3);
+    firstCell += count;
+  }
+
+  std::vector<AnimationState> states(ENTITIES);
+  for (int i = 0; i < ENTITIES; i++) {
+    states[i].clip = static_cast<uint16_t>(i % durations.size());
+    states[i].time = std::fmod(i * 0.37f,
+                               library.getClipDuration(states[i].clip));
+  }
+
+  // Reference: walk the clip's durations, summed the same way the library
+  // does
+  uint32_t clipStart[4] = {};
+  for (size_t c = 1; c < durations.size(); c++) {
+    clipStart[c] = clipStart[c - 1] + frameCount(c - 1);
+  }
+  auto referenceFrame = [&](const AnimationState &state) {
+    const std::vector<float> &d = durations[state.clip];
+    uint32_t count = frameCount(state.clip);
+    float end = 0.0f;
+    for (uint32_t f = 0; f < count; f++) {
+      end += d.size() == 1 ? d[0] : d[f];
+      if (state.time < end || f + 1 == count)
+        return clipStart[state.clip] + f;
+    }
+    return clipStart[state.clip];
+  };
+
+  double advanceSeconds = 0.0;
+  double lookupSeconds = 0.0;
+  int mismatches = 0;
+  std::vector<glm::vec4> uvs(ENTITIES);
+  for (int frame = 0; frame < frames; frame++) {
+    auto t0 = Clock::now();
+    library.advance(states.data(), states.size(), DT);
+    auto t1 = Clock::now();
+    for (int i = 0; i < ENTITIES; i++) {
+      uvs[i] = library.getFrameUV(states[i]);
+    }
+    auto t2 = Clock::now();
+
+    advanceSeconds += std::chrono::duration<double>(t1 - t0).count();
+    lookupSeconds += std::chrono::duration<double>(t2 - t1).count();
+
+    if (frame % 10 == 0) {
+      for (const AnimationState &state : states) {
+        if (library.getFrameIndex(state) != referenceFrame(state))
+          mismatches++;
+      }
+    }
+  }
+
+  std::cout << "animation (" << ENTITIES << " entities, "
+            << library.getClipCount() << " clips, " << frames << " frames)"
+            << std::endl;
+  std::cout << "    " << std::left << std::setw(16) << "advance"
+            << std::right << std::setw(10) << std::fixed
+            << std::setprecision(2) << advanceSeconds * 1e6 / frames
+            << " us/frame" << std::endl;
+  std::cout << "    " << std::left << std::setw(16) << "frame uvs"
+            << std::right << std::setw(10) << std::fixed
+            << std::setprecision(2) << lookupSeconds * 1e6 / frames
+            << " us/frame" << std::endl;
+
+  if (mismatches) {
+    std::cerr << "Bench: " << mismatches
+              << " animation frames differ from the reference" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace RenderBench
@@ -0,0 +1,36 @@
+#pragma once
+
+// Renderer benchmarks that only exercise gl2d's CPU side, so they run
+// without a GL context like the rest of mygame_bench.
+namespace RenderBench {
+
+// Submits a frame laid out like GameWorld::render (a tile map with several
+// tile textures, white rectangles, enemies, path marker and game over text)
+// and sorts it the way Renderer2D::flush does with textureSorting on, frames
+// times. Checks the result against a reference stable sort of the sort keys
+// and that it needs fewer draw calls than submission order; returns false
+// when either check fails.
+bool runBatching(int frames);
+
+// Submits 100k rotated, textured quads per frame through renderRectangle and
+// through renderSprite and reports the CPU cost of each per 100k quads.
+bool runSubmission(int frames);
+
+// Submits a HUD of 500 labels per frame (all of them moving, a tenth of them
+// with text that changes every frame) through renderText with and without
+// the layout cache, and with the fixed labels as prebuilt runs. Returns false
+// if the cached glyphs differ from freshly laid out ones.
+bool runText(int frames);
+
+// Keeps 100k particles alive in a gl2d::ParticleSystem, refilling the dead
+// ones through emitParticleWave every frame, and times emission, the
+// movement update (SSE kernel and scalar loop) and queuing them as sprites.
+// Returns false if the system can't be kept full.
+bool runParticles(int frames);
+
+// Advances 10k enemies' (clip, time) animation states through an
+// AnimationLibrary and looks up their frame uvs, frames times. Returns false
+// if a looked up frame differs from a search of the clip's frame durations.
+bool runAnimation(int frames);
+
+} // namespace RenderBench
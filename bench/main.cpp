@@ -0,0 +1,406 @@
+// Headless simulation benchmark. Loads .scene files or built-in scene
+// templates without a window or GL context, runs a fixed number of
+// simulation steps with scripted input and reports where the time went.
+//
+// Usage: mygame_bench [--steps N] [--scene file.scene]... [--template name]...
+//                     [--trace trace.json] [--batching] [--submission]
+//                     [--text] [--particles] [--animation] [--jobs]
+//                     [--job-threads N] [--enemies]
+// Without --scene/--template every template and every scene in
+// resources/scenes is run. --trace writes the profiler zones of the run as a
+// Chrome trace (needs CROWNFLAME_PROFILER). --batching runs the renderer's
+// texture sorting on a synthetic frame --steps times instead of any scene;
+// --submission compares the CPU cost of renderRectangle and renderSprite
+// (100 frames of 100k quads unless --steps is given); --text times a HUD of
+// 500 labels with and without the text layout cache (1000 frames unless
+// --steps is given); --particles times 100k live particles (300 frames per
+// update path unless --steps is given); --animation times 10k animated
+// sprites (1000 frames unless --steps is given); --jobs runs the job system
+// scaling benchmark with 1 up to all hardware threads, or up to
+// --job-threads (20 rounds per thread count unless --steps is given).
+// --enemies compares enemy updates with and without level of detail in a
+// large world of 100k enemies (600 steps unless --steps is given).
+// Scene runs use --job-threads threads for the world's systems, however
+// little work they have (default 1, everything in order on the main thread).
+
+#include "EnemyBench.h"
+#include "GameWorld.h"
+#include "Graphics.h"
+#include "JobBench.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "RenderBench.h"
+#include "Scene.h"
+#include "SceneManager.h"
+#include "SceneTemplates.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Same step size and player speed as the game
+constexpr double FIXED_TIMESTEP = 1.0 / 120.0;
+constexpr float PLAYER_SPEED = 200.0f;
+constexpr int SCREEN_WIDTH = 800;
+constexpr int SCREEN_HEIGHT = 600;
+
+// Scripted input cycle: walk in a circle, then click somewhere and let the
+// player follow the path for the rest of the cycle
+constexpr int INPUT_CYCLE_STEPS = 720;
+constexpr int WALK_STEPS = 480;
+
+struct BenchCase {
+  std::string label;
+  std::string scenePath; // empty for templates
+  SceneTemplates::TemplateType templateType =
+      SceneTemplates::TemplateType::EMPTY;
+};
+
+struct BenchResult {
+  double loadSeconds = 0.0;
+  double sceneSeconds = 0.0; // SceneManager::update minus the world systems
+  double scheduleSeconds = 0.0; // Wall time of the world systems
+  double pathSearchSeconds = 0.0;
+  double restartSeconds = 0.0;
+  double totalSeconds = 0.0;
+  std::vector<std::string> systemNames;
+  std::vector<double> systemSeconds;
+  int restarts = 0;
+  glm::vec2 finalPlayerPosition = glm::vec2(0.0f);
+};
+
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::string toLower(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return text;
+}
+
+bool findTemplate(const std::string &name,
+                  SceneTemplates::TemplateType &type) {
+  for (const auto &info : SceneTemplates::getAvailableTemplates()) {
+    if (toLower(info.name) == toLower(name)) {
+      type = info.type;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Deterministic click targets so every run requests the same paths
+glm::vec2 nextClickTarget(uint32_t &seed) {
+  seed = seed * 1664525u + 1013904223u;
+  float x = static_cast<float>(seed >> 8 & 0xffff) / 65535.0f;
+  seed = seed * 1664525u + 1013904223u;
+  float y = static_cast<float>(seed >> 8 & 0xffff) / 65535.0f;
+  return glm::vec2(x * SCREEN_WIDTH, y * SCREEN_HEIGHT);
+}
+
+bool runCase(const BenchCase &benchCase, int steps, BenchResult &result) {
+  SceneManager sceneManager;
+  if (!sceneManager.initialize(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+    return false;
+  }
+
+  const std::string sceneName = "bench";
+  auto loadStart = Clock::now();
+  bool loaded =
+      benchCase.scenePath.empty()
+          ? sceneManager.loadSceneFromDefinition(
+                sceneName, SceneTemplates::createFromTemplate(
+                               benchCase.templateType, sceneName))
+          : sceneManager.loadSceneFromFile(sceneName, benchCase.scenePath);
+  if (!loaded || !sceneManager.changeSceneInstant(sceneName)) {
+    std::cerr << "Bench: failed to load '" << benchCase.label << "'"
+              << std::endl;
+    sceneManager.shutdown();
+    return false;
+  }
+  result.loadSeconds = secondsSince(loadStart);
+
+  const float dt = static_cast<float>(FIXED_TIMESTEP);
+  uint32_t clickSeed = 12345u;
+
+  auto runStart = Clock::now();
+  for (int step = 0; step < steps; step++) {
+    PROFILE_FRAME();
+
+    Scene *scene = sceneManager.getCurrentScene();
+    GameWorld *world = scene ? scene->getGameWorld() : nullptr;
+    if (!world)
+      break;
+
+    // Keep the load steady: a lost (or won) game starts over
+    if (!world->getGameStateManager().isPlaying()) {
+      auto restartStart = Clock::now();
+      sceneManager.restartCurrentScene();
+      result.restartSeconds += secondsSince(restartStart);
+      result.restarts++;
+
+      scene = sceneManager.getCurrentScene();
+      world = scene ? scene->getGameWorld() : nullptr;
+      if (!world)
+        break;
+    }
+
+    // Mirrors Application: input is handed to the world, which runs player
+    // movement, camera and pathfinding with its other systems
+    int cycleStep = step % INPUT_CYCLE_STEPS;
+    glm::vec2 movement(0.0f);
+    if (cycleStep < WALK_STEPS) {
+      float angle = step * dt * 0.5f;
+      movement = glm::vec2(std::cos(angle), std::sin(angle));
+    } else if (cycleStep == WALK_STEPS) {
+      auto searchStart = Clock::now();
+      world->handleMouseInput(nextClickTarget(clickSeed));
+      result.pathSearchSeconds += secondsSince(searchStart);
+    }
+    world->setPlayerInput(movement, PLAYER_SPEED);
+    world->getSystemScheduler().setMinParallelSeconds(0.0);
+
+    const GameWorld *updatedWorld = world;
+    const uint64_t runs = world->getSystemScheduler().getRunCount();
+    auto updateStart = Clock::now();
+    sceneManager.update(dt);
+    double updateSeconds = secondsSince(updateStart);
+
+    // Only a step the world's systems actually ran in counts towards them
+    scene = sceneManager.getCurrentScene();
+    world = scene ? scene->getGameWorld() : nullptr;
+    if (world != updatedWorld ||
+        world->getSystemScheduler().getRunCount() != runs + 1) {
+      result.sceneSeconds += updateSeconds;
+      continue;
+    }
+
+    const SystemScheduler &systems = world->getSystemScheduler();
+    const auto &list = systems.getSystems();
+    if (result.systemNames.size() != list.size()) {
+      result.systemNames.clear();
+      for (const auto &system : list)
+        result.systemNames.push_back(system.name);
+      result.systemSeconds.assign(list.size(), 0.0);
+    }
+    for (size_t i = 0; i < list.size(); i++) {
+      if (list[i].enabled)
+        result.systemSeconds[i] += list[i].seconds;
+    }
+    result.scheduleSeconds += systems.getLastRunSeconds();
+    result.sceneSeconds += updateSeconds - systems.getLastRunSeconds();
+  }
+  result.totalSeconds = secondsSince(runStart);
+
+  Scene *scene = sceneManager.getCurrentScene();
+  GameWorld *world = scene ? scene->getGameWorld() : nullptr;
+  if (world && world->getPlayer()) {
+    result.finalPlayerPosition =
+        glm::vec2(world->getPlayer()->bounds.x, world->getPlayer()->bounds.y);
+  }
+
+  sceneManager.shutdown();
+  return true;
+}
+
+void printRow(const std::string &name, double seconds, double total,
+              int steps) {
+  std::cout << "    " << std::left << std::setw(16) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(3)
+            << seconds * 1e6 / steps << " us/step" << std::setw(8)
+            << std::setprecision(1)
+            << (total > 0.0 ? seconds / total * 100.0 : 0.0) << " %"
+            << std::endl;
+}
+
+void printResult(const BenchCase &benchCase, const BenchResult &result,
+                 int steps) {
+  std::cout << benchCase.label << std::endl;
+  std::cout << "    load " << std::fixed << std::setprecision(2)
+            << result.loadSeconds * 1000.0 << " ms, " << steps
+            << " steps in " << result.totalSeconds * 1000.0 << " ms ("
+            << std::setprecision(0)
+            << (result.totalSeconds > 0.0 ? steps / result.totalSeconds : 0.0)
+            << " steps/sec)" << std::endl;
+
+  // Systems running side by side add up to more than the schedule row
+  double total = result.totalSeconds;
+  for (size_t i = 0; i < result.systemNames.size(); i++) {
+    printRow(toLower(result.systemNames[i]), result.systemSeconds[i], total,
+             steps);
+  }
+  printRow("schedule", result.scheduleSeconds, total, steps);
+  printRow("scene", result.sceneSeconds, total, steps);
+  printRow("path search", result.pathSearchSeconds, total, steps);
+  printRow("restart", result.restartSeconds, total, steps);
+
+  // Same inputs and step size give the same result, handy for spotting
+  // changes in simulation behaviour
+  std::cout << "    restarts " << result.restarts << ", final player "
+            << std::setprecision(2) << result.finalPlayerPosition.x << ", "
+            << result.finalPlayerPosition.y << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int steps = 10000;
+  std::vector<BenchCase> cases;
+  std::string tracePath;
+  bool batching = false;
+  bool submission = false;
+  bool text = false;
+  bool particles = false;
+  bool animation = false;
+  bool jobs = false;
+  int jobThreads = 0;
+  bool enemies = false;
+  bool stepsGiven = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+      steps = std::max(1, std::atoi(argv[++i]));
+      stepsGiven = true;
+    } else if (std::strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+      BenchCase benchCase;
+      benchCase.scenePath = argv[++i];
+      benchCase.label = benchCase.scenePath;
+      cases.push_back(benchCase);
+    } else if (std::strcmp(argv[i], "--template") == 0 && i + 1 < argc) {
+      BenchCase benchCase;
+      benchCase.label = std::string("template ") + argv[++i];
+      if (!findTemplate(argv[i], benchCase.templateType)) {
+        std::cerr << "Bench: unknown template '" << argv[i] << "'"
+                  << std::endl;
+        return 1;
+      }
+      cases.push_back(benchCase);
+    } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      tracePath = argv[++i];
+    } else if (std::strcmp(argv[i], "--batching") == 0) {
+      batching = true;
+    } else if (std::strcmp(argv[i], "--submission") == 0) {
+      submission = true;
+    } else if (std::strcmp(argv[i], "--text") == 0) {
+      text = true;
+    } else if (std::strcmp(argv[i], "--particles") == 0) {
+      particles = true;
+    } else if (std::strcmp(argv[i], "--animation") == 0) {
+      animation = true;
+    } else if (std::strcmp(argv[i], "--jobs") == 0) {
+      jobs = true;
+    } else if (std::strcmp(argv[i], "--job-threads") == 0 && i + 1 < argc) {
+      jobThreads = std::max(1, std::atoi(argv[++i]));
+    } else if (std::strcmp(argv[i], "--enemies") == 0) {
+      enemies = true;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--steps N] [--scene file.scene]... [--template name]..."
+                << " [--trace trace.json] [--batching] [--submission]"
+                << " [--text] [--particles] [--animation] [--jobs]"
+                << " [--job-threads N] [--enemies]"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  if (batching || submission || text || particles || animation || jobs ||
+      enemies) {
+    bool ok = true;
+    if (batching)
+      ok = RenderBench::runBatching(steps) && ok;
+    if (submission)
+      ok = RenderBench::runSubmission(stepsGiven ? steps : 100) && ok;
+    if (text)
+      ok = RenderBench::runText(stepsGiven ? steps : 1000) && ok;
+    if (particles)
+      ok = RenderBench::runParticles(stepsGiven ? steps : 300) && ok;
+    if (animation)
+      ok = RenderBench::runAnimation(stepsGiven ? steps : 1000) && ok;
+    if (jobs)
+      ok = JobBench::runScaling(stepsGiven ? steps : 20, jobThreads) && ok;
+    if (enemies)
+      ok = EnemyBench::runLod(stepsGiven ? steps : 600) && ok;
+    return ok ? 0 : 1;
+  }
+
+  if (cases.empty()) {
+    for (const auto &info : SceneTemplates::getAvailableTemplates()) {
+      BenchCase benchCase;
+      benchCase.label = "template " + info.name;
+      benchCase.templateType = info.type;
+      cases.push_back(benchCase);
+    }
+
+    std::error_code error;
+    std::vector<std::string> sceneFiles;
+    for (const auto &entry : std::filesystem::directory_iterator(
+             RESOURCES_PATH "scenes", error)) {
+      if (entry.path().extension() == ".scene")
+        sceneFiles.push_back(entry.path().string());
+    }
+    std::sort(sceneFiles.begin(), sceneFiles.end());
+    for (const auto &path : sceneFiles) {
+      BenchCase benchCase;
+      benchCase.scenePath = path;
+      benchCase.label = std::filesystem::path(path).filename().string();
+      cases.push_back(benchCase);
+    }
+  }
+
+  // No window, no GL context: textures and fonts stay null stubs
+  Graphics::setEnabled(false);
+
+  std::cout << "Bench: " << cases.size() << " case(s), " << steps
+            << " steps at "
+            << static_cast<int>(std::round(1.0 / FIXED_TIMESTEP)) << " Hz"
+            << std::endl;
+
+  PROFILE_THREAD("Main");
+  if (jobThreads > 1) {
+    JobSystem::get().initialize(jobThreads - 1);
+  }
+
+  // Scene loading is chatty; keep the report readable
+  std::streambuf *coutBuffer = std::cout.rdbuf();
+  int failures = 0;
+  for (const auto &benchCase : cases) {
+    BenchResult result;
+    std::cout.rdbuf(nullptr);
+    bool ok = runCase(benchCase, steps, result);
+    std::cout.rdbuf(coutBuffer);
+
+    if (ok) {
+      printResult(benchCase, result, steps);
+    } else {
+      failures++;
+    }
+  }
+
+  JobSystem::get().shutdown();
+
+  if (!tracePath.empty()) {
+#if CROWNFLAME_PROFILER
+    if (!Profiler::get().exportChromeTrace(tracePath))
+      failures++;
+#else
+    std::cerr << "Bench: --trace needs a build with CROWNFLAME_PROFILER"
+              << std::endl;
+#endif
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -5,6 +5,7 @@
 #include "GameWorld.h"
 #include "HotReloadManager.h"
 #include "InputManager.h"
+#include "RenderThread.h"
 #include "SceneManager.h"
 #include "Settings.h"
 #include "UIManager.h"
@@ -16,8 +17,20 @@ private:
   // Window and graphics
   GLFWwindow *window;
   gl2d::Renderer2D renderer;
+  gl2d::RenderStats lastRenderStats; // Counters of the previous frame
   int windowWidth, windowHeight;
 
+  // Pipelined rendering (setting renderThread, default on): the render
+  // thread owns the window's context and draws the snapshot of frame N while
+  // this thread simulates and records frame N+1. Uploads from this thread go
+  // through the hidden loader window, whose context shares objects with the
+  // window's. Without it, and for frames that need the window's context here
+  // (scene transitions), frames are drawn on this thread.
+  bool useRenderThread;
+  GLFWwindow *loaderWindow;
+  RenderThread renderThread;
+  RenderSnapshot snapshot; // Recorded each frame, then handed to renderThread
+
   // Game systems
   GameWorld gameWorld; // Keep for backward compatibility, but SceneManager will
                        // take over
@@ -33,6 +46,30 @@ private:
   // Game settings
   float playerSpeed;
 
+  // Time per frame allowed for applying queued hot reloads
+  static constexpr double HOT_RELOAD_BUDGET_MS = 4.0;
+
+  // Fixed-step simulation. Frames accumulate real time and the world is
+  // advanced in FIXED_TIMESTEP steps; rendering interpolates between the
+  // last two steps by the leftover fraction.
+  static constexpr double FIXED_TIMESTEP = 1.0 / 120.0;
+  static constexpr int MAX_CATCH_UP_STEPS = 8; // per frame
+  static constexpr double MAX_FRAME_TIME = 0.25; // clamp after long stalls
+  double accumulator;
+  float renderAlpha;
+
+  // Frame pacing (from settings): vsync, or a frame cap when it is off
+  bool vsyncEnabled;
+  int maxFps; // 0 = uncapped
+
+  // Hidden window, no rendering (simulation benchmarks)
+  bool headless;
+
+  // Frame time dump for automated perf runs (empty path = off). The window
+  // closes by itself after perfDumpFrames frames if that is set.
+  std::string perfDumpPath;
+  int perfDumpFrames;
+
   // Timing
   double lastTime;
   bool isRunning;
@@ -47,6 +84,23 @@ public:
   void run();
   void shutdown();
 
+  // Must be called before initialize(). The window stays hidden and
+  // runHeadless() drives the simulation without rendering.
+  void setHeadless(bool enabled) { headless = enabled; }
+  bool isHeadless() const { return headless; }
+
+  // Runs the given number of fixed simulation steps as fast as possible and
+  // prints the throughput in steps/sec
+  bool runHeadless(int steps);
+
+  // Must be called before run(). Writes every frame time to path (CSV, or
+  // JSON for .json) and quits after the given number of frames (0 = when the
+  // window is closed).
+  void setPerfDump(const std::string &path, int frames) {
+    perfDumpPath = path;
+    perfDumpFrames = frames;
+  }
+
   // Scene management
   bool loadScene(const std::string &sceneName, const std::string &filePath);
   bool loadSceneFromDefinition(const std::string &sceneName,
@@ -69,11 +123,17 @@ private:
   bool initializeWindow(int width, int height, const char *title);
   bool initializeOpenGL();
   bool initializeGame();
+  void startRenderThread();
 
   // Main loop
-  void update(float deltaTime);
-  void render();
+  void update(float frameTime);
+  void simulateStep(float deltaTime, const glm::vec2 &movement);
+  void recordFrame(gl2d::Renderer2D &target);
+  void render();               // Draws the frame on this thread
+  void renderSynchronously();  // render() and swap, render thread paused
+  void renderThreaded();       // Records a snapshot for the render thread
   void handleEvents();
+  void applyFramePacing(double frameStart);
 
   // Event callbacks
   static void errorCallback(int error, const char *description);
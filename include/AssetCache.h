@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <gl2d/gl2d.h>
+#include <string>
+#include <vector>
+
+// On-disk derived data cache for textures.
+//
+// Decoded (and mip-chained) pixel data is stored in blobs keyed by a hash of
+// the source file contents combined with the import settings. Editing the
+// source file changes its hash, so a stale blob can never be picked up; it is
+// simply replaced on the next miss.
+class AssetCache {
+public:
+  // Bump this whenever the blob layout or the mip generation changes so
+  // existing blobs get rebuilt.
+  static constexpr uint32_t CACHE_VERSION = 1;
+
+  struct TextureBlob {
+    int width = 0;
+    int height = 0;
+    uint32_t glFormat = 0; // 0 = raw RGBA8, otherwise a compressed format
+    std::vector<std::vector<unsigned char>> levels;
+  };
+
+  AssetCache();
+
+  bool initialize(const std::string &cacheDirectory);
+  bool isInitialized() const { return m_initialized; }
+  const std::string &getCacheDirectory() const { return m_cacheDirectory; }
+
+  // Creates outTexture from the cached blob if there is one, otherwise decodes
+  // the source, uploads it and writes a new blob. cacheHit reports which path
+  // was taken.
+  bool loadTexture(const std::string &filepath, bool pixelated,
+                   bool useMipMaps, gl2d::Texture &outTexture,
+                   bool &cacheHit);
+
+  // Store S3TC (DXT5) compressed levels instead of raw RGBA when the driver
+  // supports it. Off by default since it is lossy and pixel art suffers.
+  void setCompressionEnabled(bool enabled) { m_compressionEnabled = enabled; }
+  bool isCompressionEnabled() const { return m_compressionEnabled; }
+
+  // Removes every blob from the cache directory
+  void clear();
+
+  // Statistics
+  size_t getHitCount() const { return m_hits; }
+  size_t getMissCount() const { return m_misses; }
+
+  // Bytes of texture data (all levels) sent to the GPU by the last successful
+  // loadTexture call
+  size_t getLastUploadSize() const { return m_lastUploadSize; }
+
+  // Size of a full RGBA8 mip chain, or of level 0 only without mips
+  static size_t computeTextureBytes(int width, int height, bool withMipMaps);
+
+  // 64-bit FNV-1a
+  static uint64_t hashBytes(const void *data, size_t size,
+                            uint64_t seed = 14695981039346656037ull);
+
+private:
+  bool m_initialized;
+  bool m_compressionEnabled;
+  std::string m_cacheDirectory;
+  size_t m_hits;
+  size_t m_misses;
+  size_t m_lastUploadSize;
+
+  uint64_t computeKey(const std::vector<unsigned char> &sourceData,
+                      bool pixelated, bool useMipMaps) const;
+  std::string getSourcePrefix(const std::string &filepath) const;
+  std::string getBlobPath(const std::string &filepath, uint64_t key) const;
+
+  bool readBlob(const std::string &blobPath, uint64_t key, bool useMipMaps,
+                TextureBlob &blob) const;
+  bool writeBlob(const std::string &blobPath, uint64_t key,
+                 const TextureBlob &blob) const;
+  void removeStaleBlobs(const std::string &filepath,
+                        const std::string &keepPath) const;
+
+  bool decodeSource(const std::vector<unsigned char> &sourceData,
+                    bool useMipMaps, TextureBlob &blob) const;
+  bool compressBlob(TextureBlob &blob) const;
+  void createTexture(const TextureBlob &blob, bool pixelated, bool useMipMaps,
+                     gl2d::Texture &outTexture) const;
+
+  static void buildMipChain(TextureBlob &blob);
+  // Levels of a full mip chain down to 1x1
+  static uint32_t getMipLevelCount(int width, int height);
+  // Bytes of one level of a blob in glFormat (0 or DXT5)
+  static size_t getLevelSize(uint32_t glFormat, int width, int height);
+  static size_t getBlobSize(const TextureBlob &blob);
+  static bool readFileBytes(const std::string &filepath,
+                            std::vector<unsigned char> &data);
+};
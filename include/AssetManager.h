@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AssetCache.h"
 #include <functional>
 #include <gl2d/gl2d.h>
 #include <memory>
@@ -19,13 +20,21 @@ public:
   // Asset type enumeration for categorization
   enum class AssetType { TEXTURE, AUDIO, SCENE, FONT };
 
+  // Whether a load was served from the derived data cache
+  enum class CacheStatus { NOT_CACHED, HIT, MISS };
+
   // Asset info structure
   struct AssetInfo {
     std::string name;
     std::string filepath;
     AssetType type;
-    size_t size = 0;
+    size_t size = 0;     // Size of the source file on disk
+    size_t cpuBytes = 0; // Decoded data kept in system memory
+    size_t gpuBytes = 0; // Texture memory, including all mip levels
     bool isLoaded = false;
+    CacheStatus cacheStatus = CacheStatus::NOT_CACHED;
+    uint64_t lastUsed = 0; // Access stamp for least-recently-used eviction
+    int pinCount = 0;      // Holders of a pointer to it, see pinAsset
   };
 
   AssetManager();
@@ -60,6 +69,11 @@ public:
   gl2d::Font *getFont(const std::string &name);
   bool isFontLoaded(const std::string &name) const;
 
+  // Loads the first font found into DEFAULT_FONT: resources/fonts/default.ttf,
+  // then Arial (Windows, macOS), then DejaVu Sans (Linux)
+  static constexpr const char *DEFAULT_FONT = "default";
+  bool loadDefaultFont();
+
   // Batch operations
   bool loadAssetsFromDirectory(const std::string &directory, AssetType type,
                                bool recursive = false);
@@ -73,10 +87,18 @@ public:
                                          bool recursive = false);
   void autoDiscoverAssets(); // Scans resources/ folder automatically
 
+  // Derived data cache (decoded textures)
+  AssetCache &getTextureCache() { return m_textureCache; }
+  size_t getCacheHitCount() const { return m_textureCache.getHitCount(); }
+  size_t getCacheMissCount() const { return m_textureCache.getMissCount(); }
+
   // Asset information and statistics
   std::vector<AssetInfo> getLoadedAssets() const;
   std::vector<AssetInfo> getAssetsByType(AssetType type) const;
-  size_t getTotalMemoryUsage() const;
+  size_t getTotalMemoryUsage() const; // CPU + GPU bytes of loaded assets
+  size_t getCpuMemoryUsage() const;
+  size_t getGpuMemoryUsage() const;
+  size_t getMemoryUsageByType(AssetType type) const;
   size_t getAssetCount() const;
   size_t getAssetCountByType(AssetType type) const;
 
@@ -90,6 +112,31 @@ public:
                                                AssetType type, bool success)>;
   void setAssetLoadCallback(AssetLoadCallback callback);
 
+  // Memory budgets (CPU + GPU bytes per asset type, 0 = unlimited). When a
+  // load pushes a type over its budget the eviction callback is invoked with
+  // the asset just loaded; it can free memory itself or call
+  // evictLeastRecentlyUsed, which must be told to keep that asset since the
+  // caller of the load is about to use it.
+  using BudgetExceededCallback =
+      std::function<void(AssetType type, const std::string &loadedAsset,
+                         size_t usedBytes, size_t budgetBytes)>;
+  void setMemoryBudget(AssetType type, size_t bytes);
+  size_t getMemoryBudget(AssetType type) const;
+  void setBudgetExceededCallback(BudgetExceededCallback callback);
+  // Unloads the least recently used assets of a type until its usage is at or
+  // below targetBytes. Pinned assets are skipped. Evicted assets stay
+  // registered (not loaded), so they can be loaded again by name. Returns
+  // the number of bytes freed.
+  size_t evictLeastRecentlyUsed(AssetType type, size_t targetBytes,
+                                const std::string &keepAsset = "");
+
+  // Anyone keeping a pointer from getTexture/getFont beyond the current
+  // frame pins the asset so eviction leaves it alone, and unpins it when
+  // done. Pins are counted; explicit unload* calls ignore them.
+  void pinAsset(const std::string &name);
+  void unpinAsset(const std::string &name);
+  bool isAssetPinned(const std::string &name) const;
+
   // Hot reload support
   bool reloadAsset(const std::string &name);
   void enableHotReload(bool enable);
@@ -115,6 +162,14 @@ private:
   // Asset metadata
   std::unordered_map<std::string, AssetInfo> m_assetRegistry;
 
+  // Memory budgets
+  std::unordered_map<AssetType, size_t> m_memoryBudgets;
+  BudgetExceededCallback m_budgetCallback;
+  uint64_t m_accessCounter;
+
+  // Derived data cache for textures
+  AssetCache m_textureCache;
+
   // Manager state
   bool m_initialized;
   AssetLoadCallback m_loadCallback;
@@ -131,8 +186,14 @@ private:
   size_t getFileSize(const std::string &filepath) const;
 
   void registerAsset(const std::string &name, const std::string &filepath,
-                     AssetType type);
+                     AssetType type, bool loaded = true);
   void unregisterAsset(const std::string &name);
+  // Frees the loaded data but keeps the registry entry
+  void evictAsset(const std::string &name);
+  void setAssetMemory(const std::string &name, size_t cpuBytes,
+                      size_t gpuBytes);
+  void touchAsset(const std::string &name);
+  void enforceMemoryBudget(AssetType type, const std::string &loadedAsset);
 
   // Directory scanning helpers
   void scanDirectoryRecursive(const std::string &directory, AssetType type,
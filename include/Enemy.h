@@ -23,6 +23,20 @@ private:
   float movementRange;
   bool movingToB; // For patrol pattern
 
+  // Area the bounds have to stay in (the world), patrol points outside it
+  // are walked to its edge
+  Rectangle movementLimits;
+  bool hasMovementLimits;
+
+  // Patrol leg being walked: the position is worked out from the distance
+  // left rather than by adding up steps, so rounding doesn't build up and
+  // one long step lands where many short ones do (legRemaining < 0: none)
+  glm::vec2 legStart, legTarget;
+  float legRemaining;
+
+  glm::vec2 getPatrolTarget(const glm::vec2 &point) const;
+  glm::vec2 getLegPosition() const;
+
 public:
   Enemy(float x, float y,
         MovementPattern pattern = MovementPattern::HORIZONTAL);
@@ -33,9 +47,18 @@ public:
   void setCircularMovement(glm::vec2 center, float radius);
   void setPatrolMovement(glm::vec2 pointA, glm::vec2 pointB);
 
-  // Update enemy position based on movement pattern
+  void setMovementLimits(const Rectangle &limits);
+
+  // Update enemy position based on movement pattern. Any deltaTime works:
+  // the oscillating and circular patterns are functions of time, and patrol
+  // turns exactly at its points and walks the rest of a step back, so one
+  // long step ends where many short ones do.
   void update(float deltaTime);
 
+  // Box covering every position the pattern can take from here on (the
+  // current bounds included)
+  Rectangle getMovementBounds() const;
+
   // Getters
   MovementPattern getMovementPattern() const { return movementPattern; }
   float getMovementSpeed() const { return movementSpeed; }
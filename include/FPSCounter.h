@@ -1,16 +1,88 @@
 #pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
 
+// Frame timing. Keeps the averaged FPS for display plus the last
+// HISTORY_SIZE frame times, from which percentiles and hitches are derived
+// (an average hides the occasional long frame that players notice).
 class FPSCounter {
+public:
+  static constexpr size_t HISTORY_SIZE = 512;
+
+  struct FrameStats {
+    float averageMs = 0.0f;
+    float p50Ms = 0.0f;
+    float p95Ms = 0.0f;
+    float p99Ms = 0.0f;
+    float maxMs = 0.0f;
+    size_t samples = 0;
+  };
+
 private:
   float fps;
   float fpsUpdateTimer;
   float fpsUpdateInterval;
   int frameCount;
 
+  // Frame times in milliseconds, ring buffer
+  float frameTimes[HISTORY_SIZE];
+  size_t nextFrame;
+  size_t storedFrames;
+
+  // Refreshed together with the FPS value so sorting happens twice a second
+  // rather than every frame
+  FrameStats stats;
+  std::vector<float> sortScratch;
+
+  // Frames longer than the threshold count as hitches
+  float hitchThresholdMs;
+  size_t hitchCount;
+  float lastHitchMs;
+
+  // Dump mode: every frame between startDump and stopDump
+  bool dumping;
+  std::string dumpPath;
+  std::vector<float> dumpFrames;
+
 public:
   FPSCounter(float updateInterval = 0.5f);
 
   void update(float deltaTime);
   float getFPS() const { return fps; }
   void reset();
-};
\ No newline at end of file
+
+  // Statistics over the frames in the history
+  const FrameStats &getStats() const { return stats; }
+  float getOnePercentLowFPS() const {
+    return stats.p99Ms > 0.0f ? 1000.0f / stats.p99Ms : 0.0f;
+  }
+
+  // Hitch detection
+  void setHitchThreshold(float milliseconds) {
+    hitchThresholdMs = milliseconds;
+  }
+  float getHitchThreshold() const { return hitchThresholdMs; }
+  size_t getHitchCount() const { return hitchCount; }
+  float getLastHitchMs() const { return lastHitchMs; }
+
+  // Frame time history laid out for ImGui::PlotLines(values, count, offset)
+  const float *getFrameTimes() const { return frameTimes; }
+  size_t getFrameTimeCount() const { return storedFrames; }
+  size_t getFrameTimeOffset() const {
+    return storedFrames == HISTORY_SIZE ? nextFrame : 0;
+  }
+
+  // Records every frame until stopDump(), which writes them with summary
+  // statistics for automated performance runs. The format follows the
+  // extension: JSON for ".json", CSV otherwise.
+  void startDump(const std::string &path);
+  bool stopDump();
+  bool isDumping() const { return dumping; }
+  size_t getDumpedFrameCount() const { return dumpFrames.size(); }
+  const std::string &getDumpPath() const { return dumpPath; }
+
+private:
+  static FrameStats computeStats(const float *values, size_t count,
+                                 std::vector<float> &scratch);
+};
@@ -29,14 +29,50 @@ struct WatchedFile {
 };
 
 class FileWatcher {
+public:
+  // How changes are detected. INOTIFY watches the parent directories of the
+  // watched files (Linux only); POLLING stats every file periodically and is
+  // used everywhere else or when inotify is unavailable.
+  enum class Backend { POLLING, INOTIFY };
+
 private:
   std::unordered_map<std::string, WatchedFile> watchedFiles;
   std::thread watcherThread;
   std::atomic<bool> isRunning;
   mutable std::mutex filesMutex;
 
-  // Polling interval in milliseconds
-  static const int POLL_INTERVAL_MS = 500;
+  // Polling interval in milliseconds (polling backend only)
+  static constexpr int POLL_INTERVAL_MS = 500;
+  std::atomic<int> pollIntervalMs;
+
+  // A change is dispatched once the file has been quiet for this long, so
+  // editors writing in several steps trigger a single reload
+  static constexpr int DEBOUNCE_MS = 100;
+
+  // Changes waiting for their debounce deadline (guarded by filesMutex)
+  std::unordered_map<std::string, std::chrono::steady_clock::time_point>
+      pendingChanges;
+
+  Backend backend;
+
+#ifdef __linux__
+  struct DirectoryWatch {
+    std::string directory;
+    // file name inside the directory -> watched path
+    std::unordered_map<std::string, std::string> files;
+  };
+
+  int inotifyFd;
+  int wakeupPipe[2]; // Written to on shutdown to interrupt poll()
+  std::unordered_map<int, DirectoryWatch> directoryWatches; // by descriptor
+  std::unordered_map<std::string, int> directoryDescriptors;
+
+  // Directories whose watch was dropped because they were deleted or moved
+  // away, keyed by path. Their files stay watched and the directory is
+  // watched again once it exists (guarded by filesMutex).
+  static constexpr int LOST_DIRECTORY_RETRY_MS = 1000;
+  std::unordered_map<std::string, DirectoryWatch> lostDirectories;
+#endif
 
   // Reference to application for callbacks
   Application *application;
@@ -62,6 +98,12 @@ public:
   void setEnabled(bool enabled);
   bool isEnabled() const { return isRunning.load(); }
 
+  // Backend information
+  Backend getBackend() const { return backend; }
+  const char *getBackendName() const;
+  void setPollInterval(int milliseconds);
+  int getPollInterval() const { return pollIntervalMs.load(); }
+
   // Statistics
   size_t getWatchedFileCount() const;
   std::vector<std::string> getWatchedFiles() const;
@@ -69,6 +111,19 @@ public:
 private:
   // Worker thread function
   void watcherLoop();
+  void startThread();
+  void stopThread();
+
+  // Backends
+  void pollFiles();
+#ifdef __linux__
+  bool initializeInotify();
+  void shutdownInotify();
+  void addDirectoryWatch(const std::string &path);
+  void removeDirectoryWatch(const std::string &path);
+  void readInotifyEvents();
+  void retryLostDirectories();
+#endif
 
   // File utilities
   bool fileExists(const std::string &path) const;
@@ -77,6 +132,10 @@ private:
   FileType detectFileType(const std::string &path) const;
 
   // Processing
+  void queueChange(const std::string &path);
+  int getMillisecondsUntilNextDispatch() const;
+  void dispatchReadyChanges();
   void processFileChange(const std::string &path,
-                         const WatchedFile &watchedFile);
-};
\ No newline at end of file
+                         const std::function<void(const std::string &)>
+                             &reloadCallback);
+};
@@ -18,6 +18,14 @@ public:
   ObjectType type;
   bool isStatic;
 
+  // Position at the start of the last simulation step, rendering blends
+  // from here to bounds
+  glm::vec2 previousPosition;
+
+  // Index of the scene definition entry this object was created from, used
+  // to match live objects when a scene is hot reloaded (-1 if none)
+  int sourceIndex;
+
   GameObject(float x, float y, float width, float height, glm::vec4 color,
              ObjectType type, bool isStatic = false);
 
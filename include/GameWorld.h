@@ -3,12 +3,16 @@
 #include "GameObject.h"
 #include "GameState.h"
 #include "Pathfinder.h"
+#include "SpatialGrid.h"
+#include "SpriteAnimation.h"
+#include "SystemScheduler.h"
 #include "TileMapManager.h"
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
 
 // Forward declaration
+class AssetManager;
 class AudioManager;
 
 class GameWorld {
@@ -20,6 +24,7 @@ private:
 
   // Camera system
   glm::vec2 cameraPosition;
+  glm::vec2 previousCameraPosition;
   float cameraFollowSpeed;
   bool cameraFollowEnabled;
 
@@ -29,11 +34,29 @@ private:
   // Game state
   GameStateManager gameStateManager;
 
-  // Texture for pig enemies (will be loaded in implementation)
+  // Sprite sheet for pig enemies (will be loaded in implementation). Owned
+  // by the asset manager when there is one, by the world otherwise.
   void *pigTexture; // Using void* to avoid gl2d dependency in header
+  bool ownsPigTexture;
+  static constexpr const char *PIG_TEXTURE = "pig_walk";
 
-  // Font for game over banner
-  void *gameFont; // Using void* to avoid gl2d dependency in header
+  // Clips shared by all enemies; enemyAnimations is parallel to enemies
+  AnimationLibrary animations;
+  std::vector<AnimationState> enemyAnimations;
+  uint16_t pigWalkClip;
+
+  // Game over banner text, laid out once per font (defined in GameWorld.cpp)
+  struct BannerText;
+  std::unique_ptr<BannerText> bannerText;
+
+  // Pickup and enemy bursts (defined in GameWorld.cpp). Only created when
+  // there is a GL context; without one nothing is emitted.
+  struct ParticleEffects;
+  std::unique_ptr<ParticleEffects> particles;
+
+  // Fonts and textures are loaded and owned by the asset manager. Set it
+  // before initialize so the pig and tile textures go through it.
+  AssetManager *assetManager;
 
   // Audio system
   AudioManager *audioManager;
@@ -41,11 +64,72 @@ private:
   // Tile system
   TileMapManager tileMapManager;
 
+  // Visibility: static objects and enemies are bucketed in coarse grids so
+  // render() only submits what overlaps the camera view plus a margin.
+  // Enemies are bucketed by their whole movement range, so the grid only
+  // changes when enemies are added or removed.
+  SpatialGrid objectGrid; // Static objects, rebuilt when objects change
+  SpatialGrid enemyGrid;  // Movement ranges, rebuilt when enemies change
+  bool objectGridDirty;
+  bool enemyGridDirty;
+  std::vector<uint32_t> movingObjects;  // Not in objectGrid, tested directly
+  std::vector<uint32_t> visibleObjects; // Indices into gameObjects
+  std::vector<uint32_t> visibleEnemies; // Indices into enemies
+  std::vector<uint32_t> gridCandidates;
+  static constexpr float VISIBILITY_MARGIN = 64.0f;
+
+  // Enemy level of detail. By how far their movement range is from the
+  // view (and the player), enemies are updated every step (near), every
+  // MID_ENEMY_INTERVAL steps with the time since (mid), or not at all until
+  // they get closer, when they catch up in one update (far). With it off
+  // every enemy is near.
+  bool enemyLodEnabled;
+  double enemyClock; // Simulation time the enemies are at
+  uint32_t enemyStep;
+  std::vector<double> enemySyncTimes; // Parallel to enemies: last update
+  std::vector<Rectangle> enemyRanges; // Movement ranges in enemyGrid
+  std::vector<uint32_t> nearEnemies;  // Updated in the last step
+  std::vector<uint32_t> enemyCandidates;
+  std::vector<uint32_t> contactCandidates;
+  size_t midEnemyUpdates; // In the last step
+  static constexpr float NEAR_ENEMY_MARGIN = 256.0f;
+  static constexpr float MID_ENEMY_MARGIN = 1024.0f;
+  static constexpr uint32_t MID_ENEMY_INTERVAL = 4;
+
+  // Fraction of a simulation step between the previous and current state
+  // that rendering should show
+  float renderAlpha;
+
+  // Longest distance the player moves before collisions are checked again,
+  // keeps fast movement from skipping over thin obstacles
+  static constexpr float MAX_MOVE_STEP = 4.0f;
+
   // Pathfinding system
   std::vector<glm::vec2> currentPath;
   int currentPathIndex;
   bool followingPath;
 
+  // Entity state right after the scene populated the world. Objects are
+  // stored by value so a restart is a plain copy back into the existing
+  // allocations.
+  struct InitialState {
+    std::vector<GameObject> objects;
+    std::vector<Enemy> enemies;
+    int playerIndex = -1; // into objects
+    glm::vec2 cameraPosition = glm::vec2(0.0f);
+    float cameraFollowSpeed = 5.0f;
+    bool cameraFollowEnabled = true;
+    bool valid = false;
+  };
+  InitialState initialState;
+
+  // Player input of the next update()
+  glm::vec2 playerMovement;
+  float playerSpeed;
+
+  // Systems of update(), see addUpdateSystems() for what each one touches
+  SystemScheduler systems;
+
 public:
   GameWorld();
   ~GameWorld();
@@ -65,13 +149,55 @@ public:
 
   // Enemy management
   Enemy *createEnemy(float x, float y, MovementPattern pattern);
+
+  // Remove a single object/enemy (used when a scene is patched in place)
+  void removeObject(GameObject *object);
+  void removeEnemy(Enemy *enemy);
   void updateEnemies(float deltaTime);
   void checkPlayerEnemyCollisions();
 
-  // Update game logic
+  // Enemy level of detail, on by default. Far enemies' bounds lag behind
+  // until they come closer; syncAllEnemies() brings every enemy up to date
+  // for callers that need all of them.
+  void setEnemyLodEnabled(bool enable);
+  bool isEnemyLodEnabled() const { return enemyLodEnabled; }
+  void syncAllEnemies();
+  // Enemies updated in the last step: the near ones and the mid-range ones
+  // whose turn it was
+  size_t getNearEnemyCount() const { return nearEnemies.size(); }
+  size_t getMidEnemyUpdateCount() const { return midEnemyUpdates; }
+
+  // Restart support. restoreInitialState resets entities, camera and game
+  // state without touching textures, fonts or the tilemap; it returns false
+  // if there is no valid snapshot.
+  void captureInitialState();
+  bool restoreInitialState();
+  void invalidateInitialState() { initialState.valid = false; }
+  bool hasInitialState() const { return initialState.valid; }
+
+  // Remove all entities and reset game state (resources are kept)
+  void clearEntities();
+
+  // Update game logic. update() runs one simulation step through the
+  // system scheduler, starting with recording the previous state used for
+  // render interpolation.
   void update(float deltaTime);
+  void storePreviousState();
+  void setRenderAlpha(float alpha) { renderAlpha = alpha; }
+  float getRenderAlpha() const { return renderAlpha; }
   void updatePlayer(float moveX, float moveY, float speed, float deltaTime);
 
+  // Keyboard movement (cancels a path being followed) and the speed for
+  // keyboard and path movement, used by the following update() calls
+  void setPlayerInput(const glm::vec2 &movement, float speed) {
+    playerMovement = movement;
+    playerSpeed = speed;
+  }
+
+  // The systems of update() with the schedule and timings of the last step
+  SystemScheduler &getSystemScheduler() { return systems; }
+  const SystemScheduler &getSystemScheduler() const { return systems; }
+
   // Pathfinding
   void handleMouseInput(const glm::vec2 &mouseScreenPos);
   void updatePathfinding(float deltaTime, float playerSpeed);
@@ -85,6 +211,21 @@ public:
 
   // Rendering
   void render(void *renderer);
+
+  // Collects the entities overlapping the camera view plus a margin, as
+  // ascending indices into getObjects()/getEnemies(). render() calls it, so
+  // the sets describe the last rendered frame until entities are added or
+  // removed.
+  void updateVisibility();
+  const std::vector<uint32_t> &getVisibleObjects() const {
+    return visibleObjects;
+  }
+  const std::vector<uint32_t> &getVisibleEnemies() const {
+    return visibleEnemies;
+  }
+
+  // Call after moving static objects in place (scene hot reload)
+  void invalidateObjectGrid() { objectGridDirty = true; }
   void renderGameOverBanner(void *renderer);
   void renderPath(void *renderer);
 
@@ -101,17 +242,38 @@ public:
   // Screen management
   void updateScreenSize(int width, int height);
 
+  // Resizes the area the player and enemies are kept in. The tile map keeps
+  // its size (the benchmark uses it for worlds larger than any map).
+  void setWorldSize(float width, float height);
+
   // Camera management
   void updateCamera(float deltaTime);
   glm::vec2 getCameraPosition() const { return cameraPosition; }
+  glm::vec2 getRenderCameraPosition() const;
   void setCameraFollowSpeed(float speed) { cameraFollowSpeed = speed; }
   void enableCameraFollow(bool enable) { cameraFollowEnabled = enable; }
 
   // Audio management
   void setAudioManager(AudioManager *manager) { audioManager = manager; }
 
+  // Asset management
+  void setAssetManager(AssetManager *manager) { assetManager = manager; }
+
   // Tile map management
   TileMapManager &getTileMapManager() { return tileMapManager; }
   bool initializeTileSystem();
   void verifyMapPreloaded() const; // Verify entire map is preloaded
+
+private:
+  void addUpdateSystems();
+  void loadRenderResources();
+  void rebuildObjectGrid();
+  void rebuildEnemyGrid();
+  void syncEnemy(size_t index, float deltaTime);
+  void resetEnemyClock();
+  Rectangle getVisibilityRect() const;
+  AnimationState initialEnemyAnimation(size_t index) const;
+  enum class Burst { PICKUP, ENEMY_HIT };
+  void emitBurst(Burst burst, const Rectangle &area);
+  Rectangle getRenderBounds(const GameObject &object) const;
 };
\ No newline at end of file
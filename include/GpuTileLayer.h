@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+class TileMap;
+
+/**
+ * GPU side of a TileMap drawn in a single pass. The tile ids are kept in an
+ * integer texture (one texel per tile) and the tile images in a texture
+ * array; one quad covers the map and the fragment shader looks up the tile
+ * and its image for every pixel, so the cost depends on the pixels covered
+ * rather than on the size of the map.
+ */
+class GpuTileLayer {
+public:
+  GpuTileLayer();
+  ~GpuTileLayer();
+
+  GpuTileLayer(const GpuTileLayer &) = delete;
+  GpuTileLayer &operator=(const GpuTileLayer &) = delete;
+
+  // Uploads the images of the map's tileset and all its tile ids. Fails if
+  // the shader can't be loaded or the tile images differ in size.
+  bool create(const TileMap &map);
+  void destroy();
+  bool isCreated() const { return indexTexture != 0; }
+
+  // Changed tiles are uploaded by the next render() as one sub-region
+  void markDirty(int x, int y, int width = 1, int height = 1);
+
+  // Queues the map into a gl2d::Renderer2D at its current layer
+  void render(void *renderer, const TileMap &map);
+
+  // Shader shared by all layers, compiled from resources/shaders on first
+  // use. On failure the previous program is kept.
+  static bool reloadShader();
+  static std::string getVertexShaderPath();
+  static std::string getFragmentShaderPath();
+
+private:
+  void uploadDirtyRegion(const TileMap &map);
+
+  unsigned int indexTexture;
+  unsigned int imageArray;
+  unsigned int infoTexture;
+  int mapWidth;
+  int mapHeight;
+
+  // Tile id -> slot + 1 in the image array (0: not drawn)
+  std::unordered_map<int, uint16_t> slotsById;
+
+  bool dirty;
+  int dirtyMinX, dirtyMinY, dirtyMaxX, dirtyMaxY; // Inclusive
+};
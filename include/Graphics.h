@@ -0,0 +1,10 @@
+#pragma once
+
+// Whether GPU resources may be created. Tools that run the simulation
+// without a window or GL context (mygame_bench) switch this off before
+// creating any scene; textures and fonts are then left as null stubs and
+// worlds are updated but never rendered.
+namespace Graphics {
+bool isEnabled();
+void setEnabled(bool enabled);
+} // namespace Graphics
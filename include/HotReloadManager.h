@@ -1,7 +1,10 @@
 #pragma once
 #include "FileWatcher.h"
+#include "MPSCQueue.h"
+#include <functional>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 
 // Forward declarations
@@ -10,6 +13,13 @@ class SceneManager;
 class AudioManager;
 
 class HotReloadManager {
+public:
+  // A file change reported by the watcher thread
+  struct ReloadEvent {
+    FileType type = FileType::UNKNOWN;
+    std::string path;
+  };
+
 private:
   FileWatcher fileWatcher;
   Application *application;
@@ -23,9 +33,21 @@ private:
       sceneRegistry; // scene_name -> file_path
   std::unordered_map<std::string, std::string>
       audioRegistry; // sound_id -> file_path
+  std::unordered_map<std::string, std::string>
+      shaderRegistry; // shader_id -> file_path
 
   bool isEnabled;
 
+  // Watcher thread -> main thread handoff. Events are drained into
+  // deferredReloads (one entry per file) and applied under a frame budget.
+  MPSCQueue<ReloadEvent> reloadQueue;
+  std::vector<ReloadEvent> deferredReloads;
+  std::unordered_set<std::string> deferredPaths;
+  size_t coalescedReloadCount;
+
+  // Called before a batch of reloads is applied
+  std::function<void()> onBeforeReload;
+
 public:
   HotReloadManager();
   ~HotReloadManager();
@@ -39,6 +61,8 @@ public:
   void registerTexture(const std::string &assetId, const std::string &filePath);
   void registerScene(const std::string &sceneName, const std::string &filePath);
   void registerAudio(const std::string &soundId, const std::string &filePath);
+  void registerShader(const std::string &shaderId,
+                      const std::string &filePath);
 
   // Asset unregistration
   void unregisterTexture(const std::string &assetId);
@@ -49,13 +73,31 @@ public:
   void reloadTexture(const std::string &filePath);
   void reloadScene(const std::string &filePath);
   void reloadAudio(const std::string &filePath);
+  void reloadShader(const std::string &filePath);
   void reloadAllAssets();
 
+  // Applies queued reloads on the calling (main) thread. Call once per frame
+  // at a point where no scene is being updated or rendered. At least one
+  // reload runs per call; the rest wait for the next frame once budgetMs is
+  // used up. Returns the number of reloads applied.
+  size_t processPendingReloads(double budgetMs);
+  size_t getPendingReloadCount() const { return deferredReloads.size(); }
+  size_t getCoalescedReloadCount() const { return coalescedReloadCount; }
+
+  // Reloads replace GL resources that frames still being drawn may use;
+  // callback gets a chance to wait for them first
+  void setOnBeforeReloadCallback(std::function<void()> callback) {
+    onBeforeReload = std::move(callback);
+  }
+
   // Control
   void enable();
   void disable();
   bool getEnabled() const { return isEnabled; }
-  void setWatchInterval(int milliseconds);
+  void setWatchInterval(int milliseconds); // Polling backend only
+  const char *getWatcherBackendName() const {
+    return fileWatcher.getBackendName();
+  }
 
   // Statistics and debugging
   size_t getWatchedFileCount() const;
@@ -67,10 +109,15 @@ public:
   void unwatchDirectory(const std::string &directory);
 
 private:
-  // Callback functions for FileWatcher
+  // Called from the watcher thread, only enqueues
+  void queueReload(FileType type, const std::string &filePath);
+  void applyReload(const ReloadEvent &event);
+
+  // Main-thread handlers for a dequeued change
   void onTextureChanged(const std::string &filePath);
   void onSceneChanged(const std::string &filePath);
   void onAudioChanged(const std::string &filePath);
+  void onShaderChanged(const std::string &filePath);
 
   // Helper functions
   std::string getAssetIdFromPath(
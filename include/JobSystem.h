@@ -0,0 +1,128 @@
+#pragma once
+#include "MPSCQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobCounter;
+
+// A unit of work and the counter it signals when done
+struct Job {
+  std::function<void()> function;
+  JobCounter *counter = nullptr;
+  bool mainThread = false; // Only runs on the main thread
+};
+
+// Number of unfinished jobs scheduled with it. Jobs scheduled "after" a
+// counter are held until it reaches zero, which is how dependencies are
+// expressed. A counter must outlive its jobs (wait() on it before it goes
+// away) and may be reused once it is back at zero.
+class JobCounter {
+public:
+  JobCounter() : value(0) {}
+  JobCounter(const JobCounter &) = delete;
+  JobCounter &operator=(const JobCounter &) = delete;
+
+  bool isDone() const { return value.load(std::memory_order_acquire) == 0; }
+  int getValue() const { return value.load(std::memory_order_acquire); }
+
+private:
+  friend class JobSystem;
+  std::atomic<int> value;
+  std::mutex dependentsMutex;
+  std::vector<Job> dependents; // Waiting for value to reach zero
+};
+
+// Work-stealing job scheduler. Every worker thread has its own deque: it
+// pushes and pops its own jobs at the back (newest first, still hot in
+// cache) and, when that runs dry, steals the oldest job from the front of
+// another's. Jobs scheduled from other threads go to a shared deque that
+// everyone steals from. A thread waiting on a counter runs jobs instead of
+// blocking, so with no workers at all everything still runs, on the waiting
+// thread.
+//
+// GL calls (and anything else tied to the main thread) go through
+// scheduleOnMainThread; those jobs run in runMainThreadJobs() or while the
+// main thread waits.
+class JobSystem {
+public:
+  static JobSystem &get();
+
+  // Starts workerCount threads (-1 = one less than the hardware threads, so
+  // the main thread has a core of its own). The calling thread becomes the
+  // main thread.
+  bool initialize(int workerCount = -1);
+  // Runs what is still queued, then stops the workers
+  void shutdown();
+  bool isInitialized() const { return initialized; }
+  size_t getWorkerCount() const { return queues.size() - 1; }
+  bool isMainThread() const;
+
+  // Queues job. counter (if any) is incremented now and decremented when the
+  // job has run; with after the job only becomes runnable once after is at
+  // zero.
+  void schedule(std::function<void()> function, JobCounter *counter = nullptr,
+                JobCounter *after = nullptr);
+  void scheduleOnMainThread(std::function<void()> function,
+                            JobCounter *counter = nullptr,
+                            JobCounter *after = nullptr);
+
+  // Runs queued jobs until counter reaches zero
+  void wait(JobCounter &counter);
+
+  // Calls function(begin, end) over [0, count) in batches of batchSize or
+  // more, in parallel, and returns when all batches are done. The calling
+  // thread runs batches too.
+  void parallelFor(size_t count, size_t batchSize,
+                   const std::function<void(size_t, size_t)> &function);
+
+  // Runs the jobs queued for the main thread (main thread only). Returns how
+  // many ran.
+  size_t runMainThreadJobs();
+
+  // Jobs run and jobs taken from another thread's deque since initialize
+  size_t getExecutedCount() const;
+  size_t getStolenCount() const;
+
+private:
+  // Own cache line each, the counters are written by the owning thread on
+  // every job
+  struct alignas(64) JobQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+    std::atomic<size_t> executed{0};
+    std::atomic<size_t> stolen{0};
+  };
+
+  JobSystem();
+  ~JobSystem();
+
+  bool initialized;
+  std::thread::id mainThreadId;
+  std::vector<std::thread> workers;
+
+  // One per worker, plus the shared one (last) for every other thread
+  std::vector<std::unique_ptr<JobQueue>> queues;
+  MPSCQueue<Job> mainThreadJobs;
+
+  // Sleeping: workers wait on wakeUp once there is nothing to run
+  std::atomic<size_t> queuedCount;
+  std::atomic<int> sleepingCount;
+  std::atomic<bool> stopping;
+  std::mutex sleepMutex;
+  std::condition_variable wakeUp;
+
+  void workerLoop(size_t index);
+  size_t currentQueueIndex() const;
+  void enqueue(Job job, JobCounter *after);
+  void push(Job job);
+  bool popOrSteal(size_t index, Job &job);
+  void execute(Job &job, size_t index);
+  void finish(JobCounter &counter);
+};
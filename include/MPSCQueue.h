@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+// Unbounded multi-producer / single-consumer queue (Vyukov's node based
+// design). Any number of threads may push concurrently without locking; only
+// one thread may pop. Producers never wait on the consumer, which makes it
+// suitable for handing work from background threads to the main loop.
+template <typename T> class MPSCQueue {
+private:
+  struct Node {
+    std::atomic<Node *> next;
+    T value;
+
+    Node() : next(nullptr) {}
+    explicit Node(T &&v) : next(nullptr), value(std::move(v)) {}
+  };
+
+  std::atomic<Node *> head; // Most recently pushed node (producers)
+  Node *tail;               // Stub / last consumed node (consumer only)
+
+public:
+  MPSCQueue() {
+    Node *stub = new Node();
+    head.store(stub, std::memory_order_relaxed);
+    tail = stub;
+  }
+
+  ~MPSCQueue() {
+    T discarded;
+    while (pop(discarded)) {
+    }
+    delete tail;
+  }
+
+  void push(T value) {
+    Node *node = new Node(std::move(value));
+    Node *previous = head.exchange(node, std::memory_order_acq_rel);
+    // Between the exchange and this store the consumer sees the chain as
+    // ending at previous and simply reports the queue as empty
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  // Consumer thread only
+  bool pop(T &out) {
+    Node *current = tail;
+    Node *next = current->next.load(std::memory_order_acquire);
+    if (!next) {
+      return false;
+    }
+
+    out = std::move(next->value);
+    tail = next;
+    delete current;
+    return true;
+  }
+
+  // Consumer thread only
+  bool empty() const {
+    return tail->next.load(std::memory_order_acquire) == nullptr;
+  }
+
+  MPSCQueue(const MPSCQueue &) = delete;
+  MPSCQueue &operator=(const MPSCQueue &) = delete;
+};
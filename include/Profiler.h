@@ -0,0 +1,196 @@
+#pragma once
+
+// Scoped CPU profiler. Zones are written to a ring buffer owned by the
+// calling thread as raw timestamps (rdtsc where available) and are only
+// converted to milliseconds when read, so a zone costs two timestamp reads
+// and one store. Building with CROWNFLAME_PROFILER=0 removes the profiler and
+// turns every macro into a no-op.
+//
+//   void GameWorld::handleCollisions() {
+//     PROFILE_SCOPE("Collisions");
+//     ...
+//   }
+
+#ifndef CROWNFLAME_PROFILER
+#define CROWNFLAME_PROFILER 0
+#endif
+
+#if CROWNFLAME_PROFILER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_USE_RDTSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) &&                            \
+    (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PROFILER_USE_RDTSC 1
+#else
+#include <chrono>
+#define PROFILER_USE_RDTSC 0
+#endif
+
+class Profiler {
+public:
+  // Raw zone as recorded by the owning thread
+  struct Zone {
+    const char *name; // Must outlive the profiler (string literals)
+    uint64_t start;
+    uint64_t end;
+    uint32_t depth;
+  };
+
+  // Zone converted for display / export
+  struct ZoneRecord {
+    const char *name;
+    double startMs; // Relative to the start of the requested range
+    double durationMs;
+    uint32_t depth;
+    uint32_t thread;
+  };
+
+  struct Frame {
+    uint64_t start = 0;
+    uint64_t end = 0;
+  };
+
+  // One per thread that records zones. Only the owning thread writes; when
+  // the thread exits the buffer is kept (with its zones) and handed to the
+  // next new thread.
+  struct ThreadBuffer {
+    static constexpr size_t CAPACITY = 1 << 15;
+
+    std::vector<Zone> zones;
+    std::atomic<uint64_t> written{0};
+    uint32_t depth = 0;
+    uint32_t index = 0;
+    bool inUse = false; // Guarded by the profiler's mutex
+    std::string name;
+
+    void record(const char *zoneName, uint64_t start, uint64_t end,
+                uint32_t zoneDepth) {
+      uint64_t slot = written.load(std::memory_order_relaxed);
+      zones[slot & (CAPACITY - 1)] = {zoneName, start, end, zoneDepth};
+      written.store(slot + 1, std::memory_order_release);
+    }
+  };
+
+  // Frames kept for the UI
+  static constexpr size_t MAX_FRAMES = 300;
+
+  static Profiler &get();
+
+  static uint64_t now() {
+#if PROFILER_USE_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+  }
+
+  // Buffer of the calling thread, registered on first use
+  static ThreadBuffer &threadBuffer();
+
+  // Marks the start of a new frame (main thread)
+  void beginFrame();
+  void setThreadName(const char *name);
+
+  // Paused: zones and frames are dropped so the current view stays put
+  void setPaused(bool pause) { paused.store(pause, std::memory_order_relaxed); }
+  bool isPaused() const { return paused.load(std::memory_order_relaxed); }
+
+  // Completed frames, 0 = most recent
+  size_t getFrameCount() const;
+  bool getFrame(size_t framesAgo, Frame &frame) const;
+  double getFrameMs(size_t framesAgo) const;
+
+  // Zones of all threads that start inside [start, end), ordered by thread
+  // then start time
+  std::vector<ZoneRecord> collectZones(uint64_t start, uint64_t end) const;
+  size_t getThreadCount() const;
+  std::string getThreadName(uint32_t index) const;
+
+  double ticksToMs(uint64_t ticks) const;
+
+  // Everything still in the ring buffers, in the Trace Event format read by
+  // chrome://tracing and Perfetto
+  bool exportChromeTrace(const std::string &path) const;
+
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+private:
+  Profiler();
+
+  ThreadBuffer *acquireThreadBuffer();
+  void releaseThreadBuffer(ThreadBuffer *buffer);
+  friend struct ThreadBufferOwner;
+
+  // Copies the zones of one buffer that ended at or after fromTicks, newest
+  // first, keeping only those still valid once the copy is done
+  void snapshot(const ThreadBuffer &buffer, uint64_t fromTicks,
+                std::vector<Zone> &out) const;
+
+  mutable std::mutex buffersMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+  // Frame ring, written by the main thread only
+  Frame frames[MAX_FRAMES];
+  std::atomic<uint64_t> frameCount{0};
+  uint64_t currentFrameStart = 0;
+
+  std::atomic<bool> paused{false};
+
+  double ticksPerMs = 1.0;
+  uint64_t epochTicks = 0;
+};
+
+class ProfileZone {
+public:
+  explicit ProfileZone(const char *zoneName)
+      : buffer(Profiler::threadBuffer()), name(zoneName),
+        depth(buffer.depth++), start(Profiler::now()) {}
+
+  ~ProfileZone() {
+    uint64_t end = Profiler::now();
+    buffer.depth--;
+    if (!Profiler::get().isPaused()) {
+      buffer.record(name, start, end, depth);
+    }
+  }
+
+  ProfileZone(const ProfileZone &) = delete;
+  ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+  Profiler::ThreadBuffer &buffer;
+  const char *name;
+  uint32_t depth;
+  uint64_t start;
+};
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+#define PROFILE_SCOPE(name)                                                    \
+  ProfileZone PROFILER_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_FRAME() Profiler::get().beginFrame()
+#define PROFILE_THREAD(name) Profiler::get().setThreadName(name)
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+// Draw order handed to gl2d::Renderer2D::setLayer. Layers are drawn from low
+// to high; inside a layer gl2d groups quads by texture, so everything that
+// has to appear on top of something else needs a higher layer.
+namespace RenderLayer {
+constexpr uint32_t TILES = 0;
+constexpr uint32_t OBJECTS = 1; // Obstacles, collectibles and the player
+constexpr uint32_t ENEMIES = 2;
+constexpr uint32_t PARTICLES = 3; // Pickup and enemy bursts
+constexpr uint32_t PATH = 4;
+constexpr uint32_t OVERLAY = 5; // Game over dimming
+constexpr uint32_t OVERLAY_TEXT = 6;
+
+// Scene transition composite, drawn in a flush of its own
+constexpr uint32_t TRANSITION_SCENES = 0;
+constexpr uint32_t TRANSITION_FADE = 1;
+} // namespace RenderLayer
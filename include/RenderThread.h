@@ -0,0 +1,83 @@
+#pragma once
+#include "UIManager.h"
+#include <condition_variable>
+#include <gl2d/gl2d.h>
+#include <mutex>
+#include <thread>
+
+struct GLFWwindow;
+
+// Everything needed to draw one frame, recorded by the main thread. Nothing
+// in it points back at simulation state, so the simulation can move on while
+// it is drawn.
+struct RenderSnapshot {
+  // Only records draw data, it is never created or flushed; its camera,
+  // layer and text layout cache stay with it when the data is swapped out
+  gl2d::Renderer2D drawData;
+  UIDrawData ui;
+  int width = 0;
+  int height = 0;
+
+  // Placed after the frame's texture and buffer uploads on the recording
+  // context, the render thread waits on it before drawing
+  GLsync uploadFence = nullptr;
+
+  void clear();
+};
+
+// Draws snapshots on a thread that owns the window's GL context while the
+// main thread records the next one. At most one snapshot waits while another
+// is drawn, so the frame on screen is never more than two frames behind the
+// simulation.
+class RenderThread {
+private:
+  GLFWwindow *window;
+  gl2d::Renderer2D *renderer; // Created on the window's context
+  bool vsync;
+  std::thread thread;
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  RenderSnapshot pending; // Guarded by mutex
+  bool hasPending;
+  bool drawing;
+  bool stopRequested;
+  bool pauseRequested;
+  bool paused;
+  gl2d::RenderStats lastStats;
+
+  UIDrawData ui; // Of the frame being drawn (render thread only)
+
+  void renderLoop();
+  void drawFrame(int width, int height, GLsync uploadFence);
+
+public:
+  RenderThread();
+  ~RenderThread();
+
+  // The window's context must be current on no thread. renderer must have
+  // been created on it and is used only by the render thread from now on
+  // (except while paused).
+  bool start(GLFWwindow *window, gl2d::Renderer2D *renderer, bool vsync);
+
+  // Draws what is still queued and releases the window's context
+  void stop();
+  bool isRunning() const { return thread.joinable(); }
+
+  // Queues snapshot for drawing and hands back the one queued before it
+  // (already drawn) in its place. Blocks while a snapshot is still queued.
+  void submit(RenderSnapshot &snapshot);
+
+  // Blocks until every submitted snapshot is drawn, e.g. before deleting GL
+  // objects they may use
+  void waitForIdle();
+
+  // Takes the window's context away from the render thread once it is idle,
+  // so the calling thread can make it current and draw a frame itself. The
+  // caller has to make the context non-current again before resume().
+  void pause();
+  void resume();
+
+  // Counters of the last drawn frame
+  gl2d::RenderStats getLastStats();
+};
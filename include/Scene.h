@@ -1,10 +1,12 @@
 #pragma once
 #include "GameWorld.h"
 #include "SceneData.h"
+#include "SceneDiff.h"
 #include <memory>
 #include <string>
 
 // Forward declarations
+class AssetManager;
 class AudioManager;
 
 class Scene {
@@ -13,12 +15,16 @@ private:
   bool isLoaded;
   bool isActive;
   std::unique_ptr<GameWorld> gameWorld;
+  AssetManager *assetManager; // Handed to every world this scene builds
 
   // Scene completion tracking
   int initialCollectibleCount;
   int initialEnemyCount;
   bool completionTriggered;
 
+  // Screen size the world was built with, reused when reloading
+  int screenWidth, screenHeight;
+
 public:
   Scene();
   explicit Scene(const SceneData::SceneDefinition &definition);
@@ -30,6 +36,11 @@ public:
   void activateScene();
   void deactivateScene();
 
+  // Put the loaded world back into its initial state. Uses the snapshot
+  // taken after load, or recreates the entities from the definition if an
+  // in-place edit invalidated it; resources are never reloaded.
+  bool restartScene();
+
   // Scene operations
   void update(float deltaTime);
   void render(void *renderer);
@@ -46,6 +57,12 @@ public:
   SceneData::SceneDefinition &getDefinition() { return sceneDefinition; }
   void setDefinition(const SceneData::SceneDefinition &definition);
 
+  // Hot reload: diff the new definition against the current one and patch
+  // only the added, removed and changed entities into the live GameWorld.
+  // Returns false if the change can't be applied in place and the scene has
+  // to be reloaded instead.
+  bool applyDefinition(const SceneData::SceneDefinition &definition);
+
   // GameWorld access (for Application/input handling)
   GameWorld *getGameWorld() { return gameWorld.get(); }
   const GameWorld *getGameWorld() const { return gameWorld.get(); }
@@ -77,6 +94,9 @@ public:
   // Audio management
   void setAudioManager(AudioManager *audioManager);
 
+  // Asset management
+  void setAssetManager(AssetManager *assetManager);
+
   // Screen size management
   void updateScreenSize(int width, int height);
 
@@ -93,4 +113,14 @@ private:
   void createCollectibles();
   void createEnemies();
   void createPlayer();
+  GameObject *spawnObstacle(const SceneData::ObstacleData &data, int index);
+  GameObject *spawnCollectible(const SceneData::CollectibleData &data,
+                               int index);
+  Enemy *spawnEnemy(const SceneData::EnemyData &data, int index);
+
+  // In-place patching helpers for applyDefinition
+  void patchObjects(ObjectType type, const SceneData::ListDiff &diff,
+                    const SceneData::SceneDefinition &definition);
+  void patchEnemies(const SceneData::ListDiff &diff,
+                    const SceneData::SceneDefinition &definition);
 };
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include "SceneData.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace SceneData {
+
+// Difference between the old and new version of one entity list
+// (obstacles, collectibles or enemies)
+struct ListDiff {
+  // For every old index: index of the matching new entry, or -1 if removed
+  std::vector<int> oldToNew;
+  // For every old index: true if it was kept but its data changed
+  std::vector<bool> changed;
+  // New indices that have no counterpart in the old list
+  std::vector<size_t> added;
+
+  size_t removedCount = 0;
+  size_t changedCount = 0;
+
+  bool isEmpty() const {
+    if (!added.empty() || removedCount > 0 || changedCount > 0)
+      return false;
+    // Pure reordering still needs the index mapping applied
+    for (size_t i = 0; i < oldToNew.size(); i++) {
+      if (oldToNew[i] != static_cast<int>(i))
+        return false;
+    }
+    return true;
+  }
+};
+
+// Structural difference between two definitions of the same scene
+struct SceneDiff {
+  ListDiff obstacles;
+  ListDiff collectibles;
+  ListDiff enemies;
+
+  bool worldChanged = false;
+  bool cameraChanged = false;
+  bool playerSpawnChanged = false;
+  bool tilemapChanged = false;
+  bool metadataChanged = false; // name, description, nextScene, trigger
+
+  // The tilemap and the world bounds, background and music are set up once
+  // when the world is created, so they cannot be patched into a live scene
+  bool requiresFullReload() const { return tilemapChanged || worldChanged; }
+
+  bool isEmpty() const {
+    return obstacles.isEmpty() && collectibles.isEmpty() &&
+           enemies.isEmpty() && !worldChanged && !cameraChanged &&
+           !playerSpawnChanged && !tilemapChanged && !metadataChanged;
+  }
+
+  // One line summary for logging, e.g. "obstacles +1 -0 ~2, camera"
+  std::string describe() const;
+};
+
+// Matches entities of the old definition to the new one. Entries that are
+// identical are matched first (by index, then anywhere in the list so
+// insertions and deletions don't mark everything after them as changed);
+// leftovers that occupy the same slot between matched neighbours count as
+// changed, and whatever remains is reported as added or removed.
+SceneDiff diffScenes(const SceneDefinition &oldDefinition,
+                     const SceneDefinition &newDefinition);
+
+} // namespace SceneData
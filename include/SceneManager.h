@@ -1,37 +1,78 @@
 #pragma once
 #include "Scene.h"
 #include "SceneData.h"
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 // Forward declarations
+class AssetManager;
 class AudioManager;
+namespace gl2d {
+struct FrameBuffer;
+}
 
 class SceneManager {
 private:
-  // Scene storage
+  // Scene storage. Every registered scene keeps its definition here, its
+  // GameWorld only exists while the scene is resident (Scene::isSceneLoaded)
   std::unordered_map<std::string, std::unique_ptr<Scene>> loadedScenes;
   Scene *currentScene;
   Scene *nextScene;
 
+  // Scene files registered by path, parsed on first use
+  std::unordered_map<std::string, std::string> sceneFiles;
+
+  // Resident scene limit (0 = unlimited), least recently used idle scenes
+  // are unloaded first
+  size_t maxResidentScenes;
+  uint64_t sceneUseCounter;
+  std::unordered_map<std::string, uint64_t> sceneLastUsed;
+
+  // Background preparation of the current scene's nextScene. The file is
+  // parsed on a worker thread, the GameWorld is built on the main thread
+  // once the current scene has settled.
+  static constexpr float PRELOAD_DELAY = 0.5f; // seconds after a scene change
+  std::string preloadSceneName;
+  SceneData::SceneDefinition preloadDefinition;
+  std::future<bool> preloadParse;
+  float preloadTimer;
+
   // Transition state
   bool isTransitioning;
   SceneData::SceneTransition currentTransition;
   float transitionProgress; // 0.0 to 1.0
   float transitionTimer;
 
+  // Offscreen targets both scenes are rendered into during a transition,
+  // created on the first transition
+  std::unique_ptr<gl2d::FrameBuffer> outgoingTarget;
+  std::unique_ptr<gl2d::FrameBuffer> incomingTarget;
+  int targetWidth, targetHeight;
+
+  // Frame times (ms) of the last transition plus a few frames after the
+  // swap, logged once complete so hitches at the swap point show up
+  static constexpr int POST_SWAP_TRACE_FRAMES = 30;
+  std::vector<float> transitionTrace;
+  int transitionSwapFrame; // index of the first frame after the swap
+  int postSwapFramesLeft;
+
   // Screen dimensions
   int screenWidth, screenHeight;
 
   // Shared systems
   AudioManager *audioManager;
+  AssetManager *assetManager;
 
   // Callbacks
   std::function<void(const std::string &)> onSceneChanged;
   std::function<void(const std::string &, const std::string &)>
       onSceneTransitionStarted;
+  std::function<void()> onBeforeSceneUnload;
 
 public:
   SceneManager();
@@ -41,12 +82,19 @@ public:
   bool initialize(int screenWidth, int screenHeight);
   void shutdown();
 
-  // Scene management
+  // Scene management. Both register the scene only, its GameWorld is built
+  // on the first changeScene (or by the next scene preload).
   bool loadSceneFromFile(const std::string &sceneName,
                          const std::string &filePath);
   bool loadSceneFromDefinition(const std::string &sceneName,
                                const SceneData::SceneDefinition &definition);
   void unloadScene(const std::string &sceneName);
+
+  // Re-read a scene file and apply it to the already loaded scene in place
+  // (see Scene::applyDefinition), falling back to a full reload only when
+  // the change can't be patched. Loads the scene if it isn't loaded yet.
+  bool reloadSceneFromFile(const std::string &sceneName,
+                           const std::string &filePath);
   void unloadAllScenes();
 
   // Scene transitions
@@ -56,8 +104,10 @@ public:
   bool changeSceneInstant(const std::string &sceneName);
   void restartCurrentScene();
 
-  // Update and render
+  // Update and render. update() runs once per simulation step,
+  // recordFrameTime() once per rendered frame with the real frame time.
   void update(float deltaTime);
+  void recordFrameTime(float frameTime);
   void render(void *renderer);
 
   // Scene queries
@@ -68,9 +118,20 @@ public:
   bool hasScene(const std::string &sceneName) const;
   Scene *getScene(const std::string &sceneName);
   bool isTransitionInProgress() const { return isTransitioning; }
+  const std::vector<float> &getLastTransitionTrace() const {
+    return transitionTrace;
+  }
+  int getLastTransitionSwapFrame() const { return transitionSwapFrame; }
+
+  // Resident scenes
+  void setMaxResidentScenes(size_t count);
+  size_t getMaxResidentScenes() const { return maxResidentScenes; }
+  size_t getResidentSceneCount() const;
+  const std::string &getPreloadSceneName() const { return preloadSceneName; }
 
   // System management
   void setAudioManager(AudioManager *manager);
+  void setAssetManager(AssetManager *manager);
   void updateScreenSize(int width, int height);
 
   // Callbacks
@@ -78,6 +139,9 @@ public:
   setOnSceneChangedCallback(std::function<void(const std::string &)> callback);
   void setOnSceneTransitionStartedCallback(
       std::function<void(const std::string &, const std::string &)> callback);
+  // Called before a scene frees its world (and with it GL resources), e.g.
+  // to let frames still being drawn with them finish
+  void setOnBeforeSceneUnloadCallback(std::function<void()> callback);
 
   // Scene file operations
   bool saveSceneToFile(const std::string &sceneName,
@@ -90,9 +154,21 @@ public:
 
 private:
   // Internal helpers
+  Scene *findOrCreateScene(const std::string &sceneName);
+  bool instantiateScene(const std::string &sceneName, Scene *scene);
+  void evictIdleScenes();
+  void unloadSceneWorld(Scene *scene);
+  bool isSceneInUse(const Scene *scene) const;
+  void startPreload(const std::string &sceneName);
+  void cancelPreload();
+  void updatePreload(float deltaTime);
   void finishTransition();
   void updateTransition(float deltaTime);
   void renderTransition(void *renderer);
+  bool ensureTransitionTargets();
+  void renderSceneToTarget(void *renderer, Scene *scene,
+                           gl2d::FrameBuffer &target);
+  void logTransitionTrace() const;
 
   // Transition effects
   void renderFadeTransition(void *renderer, float progress);
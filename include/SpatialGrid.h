@@ -0,0 +1,42 @@
+#pragma once
+#include "GameObject.h"
+#include <cstdint>
+#include <vector>
+
+// Coarse uniform grid over the world for "what is near this rectangle"
+// queries. Entries are caller-defined ids (usually indices into an entity
+// list) listed in every cell their bounds touch; bounds outside the world
+// are clamped into the edge cells, so queries never miss them.
+class SpatialGrid {
+public:
+  explicit SpatialGrid(float cellSize = 256.0f);
+
+  // Resizes the grid to cover a world of the given size and drops all
+  // entries
+  void reset(float worldWidth, float worldHeight);
+
+  // Drops all entries, keeping the cell allocations
+  void clear();
+
+  void insert(uint32_t id, const Rectangle &bounds);
+
+  // Replaces out with the ids listed in the cells area touches, sorted and
+  // without duplicates. These are candidates: callers check the actual
+  // bounds.
+  void query(const Rectangle &area, std::vector<uint32_t> &out) const;
+
+  float getCellSize() const { return cellSize; }
+  int getColumns() const { return columns; }
+  int getRows() const { return rows; }
+  size_t getEntryCount() const { return entryCount; }
+
+private:
+  void cellRange(const Rectangle &area, int &minX, int &minY, int &maxX,
+                 int &maxY) const;
+
+  float cellSize;
+  int columns;
+  int rows;
+  size_t entryCount;
+  std::vector<std::vector<uint32_t>> cells; // Row-major
+};
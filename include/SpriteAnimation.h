@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+// Per-entity animation state: which clip plays and how far into it. Clips are
+// owned by an AnimationLibrary and shared by every entity that plays them.
+struct AnimationState {
+  uint16_t clip = 0;
+  float time = 0.0f; // Seconds into the clip
+};
+
+// Sprite-sheet animation clips. Every clip is a range of frames (a uv rect in
+// the sheet and how long it is shown); the frames of all clips live in one
+// table, and each clip also gets a lookup of frame by time slot so finding
+// the frame for a time is two reads instead of a search.
+class AnimationLibrary {
+public:
+  static constexpr uint16_t INVALID_CLIP = 0xFFFF;
+
+  struct Frame {
+    glm::vec4 uv; // gl2d texture coordinates (left, top, right, bottom)
+    float duration;
+  };
+
+  // Adds a clip and returns its id, or INVALID_CLIP if it has no frames or a
+  // frame with a non-positive duration. Re-adding a name replaces the id
+  // lookup but not clips already handed out.
+  uint16_t addClip(const std::string &name, const std::vector<Frame> &frames,
+                   bool loop = true);
+
+  // Clip of count cells of a columns x rows sheet starting at cell first
+  // (row-major, top-left first), durations per frame in seconds. A single
+  // duration is used for all frames.
+  uint16_t addSheetClip(const std::string &name, int columns, int rows,
+                        int first, int count,
+                        const std::vector<float> &durations,
+                        bool loop = true);
+
+  uint16_t findClip(const std::string &name) const;
+  size_t getClipCount() const { return clips.size(); }
+  float getClipDuration(uint16_t clip) const { return clips[clip].duration; }
+
+  // Moves every state forward by deltaTime, wrapping looping clips and
+  // holding the last frame of the others
+  void advance(AnimationState *states, size_t count, float deltaTime) const;
+
+  // Index into the frame table of the frame showing at state.time
+  uint32_t getFrameIndex(const AnimationState &state) const;
+  const glm::vec4 &getFrameUV(const AnimationState &state) const {
+    return frameUVs[getFrameIndex(state)];
+  }
+
+  void clear();
+
+private:
+  struct Clip {
+    uint32_t firstFrame;
+    uint32_t frameCount;
+    float duration;
+    float wrap; // Subtracted from the time when it reaches duration
+    bool loop;
+
+    // Time slots as long as the shortest frame, so a frame boundary falls at
+    // most once inside a slot
+    uint32_t firstSlot;
+    uint32_t slotCount;
+    float slotsPerSecond;
+  };
+
+  std::vector<Clip> clips;
+  std::vector<std::string> clipNames; // Kept apart so Clip stays small
+  float shortestClip = 0.0f;
+
+  // Frame table shared by all clips
+  std::vector<glm::vec4> frameUVs;
+  std::vector<float> frameEnds; // End time of each frame within its clip
+
+  // Frame (relative to the clip) at the start of each time slot
+  std::vector<uint16_t> slotFrames;
+};
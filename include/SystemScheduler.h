@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class JobCounter;
+
+// Runs the systems of a simulation step as a dependency graph. Every system
+// declares the data it reads and writes as bit masks (what a bit stands for
+// is up to the owner, see setDataNames). Two systems conflict when one of
+// them writes something the other reads or writes; conflicting systems run
+// in the order they were added, everything else may run at the same time on
+// the JobSystem workers. The result is therefore the same as running all
+// systems one after the other in that order.
+class SystemScheduler {
+public:
+  using AccessMask = uint32_t;
+  using SystemFunction = std::function<void(float)>;
+
+  struct System {
+    std::string name;
+    AccessMask reads = 0;
+    AccessMask writes = 0;
+    bool mainThread = false; // Audio, GL and other main-thread-only work
+    bool enabled = true;
+    SystemFunction function;
+
+    // Graph of the last run: the earlier systems it waited for and how many
+    // systems lie on the longest chain before it
+    std::vector<size_t> dependencies;
+    int level = 0;
+
+    // Last run, relative to the start of the step
+    double startSeconds = 0.0;
+    double seconds = 0.0;
+    bool ranOnMainThread = true;
+
+    double totalSeconds = 0.0; // Since the last resetTotals()
+  };
+
+  SystemScheduler();
+
+  // Returns the index of the system. Reads and writes may overlap; a
+  // read-modify-write only needs to be declared as a write.
+  size_t addSystem(const std::string &name, AccessMask reads,
+                   AccessMask writes, SystemFunction function,
+                   bool mainThread = false);
+  void setEnabled(size_t system, bool enabled);
+  const std::vector<System> &getSystems() const { return systems; }
+
+  // Names of the data bits, for display. describe() lists the named bits
+  // set in mask.
+  void setDataNames(std::vector<std::string> names);
+  std::string describe(AccessMask mask) const;
+
+  // Rebuilds the graph from the enabled systems and runs them. Runs them one
+  // after the other on the calling thread when parallel is off, when there
+  // are no job workers, when not called from the main thread (main-thread
+  // systems need it free to run them) or when the systems took less than
+  // the minimum parallel time together last run.
+  void run(float deltaTime);
+
+  void setParallel(bool enable) { parallel = enable; }
+  bool isParallel() const { return parallel; }
+
+  // Handing a system to a worker costs a few microseconds, steps with less
+  // work than this are cheaper in order (default 0.1 ms)
+  void setMinParallelSeconds(double seconds) { minParallelSeconds = seconds; }
+  double getMinParallelSeconds() const { return minParallelSeconds; }
+
+  // Of the last run: levels in the graph, wall time and whether it ran on
+  // the workers
+  int getLevelCount() const { return levelCount; }
+  double getLastRunSeconds() const { return lastRunSeconds; }
+  bool ranInParallel() const { return lastRunParallel; }
+
+  uint64_t getRunCount() const { return runCount; }
+  void resetTotals();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  std::vector<System> systems;
+  std::vector<std::string> dataNames;
+  bool parallel;
+  double minParallelSeconds;
+
+  // Reverse edges and unfinished dependencies of each system, for the run
+  std::vector<std::vector<size_t>> dependents;
+  std::vector<std::atomic<int>> remaining;
+
+  Clock::time_point runStart;
+  int levelCount;
+  double lastRunSeconds;
+  double lastSystemSeconds; // Sum over the systems
+  bool lastRunParallel;
+  uint64_t runCount;
+
+  void buildGraph();
+  void execute(size_t index, float deltaTime);
+  void launch(size_t index, float deltaTime, JobCounter &done);
+};
@@ -4,6 +4,7 @@
 #include <memory>
 #include <vector>
 
+class GpuTileLayer;
 
 /**
  * Represents a 2D grid of tiles that forms a game map
@@ -21,6 +22,10 @@ private:
   std::string name;
   glm::vec2 worldPosition; // Position of the map in world coordinates
 
+  // Tile-index texture drawn by a shader, created on the first GPU render
+  std::unique_ptr<GpuTileLayer> gpuLayer;
+  static bool gpuRendering;
+
 public:
   TileMap();
   TileMap(int width, int height, Tileset *tilesetPtr);
@@ -48,6 +53,11 @@ public:
               const glm::vec2 &screenSize);
   void renderTile(void *renderer, int x, int y, const glm::vec2 &renderPos);
 
+  // Draws every map as one shader pass instead of a sprite per tile. Maps
+  // whose tile images can't go in a texture array keep using sprites.
+  static void setGpuRendering(bool enabled) { gpuRendering = enabled; }
+  static bool isGpuRendering() { return gpuRendering; }
+
   // Coordinate conversion
   glm::vec2 tileToWorldPosition(int tileX, int tileY) const;
   glm::ivec2 worldToTilePosition(const glm::vec2 &worldPos) const;
@@ -14,11 +14,15 @@ private:
   std::unordered_map<std::string, std::unique_ptr<Tileset>> tilesets;
   std::unordered_map<std::string, std::unique_ptr<TileMap>> tileMaps;
   TileMap *currentMap; // The currently active map
+  AssetManager *assetManager; // Loads the tile images, if set
 
 public:
   TileMapManager();
   ~TileMapManager();
 
+  // Tilesets loaded from now on take their images from manager
+  void setAssetManager(AssetManager *manager) { assetManager = manager; }
+
   // Tileset management
   bool loadTileset(const std::string &name, const std::string &imagePath,
                    int tileWidth, int tileHeight);
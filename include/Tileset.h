@@ -5,6 +5,8 @@
 #include <unordered_map>
 #include <vector>
 
+class AssetManager;
+
 /**
  * Manages a collection of tiles from individual tile images
  */
@@ -16,6 +18,12 @@ private:
   std::unordered_map<std::string, void *>
       tileTextures; // Individual tile textures
 
+  // With an asset manager the tile images are loaded (and owned) by it, so
+  // they go through its texture cache and are shared between tilesets.
+  // Maps tile name -> asset name for those.
+  AssetManager *assetManager;
+  std::unordered_map<std::string, std::string> sharedTextures;
+
   // Tileset properties
   int tileWidth;
   int tileHeight;
@@ -26,6 +34,7 @@ public:
   ~Tileset();
 
   // Loading functions
+  void setAssetManager(AssetManager *manager) { assetManager = manager; }
   bool loadTileFromFile(int id, const std::string &tileName,
                         const std::string &imagePath);
   bool loadGrassTileset(); // Specialized loader for our grass tileset
@@ -3,13 +3,40 @@
 #include "GameWorld.h"
 #include <glm/glm.hpp>
 #include <string>
+#include <vector>
 
 // Forward declarations
+namespace gl2d {
+struct RenderStats;
+}
+struct ImDrawList;
+class AssetManager;
 class SceneManager;
 class Scene;
 class HotReloadManager;
 struct SceneValidationResult;
 
+// ImGui output of one frame, copied out of ImGui so it can still be drawn
+// after the next frame has started (see UIManager::endFrame(UIDrawData &))
+class UIDrawData {
+public:
+  UIDrawData() = default;
+  ~UIDrawData() { clear(); }
+  UIDrawData(const UIDrawData &) = delete;
+  UIDrawData &operator=(const UIDrawData &) = delete;
+
+  void clear();
+  void swap(UIDrawData &other);
+  bool empty() const { return lists.empty(); }
+
+private:
+  friend class UIManager;
+  std::vector<ImDrawList *> lists; // Owned copies
+  glm::vec2 displayPos = glm::vec2(0.0f);
+  glm::vec2 displaySize = glm::vec2(0.0f);
+  glm::vec2 framebufferScale = glm::vec2(1.0f);
+};
+
 class UIManager {
 private:
   bool initialized;
@@ -21,24 +48,45 @@ private:
   bool showFileBrowser;
   bool showSceneInfo;
   bool showValidationResults;
+  bool showAssetMemory;
+  bool showProfiler;
+  bool showRenderStats;
+  bool showSystemSchedule;
   SceneValidationResult *currentValidationResult;
 
   // Scene list management
   bool needsSceneListRefresh;
 
+  // Profiler window state
+  int profilerFrame; // Frames ago
+  std::string profilerExportStatus;
+
+  // Draw calls and quads of recent frames for the render stats graphs
+  static constexpr int RENDER_STATS_HISTORY = 240;
+  float drawCallHistory[RENDER_STATS_HISTORY];
+  float quadHistory[RENDER_STATS_HISTORY];
+  int renderStatsOffset;
+
 public:
   UIManager();
   ~UIManager();
 
-  // Initialize/shutdown ImGui
-  bool
-  initialize(void *window); // Using void* to avoid GLFW dependency in header
+  // Initialize/shutdown ImGui. Windows can only be dragged out of the main
+  // window (multi-viewports) when the UI is drawn on the thread that builds
+  // it.
+  bool initialize(void *window, // Using void* to avoid GLFW dependency
+                  bool multiViewport = true);
   void shutdown();
 
   // Frame management
   void beginFrame();
   void endFrame();
 
+  // Ends the frame without drawing it; its output is copied into drawData
+  // for renderDrawData, which only needs the GL context (any thread)
+  void endFrame(UIDrawData &drawData);
+  static void renderDrawData(const UIDrawData &drawData);
+
   // UI rendering
   void renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
                     float &playerSpeed);
@@ -52,8 +100,24 @@ public:
                     float &playerSpeed, SceneManager &sceneManager,
                     HotReloadManager &hotReloadManager);
 
+  // Per-asset CPU/GPU memory breakdown (opened from the Game Controls window)
+  void renderAssetMemoryWindow(AssetManager &assetManager);
+
+  // Frame timeline and flame graph of the scoped profiler (empty when the
+  // profiler is compiled out)
+  void renderProfilerWindow();
+
+  // Renderer counters (draw calls, quads, texture binds, uploaded bytes) of
+  // the last frame
+  void renderRenderStatsWindow(const gl2d::RenderStats &stats);
+
+  // Systems of the world's last simulation step: what they access, which
+  // ones they waited for, and when and where they ran
+  void renderSystemScheduleWindow(GameWorld &gameWorld);
+
 private:
   // Helper methods for different UI sections
+  void renderFrameTiming(const FPSCounter &fpsCounter);
   void renderPlayerInfo(GameObject *player, const glm::vec2 &cameraPos);
   void renderControls();
   void renderWorldInfo(GameWorld &gameWorld);
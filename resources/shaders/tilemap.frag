@@ -0,0 +1,34 @@
+#version 330
+// Looks up the tile under the pixel and samples its image. Tile slots are
+// assigned by GpuTileLayer; slot 0 in the index texture means no tile.
+
+uniform usampler2D u_tileIndices; // Slot + 1 per tile
+uniform sampler2DArray u_tileImages; // One layer per slot
+uniform sampler2D u_tileInfo; // Row 0: tint, row 1: uv rect (left, top, right, bottom)
+
+in vec2 v_tilePosition;
+out vec4 color;
+
+void main()
+{
+	// Taken before the discard, and from the unwrapped position so mip
+	// selection doesn't jump at tile edges
+	vec2 dx = dFdx(v_tilePosition);
+	vec2 dy = dFdy(v_tilePosition);
+
+	ivec2 tile = min(ivec2(floor(v_tilePosition)), textureSize(u_tileIndices, 0) - 1);
+	uint index = texelFetch(u_tileIndices, tile, 0).r;
+	if (index == 0u)
+	{
+		discard;
+	}
+
+	int slot = int(index) - 1;
+	vec4 tint = texelFetch(u_tileInfo, ivec2(slot, 0), 0);
+	vec4 uvRect = texelFetch(u_tileInfo, ivec2(slot, 1), 0);
+	vec2 uvScale = uvRect.zw - uvRect.xy;
+	vec2 uv = uvRect.xy + uvScale * fract(v_tilePosition);
+
+	color = tint * textureGrad(u_tileImages, vec3(uv, float(slot)),
+		dx * uvScale, dy * uvScale);
+}
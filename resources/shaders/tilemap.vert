@@ -0,0 +1,29 @@
+#version 330
+// One quad covering the whole tile map. Corner i of the strip is
+// (i / 2, i % 2) in units of the map size; the camera transform is the same
+// one gl2d applies to its quads (y up, offset, then rotation and zoom around
+// the centre of the view).
+
+uniform vec4 u_mapRect; // World position and size of the map in pixels
+uniform vec2 u_mapSize; // In tiles
+uniform vec2 u_cameraPosition;
+uniform float u_cameraZoom;
+uniform float u_cameraRotation; // Radians
+uniform vec2 u_viewSize;
+
+out vec2 v_tilePosition;
+
+void main()
+{
+	vec2 corner = vec2(gl_VertexID / 2, gl_VertexID % 2);
+	vec2 world = u_mapRect.xy + corner * u_mapRect.zw;
+
+	vec2 center = vec2(u_viewSize.x * 0.5, -u_viewSize.y * 0.5);
+	vec2 p = vec2(world.x - u_cameraPosition.x, -world.y + u_cameraPosition.y) - center;
+	float s = sin(u_cameraRotation);
+	float c = cos(u_cameraRotation);
+	p = vec2(p.x * c - p.y * s, p.x * s + p.y * c) * u_cameraZoom + center;
+
+	gl_Position = vec4(p.x / u_viewSize.x * 2.0 - 1.0, p.y / u_viewSize.y * 2.0 + 1.0, 0.0, 1.0);
+	v_tilePosition = corner * u_mapSize;
+}
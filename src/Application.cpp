@@ -1,11 +1,21 @@
 #include "Application.h"
+#include "GpuTileLayer.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <glad/glad.h>
 #include <iostream>
 #include <openglErrorReporting.h>
+#include <thread>
 
 Application::Application()
-    : window(nullptr), windowWidth(800), windowHeight(600), playerSpeed(200.0f),
-      lastTime(0.0), isRunning(false), inputManager(nullptr) {}
+    : window(nullptr), windowWidth(800), windowHeight(600),
+      useRenderThread(false), loaderWindow(nullptr), playerSpeed(200.0f),
+      accumulator(0.0), renderAlpha(1.0f), vsyncEnabled(true), maxFps(0),
+      headless(false), perfDumpFrames(0), lastTime(0.0), isRunning(false),
+      inputManager(nullptr) {}
 
 Application::~Application() { shutdown(); }
 
@@ -19,6 +29,9 @@ bool Application::initialize(int width, int height, const char *title) {
   if (!initializeGame())
     return false;
 
+  if (useRenderThread)
+    startRenderThread();
+
   isRunning = true;
   return true;
 }
@@ -28,34 +41,142 @@ void Application::run() {
     return;
 
   lastTime = glfwGetTime();
+  PROFILE_THREAD("Main");
+
+  if (!perfDumpPath.empty()) {
+    fpsCounter.startDump(perfDumpPath);
+  }
 
   while (!glfwWindowShouldClose(window) && isRunning) {
-    // Calculate delta time
+    PROFILE_FRAME();
+
+    // Calculate frame time
     double currentTime = glfwGetTime();
-    float deltaTime = static_cast<float>(currentTime - lastTime);
+    float frameTime = static_cast<float>(currentTime - lastTime);
     lastTime = currentTime;
 
     // Handle events
     handleEvents();
 
-    // Update
-    update(deltaTime);
+    // Apply file changes picked up by the watcher thread. This is the only
+    // point where scenes and audio may be swapped out, so nothing is halfway
+    // through an update or a draw and the GL context is current.
+    hotReloadManager.processPendingReloads(HOT_RELOAD_BUDGET_MS);
 
-    // Render
-    render();
+    // Jobs that need the main thread (GL uploads after a decode, say)
+    JobSystem::get().runMainThreadJobs();
+
+    // Update
+    update(frameTime);
+
+    // Render. Transitions draw the scenes into framebuffers, which (unlike
+    // textures and buffers) only exist in the window's context, so those
+    // frames are drawn here.
+    if (renderThread.isRunning() && !sceneManager.isTransitionInProgress()) {
+      renderThreaded();
+    } else {
+      renderSynchronously();
+    }
 
-    // Swap buffers and poll events
-    glfwSwapBuffers(window);
     glfwPollEvents();
+
+    applyFramePacing(currentTime);
+
+    if (perfDumpFrames > 0 && fpsCounter.isDumping() &&
+        fpsCounter.getDumpedFrameCount() >=
+            static_cast<size_t>(perfDumpFrames)) {
+      glfwSetWindowShouldClose(window, GLFW_TRUE);
+    }
+  }
+
+  if (fpsCounter.isDumping()) {
+    fpsCounter.stopDump();
+  }
+}
+
+bool Application::runHeadless(int steps) {
+  if (!isRunning || steps <= 0)
+    return false;
+
+  Scene *scene = sceneManager.getCurrentScene();
+  GameWorld *world = scene ? scene->getGameWorld() : nullptr;
+  if (!world) {
+    std::cerr << "Headless run: no active scene" << std::endl;
+    return false;
+  }
+
+  std::cout << "Headless run: " << steps << " steps at "
+            << static_cast<int>(std::round(1.0 / FIXED_TIMESTEP))
+            << " Hz in scene '" << scene->getName() << "'" << std::endl;
+
+  const float dt = static_cast<float>(FIXED_TIMESTEP);
+  auto start = std::chrono::steady_clock::now();
+
+  for (int step = 0; step < steps; step++) {
+    // Scripted input so movement and collisions are exercised the same way
+    // on every run: the player walks in a slow circle
+    float angle = step * dt * 0.5f;
+    glm::vec2 movement(std::cos(angle), std::sin(angle));
+    simulateStep(dt, movement);
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+
+  // Re-fetch, the run may have progressed to another scene
+  scene = sceneManager.getCurrentScene();
+  world = scene ? scene->getGameWorld() : nullptr;
+  GameObject *player = world ? world->getPlayer() : nullptr;
+
+  std::cout << "Headless run: " << steps << " steps in " << seconds * 1000.0
+            << " ms (" << (seconds > 0.0 ? steps / seconds : 0.0)
+            << " steps/sec, " << seconds * 1e6 / steps << " us/step)"
+            << std::endl;
+
+  // Same inputs and step size give the same result, handy for spotting
+  // changes in simulation behaviour
+  if (player) {
+    std::cout << "Headless run: final player position " << player->bounds.x
+              << ", " << player->bounds.y << " in scene '" << scene->getName()
+              << "'" << std::endl;
+  }
+  return true;
+}
+
+void Application::applyFramePacing(double frameStart) {
+  if (vsyncEnabled || maxFps <= 0)
+    return;
+
+  // Sleep off most of the remaining frame time, then yield until the
+  // deadline since sleep granularity is often a millisecond or worse
+  double frameEnd = frameStart + 1.0 / maxFps;
+  double remaining = frameEnd - glfwGetTime();
+  if (remaining > 0.002) {
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(remaining - 0.001));
+  }
+  while (glfwGetTime() < frameEnd) {
+    std::this_thread::yield();
   }
 }
 
 void Application::shutdown() {
-  // Save window settings before shutdown
-  if (window) {
+  // Save window settings before shutdown (the headless window is hidden
+  // and not worth remembering)
+  if (window && !headless) {
     settings.saveCurrentWindowState(window);
   }
 
+  // Everything below is cleaned up with the window's context current here
+  renderThread.stop();
+  if (loaderWindow) {
+    glfwMakeContextCurrent(window);
+    snapshot.clear();
+  }
+
+  // Queued jobs may still use any of the systems below
+  JobSystem::get().shutdown();
+
   // Shutdown hot reload manager
   hotReloadManager.shutdown();
 
@@ -75,6 +196,11 @@ void Application::shutdown() {
     inputManager = nullptr;
   }
 
+  if (loaderWindow) {
+    glfwDestroyWindow(loaderWindow);
+    loaderWindow = nullptr;
+  }
+
   if (window) {
     glfwDestroyWindow(window);
     window = nullptr;
@@ -98,6 +224,11 @@ bool Application::initializeWindow(int width, int height, const char *title) {
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #endif
 
+  // Headless runs still need a GL context for textures, just no window
+  if (headless) {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  }
+
   window = glfwCreateWindow(width, height, title, NULL, NULL);
   if (!window) {
     glfwTerminate();
@@ -107,14 +238,39 @@ bool Application::initializeWindow(int width, int height, const char *title) {
   windowWidth = width;
   windowHeight = height;
 
+  // Hidden window whose context shares objects with the window's, current on
+  // this thread once the render thread has taken the window's context
+  useRenderThread =
+      !headless && settings.getSetting<bool>("renderThread", true);
+  if (useRenderThread) {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    loaderWindow = glfwCreateWindow(1, 1, "", NULL, window);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!loaderWindow) {
+      std::cerr << "Failed to create a shared context, rendering on the main "
+                   "thread"
+                << std::endl;
+      useRenderThread = false;
+    }
+  }
+
   // Set up window close callback to save settings
   glfwSetWindowUserPointer(window, this);
   glfwSetWindowCloseCallback(window, windowCloseCallback);
 
   // Try to restore window to the last monitor it was on
-  settings.restoreMonitorSettings(window);
+  if (!headless) {
+    settings.restoreMonitorSettings(window);
+  }
 
   glfwMakeContextCurrent(window);
+
+  // Frame pacing: vsync by default, maxFps caps the frame rate without it
+  vsyncEnabled = settings.getSetting<bool>("vsync", true);
+  maxFps = settings.getSetting<int>("maxFps", 0);
+  fpsCounter.setHitchThreshold(
+      settings.getSetting<float>("hitchThresholdMs", 1000.0f / 30.0f));
+  glfwSwapInterval(vsyncEnabled && !headless ? 1 : 0);
   return true;
 }
 
@@ -129,10 +285,16 @@ bool Application::initializeOpenGL() {
   gl2d::init();
   renderer.create();
 
+  // Batch by texture inside the layers GameWorld and SceneManager assign
+  renderer.textureSorting = true;
+
   return true;
 }
 
 bool Application::initializeGame() {
+  // Worker threads for the job system (-1 = one per core but this one)
+  JobSystem::get().initialize(settings.getSetting<int>("jobWorkers", -1));
+
   // Initialize input manager
   inputManager = new InputManager(window);
 
@@ -145,6 +307,29 @@ bool Application::initializeGame() {
               << std::endl;
   }
 
+  // Optional per-type memory budgets in MB (0 = unlimited)
+  const size_t MB = 1024 * 1024;
+  assetManager.setMemoryBudget(
+      AssetManager::AssetType::TEXTURE,
+      settings.getSetting<size_t>("textureBudgetMB", 0) * MB);
+  assetManager.setMemoryBudget(
+      AssetManager::AssetType::AUDIO,
+      settings.getSetting<size_t>("audioBudgetMB", 0) * MB);
+  assetManager.setBudgetExceededCallback(
+      [this](AssetManager::AssetType type, const std::string &loadedAsset,
+             size_t used, size_t budget) {
+        // Frames still being drawn may use the evicted textures
+        renderThread.waitForIdle();
+        size_t freed =
+            assetManager.evictLeastRecentlyUsed(type, budget, loadedAsset);
+        std::cout << "Evicted " << freed / 1024 << " of " << used / 1024
+                  << " KB of " << AssetManager::getAssetTypeString(type)
+                  << " assets" << std::endl;
+      });
+
+  // In-game text; without a font the banner falls back to rectangles
+  assetManager.loadDefaultFont();
+
   // Initialize audio manager
   if (!audioManager.initialize()) {
     std::cerr << "Failed to initialize audio system!" << std::endl;
@@ -163,8 +348,9 @@ bool Application::initializeGame() {
     std::cout << "Hot reload system initialized successfully" << std::endl;
   }
 
-  // Initialize UI manager
-  if (!uiManager.initialize(window))
+  // Initialize UI manager. ImGui's extra viewport windows are drawn where
+  // the UI is built, which the render thread rules out.
+  if (!uiManager.initialize(window, !useRenderThread))
     return false;
 
   // Initialize scene manager
@@ -174,8 +360,13 @@ bool Application::initializeGame() {
     return false;
   }
 
-  // Pass audio manager reference to scene manager
+  // Pass audio and asset manager references to scene manager
   sceneManager.setAudioManager(&audioManager);
+  sceneManager.setAssetManager(&assetManager);
+
+  // Scenes are built on first use, this caps how many stay resident
+  sceneManager.setMaxResidentScenes(
+      settings.getSetting<size_t>("maxResidentScenes", 3));
 
   // Load default scene
   auto defaultScene = SceneManager::createDefaultScene("default");
@@ -184,7 +375,8 @@ bool Application::initializeGame() {
     return false;
   }
 
-  // Load example scenes from files (if they exist)
+  // Register example scenes from files (if they exist), they are only
+  // parsed and built when first needed
   sceneManager.loadSceneFromFile("level1",
                                  RESOURCES_PATH "scenes/level1.scene");
   sceneManager.loadSceneFromFile("level2",
@@ -204,6 +396,12 @@ bool Application::initializeGame() {
   hotReloadManager.registerAudio("collectible_pickup",
                                  RESOURCES_PATH "audio/collectible_pickup.mp3");
 
+  // Register the tile map shader for hot reloading
+  hotReloadManager.registerShader("tilemap_vertex",
+                                  GpuTileLayer::getVertexShaderPath());
+  hotReloadManager.registerShader("tilemap_fragment",
+                                  GpuTileLayer::getFragmentShaderPath());
+
   // Create a custom scene programmatically
   auto customScene = SceneManager::createDefaultScene("custom");
   customScene.name = "Custom Scene";
@@ -226,9 +424,30 @@ bool Application::initializeGame() {
   return true;
 }
 
-void Application::update(float deltaTime) {
+void Application::startRenderThread() {
+  // The window's context moves to the render thread; this thread keeps
+  // uploading textures and buffers through the loader window's
+  glfwMakeContextCurrent(loaderWindow);
+  if (!renderThread.start(window, &renderer, vsyncEnabled)) {
+    glfwMakeContextCurrent(window);
+    return;
+  }
+
+  snapshot.drawData.textureSorting = renderer.textureSorting;
+
+  // Scene unloads and reloads delete textures the frame being drawn may
+  // still use
+  sceneManager.setOnBeforeSceneUnloadCallback(
+      [this]() { renderThread.waitForIdle(); });
+  hotReloadManager.setOnBeforeReloadCallback(
+      [this]() { renderThread.waitForIdle(); });
+}
+
+void Application::update(float frameTime) {
+  PROFILE_SCOPE("Application::update");
   // Update FPS counter
-  fpsCounter.update(deltaTime);
+  fpsCounter.update(frameTime);
+  sceneManager.recordFrameTime(frameTime);
 
   // Update input
   inputManager->update();
@@ -239,10 +458,16 @@ void Application::update(float deltaTime) {
     return;
   }
 
-  // Update scene manager first
-  sceneManager.update(deltaTime);
+  // Update window size only if needed (cache previous values)
+  static int lastWindowWidth = 0, lastWindowHeight = 0;
+  glfwGetFramebufferSize(window, &windowWidth, &windowHeight);
+  if (windowWidth != lastWindowWidth || windowHeight != lastWindowHeight) {
+    sceneManager.updateScreenSize(windowWidth, windowHeight);
+    lastWindowWidth = windowWidth;
+    lastWindowHeight = windowHeight;
+  }
 
-  // Get current scene for input handling
+  // One-shot input is handled once per frame, not per simulation step
   Scene *currentScene = sceneManager.getCurrentScene();
   GameWorld *currentGameWorld =
       currentScene ? currentScene->getGameWorld() : nullptr;
@@ -256,50 +481,50 @@ void Application::update(float deltaTime) {
       sceneManager.restartCurrentScene();
     }
 
-    // Update window size only if needed (cache previous values)
-    static int lastWindowWidth = 0, lastWindowHeight = 0;
-    glfwGetFramebufferSize(window, &windowWidth, &windowHeight);
-    if (windowWidth != lastWindowWidth || windowHeight != lastWindowHeight) {
-      sceneManager.updateScreenSize(windowWidth, windowHeight);
-      lastWindowWidth = windowWidth;
-      lastWindowHeight = windowHeight;
-    }
-
     // Handle mouse input for pathfinding
     if (inputManager->isRightMouseJustPressed() && isGamePlaying) {
       currentGameWorld->handleMouseInput(inputManager->getMousePosition());
     }
+  }
 
-    // Only allow player movement if game is playing and not following a path
-    if (isGamePlaying) {
-      glm::vec2 movement = inputManager->getMovementInput();
-      // Only allow keyboard movement if not following a path
-      if (glm::length(movement) > 0.1f) {
-        // Cancel pathfinding if player uses keyboard
-        currentGameWorld->stopPathfinding();
-        currentGameWorld->updatePlayer(movement.x, movement.y, playerSpeed,
-                                       deltaTime);
-      }
-    }
-
-    currentGameWorld->updateCamera(deltaTime);
-
-    // Update pathfinding with actual player speed
-    if (isGamePlaying) {
-      currentGameWorld->updatePathfinding(deltaTime, playerSpeed);
-    }
+  // Advance the simulation in fixed steps. After a long stall only a few
+  // steps are caught up and the rest of the backlog is dropped, otherwise
+  // slow frames would keep making the next frame slower.
+  accumulator += std::min(static_cast<double>(frameTime), MAX_FRAME_TIME);
+
+  glm::vec2 movement = inputManager->getMovementInput();
+  int steps = 0;
+  while (accumulator >= FIXED_TIMESTEP && steps < MAX_CATCH_UP_STEPS) {
+    simulateStep(static_cast<float>(FIXED_TIMESTEP), movement);
+    accumulator -= FIXED_TIMESTEP;
+    steps++;
   }
+  if (accumulator >= FIXED_TIMESTEP) {
+    accumulator = std::fmod(accumulator, FIXED_TIMESTEP);
+  }
+
+  renderAlpha = static_cast<float>(accumulator / FIXED_TIMESTEP);
 }
 
-void Application::render() {
-  glViewport(0, 0, windowWidth, windowHeight);
-  glClear(GL_COLOR_BUFFER_BIT);
+void Application::simulateStep(float deltaTime, const glm::vec2 &movement) {
+  PROFILE_SCOPE("Simulation step");
+  // Player movement, camera and pathfinding run in the world's update with
+  // the rest of the step
+  Scene *currentScene = sceneManager.getCurrentScene();
+  GameWorld *currentGameWorld =
+      currentScene ? currentScene->getGameWorld() : nullptr;
+  if (currentGameWorld)
+    currentGameWorld->setPlayerInput(movement, playerSpeed);
+
+  sceneManager.update(deltaTime);
+}
 
+void Application::recordFrame(gl2d::Renderer2D &target) {
   // Begin UI frame
   uiManager.beginFrame();
 
   // Set up camera for following player
-  renderer.updateWindowMetrics(windowWidth, windowHeight);
+  target.updateWindowMetrics(windowWidth, windowHeight);
   gl2d::Camera camera;
 
   // Get current scene for rendering
@@ -308,31 +533,100 @@ void Application::render() {
       currentScene ? currentScene->getGameWorld() : nullptr;
 
   if (currentGameWorld) {
-    glm::vec2 cameraPos = currentGameWorld->getCameraPosition();
+    // Draw the world between the last two simulation steps
+    currentGameWorld->setRenderAlpha(renderAlpha);
+    glm::vec2 cameraPos = currentGameWorld->getRenderCameraPosition();
     camera.position = cameraPos;
-    renderer.setCamera(camera);
+    target.setCamera(camera);
 
     // Render current scene
-    sceneManager.render(&renderer);
-    renderer.flush();
+    sceneManager.render(&target);
 
     // Render UI using current game world, scene manager, and hot reload manager
     uiManager.renderGameUI(*currentGameWorld, fpsCounter, playerSpeed,
                            sceneManager, hotReloadManager);
+    uiManager.renderAssetMemoryWindow(assetManager);
+    uiManager.renderProfilerWindow();
+    uiManager.renderRenderStatsWindow(lastRenderStats);
+    uiManager.renderSystemScheduleWindow(*currentGameWorld);
   } else {
     // Fallback: render default camera
     camera.position = glm::vec2(0, 0);
-    renderer.setCamera(camera);
-    renderer.flush();
+    target.setCamera(camera);
 
     // Render UI with legacy game world as fallback
     uiManager.renderGameUI(gameWorld, fpsCounter, playerSpeed);
   }
+}
+
+void Application::render() {
+  PROFILE_SCOPE("Application::render");
+
+  // The UI is built before this frame's draws are flushed, so it shows the
+  // counters of the previous frame
+  lastRenderStats = renderer.stats;
+  renderer.resetStats();
+  glViewport(0, 0, windowWidth, windowHeight);
+  glClear(GL_COLOR_BUFFER_BIT);
+
+  recordFrame(renderer);
+  {
+    PROFILE_SCOPE("gl2d flush");
+    renderer.flush();
+  }
 
   // End UI frame
   uiManager.endFrame();
 }
 
+void Application::renderSynchronously() {
+  if (!renderThread.isRunning()) {
+    render();
+    glfwSwapBuffers(window);
+    return;
+  }
+
+  // Uploads made on the loader context have to be complete before the
+  // window's context uses them
+  GLsync uploadFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glFlush();
+
+  renderThread.pause();
+  glfwMakeContextCurrent(window);
+  glWaitSync(uploadFence, 0, GL_TIMEOUT_IGNORED);
+  glDeleteSync(uploadFence);
+
+  render();
+  glfwSwapBuffers(window);
+
+  glfwMakeContextCurrent(loaderWindow);
+  renderThread.resume();
+}
+
+void Application::renderThreaded() {
+  PROFILE_SCOPE("Application::renderThreaded");
+
+  // Counters of the last frame the render thread finished
+  lastRenderStats = renderThread.getLastStats();
+
+  // Holds the buffers of an already drawn frame
+  snapshot.clear();
+
+  recordFrame(snapshot.drawData);
+  // flush() ends a frame of the text layout cache, this renderer never
+  // flushes
+  snapshot.drawData.textLayoutCache.endFrame();
+  uiManager.endFrame(snapshot.ui);
+
+  snapshot.width = windowWidth;
+  snapshot.height = windowHeight;
+  snapshot.uploadFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glFlush(); // So the render thread's context can wait on the fence
+
+  PROFILE_SCOPE("Wait for render thread");
+  renderThread.submit(snapshot);
+}
+
 void Application::handleEvents() {
   // Additional event handling can be added here
   // For now, GLFW handles events through polling
@@ -0,0 +1,490 @@
+#include "AssetCache.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stb_image/stb_image.h>
+
+namespace {
+constexpr uint32_t BLOB_MAGIC = 0x58544643; // "CFTX"
+
+// Larger than any texture the GL drivers we run on accept, a blob claiming
+// more is corrupt
+constexpr int32_t MAX_BLOB_DIMENSION = 16384;
+
+template <typename T> void writeValue(std::ofstream &file, const T &value) {
+  file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> bool readValue(std::ifstream &file, T &value) {
+  file.read(reinterpret_cast<char *>(&value), sizeof(T));
+  return static_cast<bool>(file);
+}
+} // namespace
+
+AssetCache::AssetCache()
+    : m_initialized(false), m_compressionEnabled(false), m_hits(0),
+      m_misses(0), m_lastUploadSize(0) {}
+
+bool AssetCache::initialize(const std::string &cacheDirectory) {
+  m_cacheDirectory = cacheDirectory;
+  if (!m_cacheDirectory.empty() && m_cacheDirectory.back() != '/') {
+    m_cacheDirectory += '/';
+  }
+
+  try {
+    std::filesystem::create_directories(m_cacheDirectory);
+  } catch (const std::filesystem::filesystem_error &ex) {
+    std::cerr << "AssetCache: Failed to create cache directory '"
+              << m_cacheDirectory << "': " << ex.what() << std::endl;
+    m_initialized = false;
+    return false;
+  }
+
+  m_initialized = true;
+  std::cout << "AssetCache: Using cache directory '" << m_cacheDirectory
+            << "'." << std::endl;
+  return true;
+}
+
+bool AssetCache::loadTexture(const std::string &filepath, bool pixelated,
+                             bool useMipMaps, gl2d::Texture &outTexture,
+                             bool &cacheHit) {
+  cacheHit = false;
+  m_lastUploadSize = 0;
+
+  std::vector<unsigned char> sourceData;
+  if (!readFileBytes(filepath, sourceData)) {
+    std::cerr << "AssetCache: Could not read '" << filepath << "'."
+              << std::endl;
+    return false;
+  }
+
+  // Hashing the source is much cheaper than decoding it and guarantees the
+  // blob matches the file currently on disk.
+  uint64_t key = computeKey(sourceData, pixelated, useMipMaps);
+  std::string blobPath = getBlobPath(filepath, key);
+
+  TextureBlob blob;
+  if (m_initialized && readBlob(blobPath, key, useMipMaps, blob)) {
+    createTexture(blob, pixelated, useMipMaps, outTexture);
+    if (outTexture.id != 0) {
+      cacheHit = true;
+      m_hits++;
+      m_lastUploadSize = getBlobSize(blob);
+      return true;
+    }
+  }
+
+  m_misses++;
+
+  if (!decodeSource(sourceData, useMipMaps, blob)) {
+    std::cerr << "AssetCache: Failed to decode '" << filepath << "'."
+              << std::endl;
+    return false;
+  }
+
+  if (m_compressionEnabled) {
+    compressBlob(blob);
+  }
+
+  createTexture(blob, pixelated, useMipMaps, outTexture);
+  if (outTexture.id == 0) {
+    return false;
+  }
+  m_lastUploadSize = getBlobSize(blob);
+
+  if (m_initialized) {
+    removeStaleBlobs(filepath, blobPath);
+    if (!writeBlob(blobPath, key, blob)) {
+      std::cerr << "AssetCache: Failed to write cache blob '" << blobPath
+                << "'." << std::endl;
+    }
+  }
+
+  return true;
+}
+
+void AssetCache::clear() {
+  if (!m_initialized) {
+    return;
+  }
+
+  std::error_code ec;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(m_cacheDirectory, ec)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".ctex") {
+      std::filesystem::remove(entry.path(), ec);
+    }
+  }
+  std::cout << "AssetCache: Cleared texture cache." << std::endl;
+}
+
+uint64_t AssetCache::hashBytes(const void *data, size_t size, uint64_t seed) {
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+  uint64_t hash = seed;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+size_t AssetCache::computeTextureBytes(int width, int height,
+                                       bool withMipMaps) {
+  size_t total = 0;
+  int w = std::max(1, width);
+  int h = std::max(1, height);
+  while (true) {
+    total += (size_t)w * h * 4;
+    if (!withMipMaps || (w == 1 && h == 1)) {
+      break;
+    }
+    w = std::max(1, w / 2);
+    h = std::max(1, h / 2);
+  }
+  return total;
+}
+
+uint32_t AssetCache::getMipLevelCount(int width, int height) {
+  uint32_t count = 1;
+  while (width > 1 || height > 1) {
+    width = std::max(1, width / 2);
+    height = std::max(1, height / 2);
+    count++;
+  }
+  return count;
+}
+
+size_t AssetCache::getLevelSize(uint32_t glFormat, int width, int height) {
+  if (glFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) {
+    // 16 bytes per 4x4 block, partial blocks at the edges count as whole
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * 16;
+  }
+  return (size_t)width * height * 4;
+}
+
+size_t AssetCache::getBlobSize(const TextureBlob &blob) {
+  size_t total = 0;
+  for (const auto &level : blob.levels) {
+    total += level.size();
+  }
+  return total;
+}
+
+uint64_t AssetCache::computeKey(const std::vector<unsigned char> &sourceData,
+                                bool pixelated, bool useMipMaps) const {
+  uint64_t key = hashBytes(sourceData.data(), sourceData.size());
+
+  // Everything that changes the produced blob has to be part of the key
+  uint32_t settings[] = {CACHE_VERSION, pixelated ? 1u : 0u,
+                         useMipMaps ? 1u : 0u, m_compressionEnabled ? 1u : 0u};
+  return hashBytes(settings, sizeof(settings), key);
+}
+
+std::string AssetCache::getSourcePrefix(const std::string &filepath) const {
+  std::string normalized =
+      std::filesystem::path(filepath).lexically_normal().generic_string();
+  uint64_t pathHash = hashBytes(normalized.data(), normalized.size());
+
+  std::ostringstream prefix;
+  prefix << std::filesystem::path(filepath).stem().string() << "_" << std::hex
+         << pathHash << "_";
+  return prefix.str();
+}
+
+std::string AssetCache::getBlobPath(const std::string &filepath,
+                                    uint64_t key) const {
+  std::ostringstream path;
+  path << m_cacheDirectory << getSourcePrefix(filepath) << std::hex << key
+       << ".ctex";
+  return path.str();
+}
+
+bool AssetCache::readBlob(const std::string &blobPath, uint64_t key,
+                          bool useMipMaps, TextureBlob &blob) const {
+  std::ifstream file(blobPath, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  uint32_t magic = 0, version = 0, levelCount = 0;
+  uint64_t storedKey = 0;
+  int32_t width = 0, height = 0;
+  uint32_t glFormat = 0;
+
+  if (!readValue(file, magic) || !readValue(file, version) ||
+      !readValue(file, storedKey) || !readValue(file, width) ||
+      !readValue(file, height) || !readValue(file, glFormat) ||
+      !readValue(file, levelCount)) {
+    return false;
+  }
+
+  if (magic != BLOB_MAGIC || version != CACHE_VERSION || storedKey != key ||
+      width <= 0 || height <= 0 || width > MAX_BLOB_DIMENSION ||
+      height > MAX_BLOB_DIMENSION || levelCount == 0 || levelCount > 32) {
+    return false;
+  }
+
+  // Only what writeBlob produces; anything else is treated as a miss and
+  // rebuilt from the source
+  if (glFormat != 0 && glFormat != GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) {
+    return false;
+  }
+
+  // A partial chain would leave the texture incomplete for mipmapped
+  // sampling, so it has to be all of it (or level 0 alone without mips)
+  if (levelCount != (useMipMaps ? getMipLevelCount(width, height) : 1u)) {
+    return false;
+  }
+
+  blob.width = width;
+  blob.height = height;
+  blob.glFormat = glFormat;
+  blob.levels.resize(levelCount);
+
+  std::error_code ec;
+  uintmax_t fileSize = std::filesystem::file_size(blobPath, ec);
+  if (ec) {
+    return false;
+  }
+
+  // Every level must hold exactly the bytes its size and format call for
+  // (the upload reads that many no matter what the file contained) and fit
+  // in what is left of the file, so a truncated blob never allocates more
+  int w = width;
+  int h = height;
+  for (size_t i = 0; i < blob.levels.size(); i++) {
+    if (i > 0) {
+      w = std::max(1, w / 2);
+      h = std::max(1, h / 2);
+    }
+
+    uint32_t levelSize = 0;
+    if (!readValue(file, levelSize) ||
+        levelSize != getLevelSize(glFormat, w, h) ||
+        levelSize > fileSize - (uintmax_t)file.tellg()) {
+      return false;
+    }
+
+    auto &level = blob.levels[i];
+    level.resize(levelSize);
+    file.read(reinterpret_cast<char *>(level.data()), levelSize);
+    if (!file) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool AssetCache::writeBlob(const std::string &blobPath, uint64_t key,
+                           const TextureBlob &blob) const {
+  // Write to a temporary file first so a crash never leaves a truncated blob
+  // behind under a valid name.
+  std::string tempPath = blobPath + ".tmp";
+  {
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      return false;
+    }
+
+    writeValue(file, BLOB_MAGIC);
+    writeValue(file, CACHE_VERSION);
+    writeValue(file, key);
+    writeValue(file, static_cast<int32_t>(blob.width));
+    writeValue(file, static_cast<int32_t>(blob.height));
+    writeValue(file, blob.glFormat);
+    writeValue(file, static_cast<uint32_t>(blob.levels.size()));
+
+    for (const auto &level : blob.levels) {
+      writeValue(file, static_cast<uint32_t>(level.size()));
+      file.write(reinterpret_cast<const char *>(level.data()), level.size());
+    }
+
+    if (!file) {
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tempPath, blobPath, ec);
+  if (ec) {
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+  return true;
+}
+
+void AssetCache::removeStaleBlobs(const std::string &filepath,
+                                  const std::string &keepPath) const {
+  std::string prefix = getSourcePrefix(filepath);
+  std::string keepName = std::filesystem::path(keepPath).filename().string();
+
+  std::error_code ec;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(m_cacheDirectory, ec)) {
+    std::string name = entry.path().filename().string();
+    if (name != keepName && name.compare(0, prefix.size(), prefix) == 0) {
+      std::filesystem::remove(entry.path(), ec);
+    }
+  }
+}
+
+bool AssetCache::decodeSource(const std::vector<unsigned char> &sourceData,
+                              bool useMipMaps, TextureBlob &blob) const {
+  // Same orientation gl2d::Texture::loadFromFile uses
+  stbi_set_flip_vertically_on_load(true);
+
+  int width = 0, height = 0, channels = 0;
+  unsigned char *decoded =
+      stbi_load_from_memory(sourceData.data(), (int)sourceData.size(), &width,
+                            &height, &channels, 4);
+  if (!decoded) {
+    return false;
+  }
+
+  blob.width = width;
+  blob.height = height;
+  blob.glFormat = 0;
+  blob.levels.clear();
+  blob.levels.emplace_back(decoded, decoded + (size_t)width * height * 4);
+  stbi_image_free(decoded);
+
+  if (useMipMaps) {
+    buildMipChain(blob);
+  }
+  return true;
+}
+
+bool AssetCache::compressBlob(TextureBlob &blob) const {
+  if (!GLAD_GL_EXT_texture_compression_s3tc) {
+    return false;
+  }
+
+  // Let the driver do the encoding, then read the compressed levels back
+  GLuint tempTexture = 0;
+  glGenTextures(1, &tempTexture);
+  glBindTexture(GL_TEXTURE_2D, tempTexture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  std::vector<std::vector<unsigned char>> compressed(blob.levels.size());
+  bool success = true;
+  int w = blob.width;
+  int h = blob.height;
+
+  for (size_t i = 0; i < blob.levels.size() && success; i++) {
+    glTexImage2D(GL_TEXTURE_2D, (GLint)i, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, w,
+                 h, 0, GL_RGBA, GL_UNSIGNED_BYTE, blob.levels[i].data());
+
+    GLint isCompressed = 0, compressedSize = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, (GLint)i, GL_TEXTURE_COMPRESSED,
+                             &isCompressed);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, (GLint)i,
+                             GL_TEXTURE_COMPRESSED_IMAGE_SIZE,
+                             &compressedSize);
+
+    if (!isCompressed || compressedSize <= 0) {
+      success = false;
+      break;
+    }
+
+    compressed[i].resize(compressedSize);
+    glGetCompressedTexImage(GL_TEXTURE_2D, (GLint)i, compressed[i].data());
+
+    w = std::max(1, w / 2);
+    h = std::max(1, h / 2);
+  }
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glDeleteTextures(1, &tempTexture);
+
+  if (success) {
+    blob.levels = std::move(compressed);
+    blob.glFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+  }
+  return success;
+}
+
+void AssetCache::createTexture(const TextureBlob &blob, bool pixelated,
+                               bool useMipMaps,
+                               gl2d::Texture &outTexture) const {
+  std::vector<const unsigned char *> levels;
+  std::vector<int> levelSizes;
+  levels.reserve(blob.levels.size());
+  levelSizes.reserve(blob.levels.size());
+  for (const auto &level : blob.levels) {
+    levels.push_back(level.data());
+    levelSizes.push_back((int)level.size());
+  }
+
+  if (blob.glFormat == 0) {
+    outTexture.createFromMipChain(levels.data(), (int)levels.size(),
+                                  blob.width, blob.height, pixelated,
+                                  useMipMaps);
+  } else {
+    if (blob.glFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT &&
+        !GLAD_GL_EXT_texture_compression_s3tc) {
+      outTexture.id = 0;
+      return;
+    }
+    outTexture.createFromCompressedMipChain(
+        blob.glFormat, levels.data(), levelSizes.data(), (int)levels.size(),
+        blob.width, blob.height, pixelated, useMipMaps);
+  }
+}
+
+void AssetCache::buildMipChain(TextureBlob &blob) {
+  int w = blob.width;
+  int h = blob.height;
+
+  while (w > 1 || h > 1) {
+    int nextW = std::max(1, w / 2);
+    int nextH = std::max(1, h / 2);
+
+    const std::vector<unsigned char> &src = blob.levels.back();
+    std::vector<unsigned char> dst((size_t)nextW * nextH * 4);
+
+    // 2x2 box filter, clamping at the edge for odd sizes
+    for (int y = 0; y < nextH; y++) {
+      int y0 = std::min(y * 2, h - 1);
+      int y1 = std::min(y * 2 + 1, h - 1);
+      for (int x = 0; x < nextW; x++) {
+        int x0 = std::min(x * 2, w - 1);
+        int x1 = std::min(x * 2 + 1, w - 1);
+        for (int c = 0; c < 4; c++) {
+          int sum = src[((size_t)y0 * w + x0) * 4 + c] +
+                    src[((size_t)y0 * w + x1) * 4 + c] +
+                    src[((size_t)y1 * w + x0) * 4 + c] +
+                    src[((size_t)y1 * w + x1) * 4 + c];
+          dst[((size_t)y * nextW + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+        }
+      }
+    }
+
+    blob.levels.push_back(std::move(dst));
+    w = nextW;
+    h = nextH;
+  }
+}
+
+bool AssetCache::readFileBytes(const std::string &filepath,
+                               std::vector<unsigned char> &data) {
+  std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::streamsize size = file.tellg();
+  if (size <= 0) {
+    return false;
+  }
+  file.seekg(0, std::ios::beg);
+
+  data.resize((size_t)size);
+  file.read(reinterpret_cast<char *>(data.data()), size);
+  return static_cast<bool>(file);
+}
@@ -12,7 +12,7 @@
 #endif
 
 AssetManager::AssetManager()
-    : m_initialized(false), m_hotReloadEnabled(false) {}
+    : m_accessCounter(0), m_initialized(false), m_hotReloadEnabled(false) {}
 
 AssetManager::~AssetManager() { shutdown(); }
 
@@ -30,6 +30,9 @@ bool AssetManager::initialize() {
     m_initialized = true;
     std::cout << "AssetManager: Successfully initialized." << std::endl;
 
+    // The cache is optional, textures still load without it
+    m_textureCache.initialize(std::string(RESOURCES_PATH) + ".cache/textures/");
+
     // Auto-discover assets in the resources folder
     autoDiscoverAssets();
 
@@ -84,6 +87,7 @@ void AssetManager::unloadTexture(const std::string &name) {
 gl2d::Texture *AssetManager::getTexture(const std::string &name) {
   auto it = m_textures.find(name);
   if (it != m_textures.end()) {
+    touchAsset(name);
     return it->second.get();
   }
   return nullptr;
@@ -132,6 +136,12 @@ bool AssetManager::loadAudio(const std::string &name,
 
   registerAsset(name, filepath, AssetType::AUDIO);
 
+  // raudio keeps the whole decoded PCM buffer resident; sampleCount already
+  // accounts for every channel
+  size_t pcmBytes = (size_t)loadedSound.sampleCount *
+                    (loadedSound.stream.sampleSize / 8);
+  setAssetMemory(name, pcmBytes, 0);
+
   std::cout << "AssetManager: Successfully loaded audio '" << name << "' from '"
             << filepath << "'." << std::endl;
 
@@ -139,6 +149,8 @@ bool AssetManager::loadAudio(const std::string &name,
     m_loadCallback(name, AssetType::AUDIO, true);
   }
 
+  enforceMemoryBudget(AssetType::AUDIO, name);
+
   return true;
 }
 
@@ -181,6 +193,7 @@ void AssetManager::unloadScene(const std::string &name) {
 std::string *AssetManager::getSceneData(const std::string &name) {
   auto it = m_sceneData.find(name);
   if (it != m_sceneData.end()) {
+    touchAsset(name);
     return &it->second;
   }
   return nullptr;
@@ -216,6 +229,7 @@ void AssetManager::unloadFont(const std::string &name) {
 gl2d::Font *AssetManager::getFont(const std::string &name) {
   auto it = m_fonts.find(name);
   if (it != m_fonts.end()) {
+    touchAsset(name);
     return it->second.get();
   }
   return nullptr;
@@ -225,6 +239,31 @@ bool AssetManager::isFontLoaded(const std::string &name) const {
   return m_fonts.find(name) != m_fonts.end();
 }
 
+bool AssetManager::loadDefaultFont() {
+  if (isFontLoaded(DEFAULT_FONT)) {
+    return true;
+  }
+
+  const char *candidates[] = {
+      RESOURCES_PATH "fonts/default.ttf",
+      "C:/Windows/Fonts/arial.ttf",
+      "/System/Library/Fonts/Supplemental/Arial.ttf",
+      "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+      "/usr/share/fonts/TTF/DejaVuSans.ttf",
+      "/usr/share/fonts/dejavu/DejaVuSans.ttf",
+  };
+
+  for (const char *path : candidates) {
+    if (fileExists(path) && loadFont(DEFAULT_FONT, path)) {
+      return true;
+    }
+  }
+
+  std::cerr << "AssetManager: No default font found, text will not be drawn."
+            << std::endl;
+  return false;
+}
+
 // Batch Operations
 bool AssetManager::loadAssetsFromDirectory(const std::string &directory,
                                            AssetType type, bool recursive) {
@@ -369,6 +408,12 @@ void AssetManager::autoDiscoverAssets() {
   std::cout << "AssetManager: Found " << audioFiles.size() << " audio files."
             << std::endl;
 
+  // Scan for font files
+  auto fontFiles =
+      scanForAssets(resourcesPath + "fonts/", AssetType::FONT, true);
+  std::cout << "AssetManager: Found " << fontFiles.size() << " font files."
+            << std::endl;
+
   // Scan for scene files
   auto sceneFiles =
       scanForAssets(resourcesPath + "scenes/", AssetType::SCENE, true);
@@ -378,17 +423,22 @@ void AssetManager::autoDiscoverAssets() {
   // Register all discovered assets but don't load them yet
   for (const auto &texturePath : textures) {
     std::string name = std::filesystem::path(texturePath).stem().string();
-    registerAsset(name, texturePath, AssetType::TEXTURE);
+    registerAsset(name, texturePath, AssetType::TEXTURE, false);
   }
 
   for (const auto &audioPath : audioFiles) {
     std::string name = std::filesystem::path(audioPath).stem().string();
-    registerAsset(name, audioPath, AssetType::AUDIO);
+    registerAsset(name, audioPath, AssetType::AUDIO, false);
   }
 
   for (const auto &scenePath : sceneFiles) {
     std::string name = std::filesystem::path(scenePath).stem().string();
-    registerAsset(name, scenePath, AssetType::SCENE);
+    registerAsset(name, scenePath, AssetType::SCENE, false);
+  }
+
+  for (const auto &fontPath : fontFiles) {
+    std::string name = std::filesystem::path(fontPath).stem().string();
+    registerAsset(name, fontPath, AssetType::FONT, false);
   }
 }
 
@@ -415,10 +465,34 @@ AssetManager::getAssetsByType(AssetType type) const {
 }
 
 size_t AssetManager::getTotalMemoryUsage() const {
+  return getCpuMemoryUsage() + getGpuMemoryUsage();
+}
+
+size_t AssetManager::getCpuMemoryUsage() const {
+  size_t total = 0;
+  for (const auto &pair : m_assetRegistry) {
+    if (pair.second.isLoaded) {
+      total += pair.second.cpuBytes;
+    }
+  }
+  return total;
+}
+
+size_t AssetManager::getGpuMemoryUsage() const {
   size_t total = 0;
   for (const auto &pair : m_assetRegistry) {
     if (pair.second.isLoaded) {
-      total += pair.second.size;
+      total += pair.second.gpuBytes;
+    }
+  }
+  return total;
+}
+
+size_t AssetManager::getMemoryUsageByType(AssetType type) const {
+  size_t total = 0;
+  for (const auto &pair : m_assetRegistry) {
+    if (pair.second.isLoaded && pair.second.type == type) {
+      total += pair.second.cpuBytes + pair.second.gpuBytes;
     }
   }
   return total;
@@ -473,6 +547,78 @@ void AssetManager::setAssetLoadCallback(AssetLoadCallback callback) {
   m_loadCallback = callback;
 }
 
+// Memory Budgets
+void AssetManager::setMemoryBudget(AssetType type, size_t bytes) {
+  m_memoryBudgets[type] = bytes;
+}
+
+size_t AssetManager::getMemoryBudget(AssetType type) const {
+  auto it = m_memoryBudgets.find(type);
+  return it != m_memoryBudgets.end() ? it->second : 0;
+}
+
+void AssetManager::setBudgetExceededCallback(BudgetExceededCallback callback) {
+  m_budgetCallback = callback;
+}
+
+size_t AssetManager::evictLeastRecentlyUsed(AssetType type, size_t targetBytes,
+                                            const std::string &keepAsset) {
+  std::vector<const AssetInfo *> candidates;
+  for (const auto &pair : m_assetRegistry) {
+    if (pair.second.isLoaded && pair.second.type == type &&
+        pair.second.pinCount == 0 && pair.first != keepAsset) {
+      candidates.push_back(&pair.second);
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const AssetInfo *a, const AssetInfo *b) {
+              return a->lastUsed < b->lastUsed;
+            });
+
+  // Copy the names, candidates point into the registry
+  std::vector<std::string> names;
+  for (const AssetInfo *info : candidates) {
+    names.push_back(info->name);
+  }
+
+  size_t used = getMemoryUsageByType(type);
+  size_t freed = 0;
+  for (const std::string &name : names) {
+    if (used <= targetBytes) {
+      break;
+    }
+
+    const AssetInfo &info = m_assetRegistry[name];
+    size_t assetBytes = info.cpuBytes + info.gpuBytes;
+    evictAsset(name);
+
+    used -= std::min(used, assetBytes);
+    freed += assetBytes;
+  }
+
+  return freed;
+}
+
+void AssetManager::pinAsset(const std::string &name) {
+  auto it = m_assetRegistry.find(name);
+  if (it != m_assetRegistry.end()) {
+    it->second.pinCount++;
+  }
+}
+
+void AssetManager::unpinAsset(const std::string &name) {
+  auto it = m_assetRegistry.find(name);
+  if (it != m_assetRegistry.end() && it->second.pinCount > 0) {
+    it->second.pinCount--;
+  }
+}
+
+bool AssetManager::isAssetPinned(const std::string &name) const {
+  auto it = m_assetRegistry.find(name);
+  return it != m_assetRegistry.end() && it->second.pinCount > 0;
+}
+
 // Hot Reload Support
 bool AssetManager::reloadAsset(const std::string &name) {
   auto it = m_assetRegistry.find(name);
@@ -606,9 +752,14 @@ bool AssetManager::loadTextureInternal(const std::string &name,
     return false;
   }
 
-  // Create and load texture
+  // Create the texture, skipping the decode when the cache has a blob for
+  // this exact file content and settings
   auto texture = std::make_unique<gl2d::Texture>();
-  texture->loadFromFile(filepath.c_str(), pixelated, useMipMaps);
+  bool cacheHit = false;
+  if (!m_textureCache.loadTexture(filepath, pixelated, useMipMaps, *texture,
+                                  cacheHit)) {
+    texture->loadFromFile(filepath.c_str(), pixelated, useMipMaps);
+  }
 
   if (texture->id == 0) {
     std::cerr << "AssetManager: Failed to load texture '" << name << "' from '"
@@ -620,14 +771,29 @@ bool AssetManager::loadTextureInternal(const std::string &name,
   m_textures[name] = std::move(texture);
 
   registerAsset(name, filepath, AssetType::TEXTURE);
+  m_assetRegistry[name].cacheStatus =
+      cacheHit ? CacheStatus::HIT : CacheStatus::MISS;
+
+  // Decoded pixels are freed after upload, so a texture only costs VRAM.
+  // gl2d generates a full mip chain when it decodes the file itself.
+  size_t gpuBytes = m_textureCache.getLastUploadSize();
+  if (gpuBytes == 0) {
+    glm::ivec2 textureSize = m_textures[name]->GetSize();
+    gpuBytes =
+        AssetCache::computeTextureBytes(textureSize.x, textureSize.y, true);
+  }
+  setAssetMemory(name, 0, gpuBytes);
 
   std::cout << "AssetManager: Successfully loaded texture '" << name
-            << "' from '" << filepath << "'." << std::endl;
+            << "' from '" << filepath << "' (cache "
+            << (cacheHit ? "hit" : "miss") << ")." << std::endl;
 
   if (m_loadCallback) {
     m_loadCallback(name, AssetType::TEXTURE, true);
   }
 
+  enforceMemoryBudget(AssetType::TEXTURE, name);
+
   return true;
 }
 
@@ -652,6 +818,7 @@ bool AssetManager::loadSceneInternal(const std::string &name,
   m_sceneData[name] = sceneContent;
 
   registerAsset(name, filepath, AssetType::SCENE);
+  setAssetMemory(name, m_sceneData[name].capacity(), 0);
 
   std::cout << "AssetManager: Successfully loaded scene '" << name << "' from '"
             << filepath << "'." << std::endl;
@@ -660,6 +827,8 @@ bool AssetManager::loadSceneInternal(const std::string &name,
     m_loadCallback(name, AssetType::SCENE, true);
   }
 
+  enforceMemoryBudget(AssetType::SCENE, name);
+
   return true;
 }
 
@@ -694,6 +863,14 @@ bool AssetManager::loadFontInternal(const std::string &name,
 
   registerAsset(name, filepath, AssetType::FONT);
 
+  // The glyph atlas is uploaded as RGBA with mipmaps, the packed glyph table
+  // stays on the CPU
+  const gl2d::Font &loadedFont = *m_fonts[name];
+  setAssetMemory(
+      name, loadedFont.packedCharsBufferSize * sizeof(stbtt_packedchar),
+      AssetCache::computeTextureBytes(loadedFont.size.x, loadedFont.size.y,
+                                      true));
+
   std::cout << "AssetManager: Successfully loaded font '" << name << "' from '"
             << filepath << "'." << std::endl;
 
@@ -701,6 +878,8 @@ bool AssetManager::loadFontInternal(const std::string &name,
     m_loadCallback(name, AssetType::FONT, true);
   }
 
+  enforceMemoryBudget(AssetType::FONT, name);
+
   return true;
 }
 
@@ -727,13 +906,23 @@ size_t AssetManager::getFileSize(const std::string &filepath) const {
 }
 
 void AssetManager::registerAsset(const std::string &name,
-                                 const std::string &filepath, AssetType type) {
+                                 const std::string &filepath, AssetType type,
+                                 bool loaded) {
+  // Reloading an asset keeps the pins its holders took
+  int pinCount = 0;
+  auto existing = m_assetRegistry.find(name);
+  if (existing != m_assetRegistry.end()) {
+    pinCount = existing->second.pinCount;
+  }
+
   AssetInfo info;
   info.name = name;
   info.filepath = filepath;
   info.type = type;
   info.size = getFileSize(filepath);
-  info.isLoaded = true;
+  info.isLoaded = loaded;
+  info.lastUsed = loaded ? ++m_accessCounter : 0;
+  info.pinCount = pinCount;
 
   m_assetRegistry[name] = info;
 }
@@ -742,6 +931,88 @@ void AssetManager::unregisterAsset(const std::string &name) {
   m_assetRegistry.erase(name);
 }
 
+void AssetManager::evictAsset(const std::string &name) {
+  auto it = m_assetRegistry.find(name);
+  if (it == m_assetRegistry.end()) {
+    return;
+  }
+
+  switch (it->second.type) {
+  case AssetType::TEXTURE: {
+    auto texture = m_textures.find(name);
+    if (texture != m_textures.end()) {
+      texture->second->cleanup();
+      m_textures.erase(texture);
+    }
+    break;
+  }
+  case AssetType::AUDIO: {
+    auto sound = m_audioAssets.find(name);
+    if (sound != m_audioAssets.end()) {
+      UnloadSound(*(sound->second));
+      m_audioAssets.erase(sound);
+    }
+    break;
+  }
+  case AssetType::SCENE:
+    m_sceneData.erase(name);
+    break;
+  case AssetType::FONT: {
+    auto font = m_fonts.find(name);
+    if (font != m_fonts.end()) {
+      font->second->cleanup();
+      m_fonts.erase(font);
+    }
+    break;
+  }
+  }
+
+  AssetInfo &info = it->second;
+  info.isLoaded = false;
+  info.cpuBytes = 0;
+  info.gpuBytes = 0;
+  info.cacheStatus = CacheStatus::NOT_CACHED;
+  std::cout << "AssetManager: Evicted " << getAssetTypeString(info.type)
+            << " '" << name << "'." << std::endl;
+}
+
+void AssetManager::setAssetMemory(const std::string &name, size_t cpuBytes,
+                                  size_t gpuBytes) {
+  auto it = m_assetRegistry.find(name);
+  if (it != m_assetRegistry.end()) {
+    it->second.cpuBytes = cpuBytes;
+    it->second.gpuBytes = gpuBytes;
+  }
+}
+
+void AssetManager::touchAsset(const std::string &name) {
+  auto it = m_assetRegistry.find(name);
+  if (it != m_assetRegistry.end()) {
+    it->second.lastUsed = ++m_accessCounter;
+  }
+}
+
+void AssetManager::enforceMemoryBudget(AssetType type,
+                                       const std::string &loadedAsset) {
+  size_t budget = getMemoryBudget(type);
+  if (budget == 0) {
+    return;
+  }
+
+  size_t used = getMemoryUsageByType(type);
+  if (used <= budget) {
+    return;
+  }
+
+  std::cerr << "AssetManager: " << getAssetTypeString(type)
+            << " memory budget exceeded after loading '" << loadedAsset
+            << "' (" << used << " / " << budget << " bytes)." << std::endl;
+
+  if (m_budgetCallback) {
+    m_budgetCallback(type, loadedAsset, used, budget);
+  }
+}
+
 void AssetManager::scanDirectoryRecursive(const std::string &directory,
                                           AssetType type,
                                           std::vector<std::string> &results) {
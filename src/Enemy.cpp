@@ -7,7 +7,7 @@ Enemy::Enemy(float x, float y, MovementPattern pattern)
                  ObjectType::OBSTACLE, false),
       movementPattern(pattern), movementSpeed(100.0f), time(0.0f),
       originalPosition(x, y), movementRange(100.0f), movingToB(false),
-      circleRadius(50.0f) {
+      circleRadius(50.0f), hasMovementLimits(false), legRemaining(-1.0f) {
   // Set default movement patterns based on type
   switch (pattern) {
   case MovementPattern::HORIZONTAL:
@@ -48,6 +48,31 @@ void Enemy::setPatrolMovement(glm::vec2 pointA, glm::vec2 pointB) {
   patrolPointA = pointA;
   patrolPointB = pointB;
   movingToB = true;
+  legRemaining = -1.0f;
+}
+
+void Enemy::setMovementLimits(const Rectangle &limits) {
+  movementLimits = limits;
+  hasMovementLimits = true;
+}
+
+glm::vec2 Enemy::getPatrolTarget(const glm::vec2 &point) const {
+  if (!hasMovementLimits)
+    return point;
+
+  // Clamping the position after every step would leave the enemy pushing
+  // against the edge forever, a point it can reach turns it around
+  glm::vec2 low(movementLimits.x, movementLimits.y);
+  glm::vec2 high(movementLimits.x + movementLimits.width - bounds.width,
+                 movementLimits.y + movementLimits.height - bounds.height);
+  return glm::clamp(point, low, glm::max(low, high));
+}
+
+glm::vec2 Enemy::getLegPosition() const {
+  float length = glm::length(legStart - legTarget);
+  if (length <= 0.0f)
+    return legTarget;
+  return legTarget + (legStart - legTarget) * (legRemaining / length);
 }
 
 void Enemy::update(float deltaTime) {
@@ -75,24 +100,91 @@ void Enemy::update(float deltaTime) {
   }
 
   case MovementPattern::PATROL: {
-    glm::vec2 currentPos(bounds.x, bounds.y);
-    glm::vec2 target = movingToB ? patrolPointB : patrolPointA;
+    const glm::vec2 pointA = getPatrolTarget(patrolPointA);
+    const glm::vec2 pointB = getPatrolTarget(patrolPointB);
+    float moveDistance = movementSpeed * deltaTime;
+
+    // Whole laps don't change anything
+    float lap = 2.0f * glm::length(pointB - pointA);
+    if (lap > 0.0f && moveDistance >= lap) {
+      moveDistance = std::fmod(moveDistance, lap);
+    }
 
-    glm::vec2 direction = target - currentPos;
-    float distance = glm::length(direction);
+    // A step longer than the way to the target turns there and spends the
+    // rest going back; at most a lap is left, so three legs cover it
+    for (int leg = 0; leg < 3; leg++) {
+      glm::vec2 currentPos(bounds.x, bounds.y);
+      glm::vec2 target = movingToB ? pointB : pointA;
+
+      // New leg, or the enemy was moved or its target changed since
+      if (legRemaining < 0.0f || target != legTarget ||
+          currentPos != getLegPosition()) {
+        legStart = currentPos;
+        legTarget = target;
+        legRemaining = glm::length(target - currentPos);
+      }
+
+      if (moveDistance < legRemaining) {
+        // Move towards target
+        legRemaining -= moveDistance;
+        glm::vec2 position = getLegPosition();
+        bounds.x = position.x;
+        bounds.y = position.y;
+        break;
+      }
 
-    if (distance < 5.0f) {
       // Switch direction when reaching target
+      bounds.x = target.x;
+      bounds.y = target.y;
+      moveDistance -= legRemaining;
+      legRemaining = -1.0f;
       movingToB = !movingToB;
-    } else {
-      // Move towards target
-      glm::vec2 normalizedDirection = glm::normalize(direction);
-      float moveDistance = movementSpeed * deltaTime;
-
-      bounds.x += normalizedDirection.x * moveDistance;
-      bounds.y += normalizedDirection.y * moveDistance;
+      if (moveDistance <= 0.0f)
+        break;
     }
     break;
   }
   }
-}
\ No newline at end of file
+}
+
+Rectangle Enemy::getMovementBounds() const {
+  glm::vec2 low(bounds.x, bounds.y);
+  glm::vec2 high = low;
+
+  switch (movementPattern) {
+  case MovementPattern::HORIZONTAL: {
+    float half = std::abs(movementRange) / 2.0f;
+    low.x = std::min(low.x, originalPosition.x - half);
+    high.x = std::max(high.x, originalPosition.x + half);
+    break;
+  }
+
+  case MovementPattern::VERTICAL: {
+    float half = std::abs(movementRange) / 2.0f;
+    low.y = std::min(low.y, originalPosition.y - half);
+    high.y = std::max(high.y, originalPosition.y + half);
+    break;
+  }
+
+  case MovementPattern::CIRCULAR: {
+    glm::vec2 corner = circleCenter - glm::vec2(bounds.width, bounds.height) /
+                                          2.0f;
+    glm::vec2 radius(std::abs(circleRadius));
+    low = glm::min(low, corner - radius);
+    high = glm::max(high, corner + radius);
+    break;
+  }
+
+  case MovementPattern::PATROL: {
+    // Straight lines between the current position and the two points
+    const glm::vec2 pointA = getPatrolTarget(patrolPointA);
+    const glm::vec2 pointB = getPatrolTarget(patrolPointB);
+    low = glm::min(low, glm::min(pointA, pointB));
+    high = glm::max(high, glm::max(pointA, pointB));
+    break;
+  }
+  }
+
+  return Rectangle(low.x, low.y, high.x - low.x + bounds.width,
+                   high.y - low.y + bounds.height);
+}
@@ -1,17 +1,40 @@
 #include "FPSCounter.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
 
 FPSCounter::FPSCounter(float updateInterval)
     : fps(0.0f), fpsUpdateTimer(0.0f), fpsUpdateInterval(updateInterval),
-      frameCount(0) {}
+      frameCount(0), frameTimes(), nextFrame(0), storedFrames(0),
+      hitchThresholdMs(1000.0f / 30.0f), hitchCount(0), lastHitchMs(0.0f),
+      dumping(false) {}
 
 void FPSCounter::update(float deltaTime) {
   fpsUpdateTimer += deltaTime;
   frameCount++;
 
+  float frameMs = deltaTime * 1000.0f;
+  frameTimes[nextFrame] = frameMs;
+  nextFrame = (nextFrame + 1) % HISTORY_SIZE;
+  storedFrames = std::min(storedFrames + 1, HISTORY_SIZE);
+
+  if (frameMs > hitchThresholdMs) {
+    hitchCount++;
+    lastHitchMs = frameMs;
+  }
+
+  if (dumping) {
+    dumpFrames.push_back(frameMs);
+  }
+
   if (fpsUpdateTimer >= fpsUpdateInterval) {
     fps = (fpsUpdateTimer > 0.0f) ? frameCount / fpsUpdateTimer : 0.0f;
     fpsUpdateTimer = 0.0f;
     frameCount = 0;
+
+    // The ring buffer order doesn't matter for the statistics
+    stats = computeStats(frameTimes, storedFrames, sortScratch);
   }
 }
 
@@ -19,4 +42,99 @@ void FPSCounter::reset() {
   fps = 0.0f;
   fpsUpdateTimer = 0.0f;
   frameCount = 0;
-}
\ No newline at end of file
+  nextFrame = 0;
+  storedFrames = 0;
+  stats = FrameStats();
+  hitchCount = 0;
+  lastHitchMs = 0.0f;
+}
+
+FPSCounter::FrameStats FPSCounter::computeStats(const float *values,
+                                                size_t count,
+                                                std::vector<float> &scratch) {
+  FrameStats result;
+  if (count == 0)
+    return result;
+
+  scratch.assign(values, values + count);
+  std::sort(scratch.begin(), scratch.end());
+
+  // Nearest-rank percentile
+  auto percentile = [&](float p) {
+    size_t rank = static_cast<size_t>(std::ceil(p * count));
+    return scratch[std::min(std::max<size_t>(rank, 1), count) - 1];
+  };
+
+  double total = 0.0;
+  for (float value : scratch) {
+    total += value;
+  }
+
+  result.averageMs = static_cast<float>(total / count);
+  result.p50Ms = percentile(0.50f);
+  result.p95Ms = percentile(0.95f);
+  result.p99Ms = percentile(0.99f);
+  result.maxMs = scratch.back();
+  result.samples = count;
+  return result;
+}
+
+void FPSCounter::startDump(const std::string &path) {
+  dumpPath = path;
+  dumpFrames.clear();
+  dumping = true;
+  std::cout << "FPSCounter: recording frame times to " << path << std::endl;
+}
+
+bool FPSCounter::stopDump() {
+  if (!dumping)
+    return false;
+  dumping = false;
+
+  std::ofstream file(dumpPath);
+  if (!file.is_open()) {
+    std::cerr << "FPSCounter: failed to open " << dumpPath << std::endl;
+    return false;
+  }
+
+  std::vector<float> scratch;
+  FrameStats summary =
+      computeStats(dumpFrames.data(), dumpFrames.size(), scratch);
+  size_t hitches = std::count_if(
+      dumpFrames.begin(), dumpFrames.end(),
+      [this](float frameMs) { return frameMs > hitchThresholdMs; });
+
+  bool json = dumpPath.size() >= 5 &&
+              dumpPath.compare(dumpPath.size() - 5, 5, ".json") == 0;
+  if (json) {
+    file << "{\n  \"summary\": {\"frames\": " << summary.samples
+         << ", \"average_ms\": " << summary.averageMs
+         << ", \"p50_ms\": " << summary.p50Ms
+         << ", \"p95_ms\": " << summary.p95Ms
+         << ", \"p99_ms\": " << summary.p99Ms
+         << ", \"max_ms\": " << summary.maxMs
+         << ", \"hitch_threshold_ms\": " << hitchThresholdMs
+         << ", \"hitches\": " << hitches << "},\n  \"frame_ms\": [";
+    for (size_t i = 0; i < dumpFrames.size(); i++) {
+      file << (i == 0 ? "" : ", ") << dumpFrames[i];
+    }
+    file << "]\n}\n";
+  } else {
+    file << "frame,frame_ms,hitch\n";
+    for (size_t i = 0; i < dumpFrames.size(); i++) {
+      file << i << "," << dumpFrames[i] << ","
+           << (dumpFrames[i] > hitchThresholdMs ? 1 : 0) << "\n";
+    }
+  }
+
+  if (!file.good()) {
+    std::cerr << "FPSCounter: failed to write " << dumpPath << std::endl;
+    return false;
+  }
+
+  std::cout << "FPSCounter: wrote " << summary.samples << " frames to "
+            << dumpPath << " (p50 " << summary.p50Ms << " ms, p99 "
+            << summary.p99Ms << " ms, max " << summary.maxMs << " ms, "
+            << hitches << " hitches)" << std::endl;
+  return true;
+}
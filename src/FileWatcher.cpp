@@ -4,8 +4,30 @@
 #include <filesystem>
 #include <iostream>
 
-
-FileWatcher::FileWatcher() : isRunning(false), application(nullptr) {}
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace {
+// Watching the directory rather than the file also catches editors that
+// save by writing a temporary file and renaming it over the original.
+// IN_MOVE_SELF is there to notice the directory itself being moved away.
+constexpr uint32_t DIRECTORY_WATCH_MASK = IN_CLOSE_WRITE | IN_MODIFY |
+                                          IN_MOVED_TO | IN_CREATE |
+                                          IN_ATTRIB | IN_MOVE_SELF;
+} // namespace
+#endif
+
+FileWatcher::FileWatcher()
+    : isRunning(false), pollIntervalMs(POLL_INTERVAL_MS),
+      backend(Backend::POLLING),
+#ifdef __linux__
+      inotifyFd(-1), wakeupPipe{-1, -1},
+#endif
+      application(nullptr) {
+}
 
 FileWatcher::~FileWatcher() { shutdown(); }
 
@@ -16,29 +38,38 @@ bool FileWatcher::initialize(Application *app) {
   }
 
   application = app;
-  isRunning = true;
+
+#ifdef __linux__
+  if (initializeInotify()) {
+    backend = Backend::INOTIFY;
+  } else {
+    std::cerr << "FileWatcher: inotify unavailable, falling back to polling"
+              << std::endl;
+    backend = Backend::POLLING;
+  }
+#endif
 
   // Start the watcher thread
-  watcherThread = std::thread(&FileWatcher::watcherLoop, this);
+  startThread();
 
-  std::cout << "FileWatcher: Initialized and started monitoring" << std::endl;
+  std::cout << "FileWatcher: Initialized and started monitoring ("
+            << getBackendName() << " backend)" << std::endl;
   return true;
 }
 
 void FileWatcher::shutdown() {
   if (isRunning.load()) {
-    isRunning = false;
-
-    // Wait for thread to finish
-    if (watcherThread.joinable()) {
-      watcherThread.join();
-    }
+    stopThread();
 
     clearAllWatches();
     application = nullptr;
 
     std::cout << "FileWatcher: Shutdown complete" << std::endl;
   }
+
+#ifdef __linux__
+  shutdownInotify();
+#endif
 }
 
 void FileWatcher::watchFile(
@@ -60,6 +91,12 @@ void FileWatcher::watchFile(
   watchedFiles[path] = WatchedFile(path, type, reloadCallback);
   watchedFiles[path].lastModified = modTime;
 
+#ifdef __linux__
+  if (backend == Backend::INOTIFY) {
+    addDirectoryWatch(path);
+  }
+#endif
+
   std::cout << "FileWatcher: Now watching " << path << std::endl;
 }
 
@@ -69,48 +106,75 @@ void FileWatcher::unwatchFile(const std::string &path) {
   auto it = watchedFiles.find(path);
   if (it != watchedFiles.end()) {
     watchedFiles.erase(it);
+    pendingChanges.erase(path);
+
+#ifdef __linux__
+    if (backend == Backend::INOTIFY) {
+      removeDirectoryWatch(path);
+    }
+#endif
+
     std::cout << "FileWatcher: Stopped watching " << path << std::endl;
   }
 }
 
 void FileWatcher::clearAllWatches() {
   std::lock_guard<std::mutex> lock(filesMutex);
+
+#ifdef __linux__
+  if (inotifyFd >= 0) {
+    for (const auto &[descriptor, _] : directoryWatches) {
+      inotify_rm_watch(inotifyFd, descriptor);
+    }
+  }
+  directoryWatches.clear();
+  directoryDescriptors.clear();
+  lostDirectories.clear();
+#endif
+
   watchedFiles.clear();
+  pendingChanges.clear();
   std::cout << "FileWatcher: Cleared all watches" << std::endl;
 }
 
 void FileWatcher::checkForUpdates() {
-  std::lock_guard<std::mutex> lock(filesMutex);
-
-  for (auto &[path, watchedFile] : watchedFiles) {
-    if (!fileExists(path)) {
-      std::cout << "FileWatcher: File no longer exists: " << path << std::endl;
-      continue;
-    }
-
-    auto currentModTime = getFileModificationTime(path);
-    if (currentModTime > watchedFile.lastModified) {
-      std::cout << "FileWatcher: Detected change in " << path << std::endl;
-      processFileChange(path, watchedFile);
-      watchedFile.lastModified = currentModTime;
+  pollFiles();
+
+  // A manual check should not wait for the debounce window
+  {
+    std::lock_guard<std::mutex> lock(filesMutex);
+    auto now = std::chrono::steady_clock::now();
+    for (auto &[path, deadline] : pendingChanges) {
+      deadline = now;
     }
   }
+  dispatchReadyChanges();
 }
 
 void FileWatcher::setEnabled(bool enabled) {
   if (enabled && !isRunning.load()) {
-    isRunning = true;
-    watcherThread = std::thread(&FileWatcher::watcherLoop, this);
+    startThread();
     std::cout << "FileWatcher: Enabled" << std::endl;
   } else if (!enabled && isRunning.load()) {
-    isRunning = false;
-    if (watcherThread.joinable()) {
-      watcherThread.join();
-    }
+    stopThread();
     std::cout << "FileWatcher: Disabled" << std::endl;
   }
 }
 
+const char *FileWatcher::getBackendName() const {
+  switch (backend) {
+  case Backend::INOTIFY:
+    return "inotify";
+  case Backend::POLLING:
+  default:
+    return "polling";
+  }
+}
+
+void FileWatcher::setPollInterval(int milliseconds) {
+  pollIntervalMs = std::max(10, milliseconds);
+}
+
 size_t FileWatcher::getWatchedFileCount() const {
   std::lock_guard<std::mutex> lock(filesMutex);
   return watchedFiles.size();
@@ -130,11 +194,293 @@ std::vector<std::string> FileWatcher::getWatchedFiles() const {
 
 void FileWatcher::watcherLoop() {
   while (isRunning.load()) {
-    checkForUpdates();
-    std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+#ifdef __linux__
+    if (backend == Backend::INOTIFY) {
+      pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeupPipe[0], POLLIN, 0}};
+
+      // Sleep until something happens, the next debounce deadline or the
+      // next attempt to re-watch a lost directory
+      int timeoutMs = getMillisecondsUntilNextDispatch();
+      {
+        std::lock_guard<std::mutex> lock(filesMutex);
+        if (!lostDirectories.empty() &&
+            (timeoutMs < 0 || timeoutMs > LOST_DIRECTORY_RETRY_MS)) {
+          timeoutMs = LOST_DIRECTORY_RETRY_MS;
+        }
+      }
+
+      int ready = poll(fds, 2, timeoutMs);
+      if (ready > 0) {
+        if (fds[1].revents & POLLIN) {
+          char drain[64];
+          while (read(wakeupPipe[0], drain, sizeof(drain)) > 0) {
+          }
+        }
+        if (fds[0].revents & POLLIN) {
+          readInotifyEvents();
+        }
+      } else if (ready == 0) {
+        retryLostDirectories();
+      }
+
+      dispatchReadyChanges();
+      continue;
+    }
+#endif
+
+    pollFiles();
+    dispatchReadyChanges();
+
+    int waitMs = pollIntervalMs.load();
+    int untilDispatch = getMillisecondsUntilNextDispatch();
+    if (untilDispatch >= 0) {
+      waitMs = std::min(waitMs, untilDispatch);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(waitMs));
+  }
+}
+
+void FileWatcher::startThread() {
+  isRunning = true;
+  watcherThread = std::thread(&FileWatcher::watcherLoop, this);
+}
+
+void FileWatcher::stopThread() {
+  isRunning = false;
+
+#ifdef __linux__
+  if (wakeupPipe[1] >= 0) {
+    char wake = 1;
+    (void)write(wakeupPipe[1], &wake, 1);
+  }
+#endif
+
+  // Wait for thread to finish
+  if (watcherThread.joinable()) {
+    watcherThread.join();
+  }
+}
+
+void FileWatcher::pollFiles() {
+  // Snapshot the watch list so the filesystem is never touched under the lock
+  std::vector<std::pair<std::string, std::chrono::system_clock::time_point>>
+      snapshot;
+  {
+    std::lock_guard<std::mutex> lock(filesMutex);
+    snapshot.reserve(watchedFiles.size());
+    for (const auto &[path, watchedFile] : watchedFiles) {
+      snapshot.emplace_back(path, watchedFile.lastModified);
+    }
+  }
+
+  std::vector<std::pair<std::string, std::chrono::system_clock::time_point>>
+      changed;
+  for (const auto &[path, lastModified] : snapshot) {
+    if (!fileExists(path)) {
+      continue;
+    }
+
+    auto currentModTime = getFileModificationTime(path);
+    if (currentModTime > lastModified) {
+      changed.emplace_back(path, currentModTime);
+    }
+  }
+
+  if (changed.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(filesMutex);
+  for (const auto &[path, modTime] : changed) {
+    auto it = watchedFiles.find(path);
+    if (it != watchedFiles.end()) {
+      it->second.lastModified = modTime;
+      queueChange(path);
+    }
+  }
+}
+
+#ifdef __linux__
+bool FileWatcher::initializeInotify() {
+  if (inotifyFd >= 0) {
+    return true;
+  }
+
+  inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotifyFd < 0) {
+    return false;
+  }
+
+  if (pipe2(wakeupPipe, O_NONBLOCK | O_CLOEXEC) != 0) {
+    close(inotifyFd);
+    inotifyFd = -1;
+    return false;
+  }
+
+  return true;
+}
+
+void FileWatcher::shutdownInotify() {
+  if (inotifyFd >= 0) {
+    close(inotifyFd);
+    inotifyFd = -1;
+  }
+  for (int &fd : wakeupPipe) {
+    if (fd >= 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+}
+
+void FileWatcher::addDirectoryWatch(const std::string &path) {
+  std::filesystem::path filePath(path);
+  std::string directory = filePath.parent_path().string();
+  if (directory.empty()) {
+    directory = ".";
+  }
+
+  int descriptor =
+      inotify_add_watch(inotifyFd, directory.c_str(), DIRECTORY_WATCH_MASK);
+  if (descriptor < 0) {
+    std::cerr << "FileWatcher: inotify_add_watch failed for " << directory
+              << ", changes to " << path << " will not be detected"
+              << std::endl;
+    return;
+  }
+
+  DirectoryWatch &watch = directoryWatches[descriptor];
+  watch.directory = directory;
+  watch.files[filePath.filename().string()] = path;
+  directoryDescriptors[directory] = descriptor;
+}
+
+void FileWatcher::removeDirectoryWatch(const std::string &path) {
+  std::filesystem::path filePath(path);
+  std::string directory = filePath.parent_path().string();
+  if (directory.empty()) {
+    directory = ".";
+  }
+
+  auto descriptorIt = directoryDescriptors.find(directory);
+  if (descriptorIt == directoryDescriptors.end()) {
+    auto lostIt = lostDirectories.find(directory);
+    if (lostIt != lostDirectories.end()) {
+      lostIt->second.files.erase(filePath.filename().string());
+      if (lostIt->second.files.empty()) {
+        lostDirectories.erase(lostIt);
+      }
+    }
+    return;
+  }
+
+  auto watchIt = directoryWatches.find(descriptorIt->second);
+  if (watchIt != directoryWatches.end()) {
+    watchIt->second.files.erase(filePath.filename().string());
+    if (!watchIt->second.files.empty()) {
+      return;
+    }
+    inotify_rm_watch(inotifyFd, watchIt->first);
+    directoryWatches.erase(watchIt);
+  }
+  directoryDescriptors.erase(descriptorIt);
+}
+
+void FileWatcher::readInotifyEvents() {
+  alignas(inotify_event) char buffer[4096];
+
+  while (true) {
+    ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+    if (length <= 0) {
+      break; // EAGAIN: queue drained
+    }
+
+    std::lock_guard<std::mutex> lock(filesMutex);
+
+    for (char *ptr = buffer; ptr < buffer + length;) {
+      const inotify_event *event = reinterpret_cast<inotify_event *>(ptr);
+      ptr += sizeof(inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        // Events were dropped, treat every watched file as changed
+        for (const auto &[path, _] : watchedFiles) {
+          queueChange(path);
+        }
+        continue;
+      }
+
+      auto watchIt = directoryWatches.find(event->wd);
+      if (watchIt == directoryWatches.end()) {
+        continue;
+      }
+
+      if (event->mask & (IN_IGNORED | IN_MOVE_SELF)) {
+        // The directory itself went away. Keep its files watched and pick
+        // the directory up again once it is recreated.
+        if (event->mask & IN_MOVE_SELF) {
+          inotify_rm_watch(inotifyFd, event->wd);
+        }
+
+        DirectoryWatch &watch = watchIt->second;
+        std::cerr << "FileWatcher: Lost watch on " << watch.directory
+                  << ", will watch it again once it exists" << std::endl;
+
+        DirectoryWatch &lost = lostDirectories[watch.directory];
+        lost.directory = watch.directory;
+        lost.files.insert(watch.files.begin(), watch.files.end());
+        directoryDescriptors.erase(watch.directory);
+        directoryWatches.erase(watchIt);
+        continue;
+      }
+
+      if (event->len == 0) {
+        continue;
+      }
+
+      auto fileIt = watchIt->second.files.find(event->name);
+      if (fileIt != watchIt->second.files.end()) {
+        queueChange(fileIt->second);
+      }
+    }
   }
 }
 
+void FileWatcher::retryLostDirectories() {
+  std::lock_guard<std::mutex> lock(filesMutex);
+
+  for (auto it = lostDirectories.begin(); it != lostDirectories.end();) {
+    const std::string &directory = it->first;
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) {
+      ++it;
+      continue;
+    }
+
+    int descriptor =
+        inotify_add_watch(inotifyFd, directory.c_str(), DIRECTORY_WATCH_MASK);
+    if (descriptor < 0) {
+      ++it;
+      continue;
+    }
+
+    DirectoryWatch &watch = directoryWatches[descriptor];
+    watch.directory = directory;
+    for (const auto &[name, path] : it->second.files) {
+      watch.files[name] = path;
+      // The files may have been replaced while nothing was watching them
+      if (watchedFiles.count(path)) {
+        queueChange(path);
+      }
+    }
+    directoryDescriptors[directory] = descriptor;
+
+    std::cout << "FileWatcher: Watching " << directory << " again"
+              << std::endl;
+    it = lostDirectories.erase(it);
+  }
+}
+#endif
+
 bool FileWatcher::fileExists(const std::string &path) const {
   return std::filesystem::exists(path);
 }
@@ -176,18 +522,72 @@ FileType FileWatcher::detectFileType(const std::string &path) const {
   return FileType::UNKNOWN;
 }
 
-void FileWatcher::processFileChange(const std::string &path,
-                                    const WatchedFile &watchedFile) {
-  if (watchedFile.reloadCallback) {
-    // Add a small delay to ensure file is fully written
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+// filesMutex must be held by the caller
+void FileWatcher::queueChange(const std::string &path) {
+  // Every new event pushes the deadline back, coalescing bursts of writes
+  pendingChanges[path] = std::chrono::steady_clock::now() +
+                         std::chrono::milliseconds(DEBOUNCE_MS);
+}
+
+int FileWatcher::getMillisecondsUntilNextDispatch() const {
+  std::lock_guard<std::mutex> lock(filesMutex);
+  if (pendingChanges.empty()) {
+    return -1;
+  }
+
+  auto earliest = std::chrono::steady_clock::time_point::max();
+  for (const auto &[path, deadline] : pendingChanges) {
+    earliest = std::min(earliest, deadline);
+  }
 
+  auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+      earliest - std::chrono::steady_clock::now());
+  return std::max(0, (int)remaining.count() + 1);
+}
+
+void FileWatcher::dispatchReadyChanges() {
+  std::vector<std::pair<std::string, std::function<void(const std::string &)>>>
+      ready;
+  {
+    std::lock_guard<std::mutex> lock(filesMutex);
+    auto now = std::chrono::steady_clock::now();
+
+    for (auto it = pendingChanges.begin(); it != pendingChanges.end();) {
+      if (it->second > now) {
+        ++it;
+        continue;
+      }
+
+      auto fileIt = watchedFiles.find(it->first);
+      if (fileIt != watchedFiles.end()) {
+        ready.emplace_back(it->first, fileIt->second.reloadCallback);
+      }
+      it = pendingChanges.erase(it);
+    }
+  }
+
+  // Callbacks run without the lock so they are free to watch/unwatch files
+  for (const auto &[path, callback] : ready) {
+    if (!fileExists(path)) {
+      // Deleted, or caught halfway through an atomic save; the rename will
+      // queue it again
+      continue;
+    }
+    std::cout << "FileWatcher: Detected change in " << path << std::endl;
+    processFileChange(path, callback);
+  }
+}
+
+void FileWatcher::processFileChange(
+    const std::string &path,
+    const std::function<void(const std::string &)> &reloadCallback) {
+  if (reloadCallback) {
     try {
-      watchedFile.reloadCallback(path);
+      reloadCallback(path);
       std::cout << "FileWatcher: Successfully reloaded " << path << std::endl;
     } catch (const std::exception &e) {
       std::cerr << "FileWatcher: Error reloading " << path << ": " << e.what()
                 << std::endl;
     }
   }
-}
\ No newline at end of file
+}
@@ -4,7 +4,7 @@
 GameObject::GameObject(float x, float y, float width, float height,
                        glm::vec4 color, ObjectType type, bool isStatic)
     : bounds(x, y, width, height), color(color), type(type),
-      isStatic(isStatic) {}
+      isStatic(isStatic), previousPosition(x, y), sourceIndex(-1) {}
 
 glm::vec2 GameObject::getCenter() const {
   return glm::vec2(bounds.x + bounds.width / 2.0f,
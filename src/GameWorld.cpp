@@ -1,35 +1,142 @@
 #include "GameWorld.h"
+#include "AssetManager.h"
 #include "AudioManager.h"
+#include "Graphics.h"
+#include "Profiler.h"
+#include "RenderLayers.h"
 #include <algorithm>
+#include <cmath>
 #include <gl2d/gl2d.h>
+#include <gl2d/gl2dParticleSystem.h>
 #include <iostream>
+#include <type_traits>
+
+// Restoring a snapshot relies on entities being plain data
+static_assert(std::is_trivially_copyable<GameObject>::value,
+              "GameObject must stay trivially copyable");
+static_assert(std::is_trivially_copyable<Enemy>::value,
+              "Enemy must stay trivially copyable");
+
+// The banner lines never change, so they are laid out once and resubmitted
+struct GameWorld::BannerText {
+  const gl2d::Font *font = nullptr;
+  GLuint fontTexture = 0;
+  gl2d::TextRun title;
+  gl2d::TextRun restart;
+  gl2d::TextRun hint;
+};
+
+// Short-lived sparks, drawn untextured as instanced sprites
+struct GameWorld::ParticleEffects {
+  static constexpr int CAPACITY = 4096;
+
+  gl2d::ParticleSystem system;
+  gl2d::ParticleSettings pickup;
+  gl2d::ParticleSettings enemyHit;
+
+  ParticleEffects() {
+    system.initParticleSystem(CAPACITY);
+    system.postProcessing = false; // Would flush mid-frame
+
+    pickup.onCreateCount = 24;
+    pickup.particleLifeTime = {0.35f, 0.7f};
+    pickup.directionX = {-160.0f, 160.0f};
+    pickup.directionY = {-220.0f, 60.0f};
+    pickup.dragY = {300.0f, 400.0f}; // Falls back down
+    pickup.rotation = {0.0f, 360.0f};
+    pickup.rotationSpeed = {-360.0f, 360.0f};
+    pickup.createApearence.size = {4.0f, 8.0f};
+    pickup.createApearence.color1 = {1.0f, 0.9f, 0.2f, 1.0f};
+    pickup.createApearence.color2 = {1.0f, 1.0f, 0.6f, 1.0f};
+    pickup.createEndApearence.color1 = {1.0f, 0.6f, 0.0f, 0.0f};
+    pickup.tranzitionType = gl2d::TRANZITION_TYPES::curbe;
+
+    enemyHit = pickup;
+    enemyHit.onCreateCount = 48;
+    enemyHit.particleLifeTime = {0.5f, 1.0f};
+    enemyHit.directionX = {-260.0f, 260.0f};
+    enemyHit.directionY = {-260.0f, 260.0f};
+    enemyHit.dragY = {};
+    enemyHit.createApearence.size = {6.0f, 12.0f};
+    enemyHit.createApearence.color1 = {1.0f, 0.4f, 0.6f, 1.0f};
+    enemyHit.createApearence.color2 = {1.0f, 0.7f, 0.8f, 1.0f};
+    enemyHit.createEndApearence.color1 = {0.6f, 0.1f, 0.2f, 0.0f};
+  }
+};
 
 GameWorld::GameWorld()
     : player(nullptr), screenWidth(640), screenHeight(480),
-      cameraPosition(0.0f, 0.0f), cameraFollowSpeed(5.0f),
+      cameraPosition(0.0f, 0.0f), previousCameraPosition(0.0f, 0.0f),
+      cameraFollowSpeed(5.0f),
       cameraFollowEnabled(true), worldWidth(2000.0f), worldHeight(1500.0f),
-      pigTexture(nullptr), gameFont(nullptr), audioManager(nullptr),
-      currentPathIndex(0), followingPath(false) {}
+      pigTexture(nullptr), ownsPigTexture(false), assetManager(nullptr),
+      audioManager(nullptr),
+      objectGridDirty(true), enemyGridDirty(true), enemyLodEnabled(true),
+      enemyClock(0.0), enemyStep(0), midEnemyUpdates(0), renderAlpha(1.0f),
+      currentPathIndex(0), followingPath(false), playerMovement(0.0f),
+      playerSpeed(200.0f) {
+  objectGrid.reset(worldWidth, worldHeight);
+  enemyGrid.reset(worldWidth, worldHeight);
+
+  // Waddle cycle of pig_walk.png (4 frames in a row)
+  pigWalkClip = animations.addSheetClip("pig_walk", 4, 1, 0, 4,
+                                        {0.18f, 0.12f, 0.18f, 0.12f});
+
+  addUpdateSystems();
+}
 
 GameWorld::~GameWorld() {
   gameObjects.clear();
   enemies.clear();
 
   // Clean up pig texture safely
-  if (pigTexture) {
+  if (pigTexture && ownsPigTexture) {
     static_cast<gl2d::Texture *>(pigTexture)->cleanup();
     delete static_cast<gl2d::Texture *>(pigTexture);
-    pigTexture = nullptr;
+  } else if (pigTexture && assetManager) {
+    assetManager->unpinAsset(PIG_TEXTURE);
+  }
+  pigTexture = nullptr;
+}
+
+void GameWorld::loadRenderResources() {
+  // Without a GL context the texture stays null; rendering already treats it
+  // as optional
+  if (!Graphics::isEnabled())
+    return;
+
+  // Through the asset manager the decoded sheet comes from its texture
+  // cache and is shared by every world. Pinned for as long as we keep the
+  // pointer, so the texture budget can't evict it.
+  const char *pigPath = RESOURCES_PATH "textures/sprites/pig_walk.png";
+  if (!pigTexture && assetManager &&
+      assetManager->loadTexture(PIG_TEXTURE, pigPath)) {
+    pigTexture = assetManager->getTexture(PIG_TEXTURE);
+    assetManager->pinAsset(PIG_TEXTURE);
+    ownsPigTexture = false;
+  }
+  if (!pigTexture) {
+    pigTexture = new gl2d::Texture();
+    static_cast<gl2d::Texture *>(pigTexture)->loadFromFile(pigPath);
+    ownsPigTexture = true;
   }
 
-  // Clean up font safely
-  if (gameFont) {
-    static_cast<gl2d::Font *>(gameFont)->cleanup();
-    delete static_cast<gl2d::Font *>(gameFont);
-    gameFont = nullptr;
+  if (!particles) {
+    particles = std::make_unique<ParticleEffects>();
   }
 }
 
+void GameWorld::emitBurst(Burst burst, const Rectangle &area) {
+  if (!particles)
+    return;
+
+  gl2d::ParticleSettings *settings = burst == Burst::PICKUP
+                                         ? &particles->pickup
+                                         : &particles->enemyHit;
+  particles->system.emitParticleWave(
+      settings, {area.x + area.width * 0.5f, area.y + area.height * 0.5f});
+}
+
 void GameWorld::initialize(int width, int height) {
   screenWidth = width;
   screenHeight = height;
@@ -37,31 +144,16 @@ void GameWorld::initialize(int width, int height) {
   // Clear existing objects
   gameObjects.clear();
   enemies.clear();
+  enemyAnimations.clear();
+  resetEnemyClock();
+  objectGridDirty = enemyGridDirty = true;
   player = nullptr;
 
   // Initialize tile system
   initializeTileSystem();
 
   // Load pig texture if not already loaded
-  if (!pigTexture) {
-    pigTexture = new gl2d::Texture();
-    static_cast<gl2d::Texture *>(pigTexture)
-        ->loadFromFile(RESOURCES_PATH "textures/sprites/pig.png");
-  }
-
-  // Load font if not already loaded
-  if (!gameFont) {
-    gameFont = new gl2d::Font();
-    // Try to load a system font, fallback to a simple approach if not available
-    try {
-      static_cast<gl2d::Font *>(gameFont)->createFromFile(
-          "C:/Windows/Fonts/arial.ttf");
-    } catch (...) {
-      // If no system font available, we'll render text differently
-      delete static_cast<gl2d::Font *>(gameFont);
-      gameFont = nullptr;
-    }
-  }
+  loadRenderResources();
 
   // Create player
   player = createPlayer(100.0f, 100.0f);
@@ -116,31 +208,16 @@ void GameWorld::initializeEmpty(int width, int height) {
   // Clear existing objects
   gameObjects.clear();
   enemies.clear();
+  enemyAnimations.clear();
+  resetEnemyClock();
+  objectGridDirty = enemyGridDirty = true;
   player = nullptr;
 
   // Initialize tile system
   initializeTileSystem();
 
-  // Load pig texture if not already loaded
-  if (!pigTexture) {
-    pigTexture = new gl2d::Texture();
-    static_cast<gl2d::Texture *>(pigTexture)
-        ->loadFromFile(RESOURCES_PATH "textures/sprites/pig.png");
-  }
-
-  // Load font if not already loaded
-  if (!gameFont) {
-    gameFont = new gl2d::Font();
-    // Try to load a system font, fallback to a simple approach if not available
-    try {
-      static_cast<gl2d::Font *>(gameFont)->createFromFile(
-          "C:/Windows/Fonts/arial.ttf");
-    } catch (...) {
-      // If no system font available, we'll render text differently
-      delete static_cast<gl2d::Font *>(gameFont);
-      gameFont = nullptr;
-    }
-  }
+  // Load pig texture and font if not already loaded
+  loadRenderResources();
 
   // Reset game state
   gameStateManager.resetGame();
@@ -153,8 +230,99 @@ void GameWorld::initializeEmpty(int width, int height) {
   // DO NOT create any game objects - the Scene system will handle that
 }
 
+void GameWorld::captureInitialState() {
+  initialState.objects.clear();
+  initialState.objects.reserve(gameObjects.size());
+  initialState.playerIndex = -1;
+  for (const auto &object : gameObjects) {
+    if (object.get() == player) {
+      initialState.playerIndex =
+          static_cast<int>(initialState.objects.size());
+    }
+    initialState.objects.push_back(*object);
+  }
+
+  syncAllEnemies();
+  initialState.enemies.clear();
+  initialState.enemies.reserve(enemies.size());
+  for (const auto &enemy : enemies) {
+    initialState.enemies.push_back(*enemy);
+  }
+
+  initialState.cameraPosition = cameraPosition;
+  initialState.cameraFollowSpeed = cameraFollowSpeed;
+  initialState.cameraFollowEnabled = cameraFollowEnabled;
+  initialState.valid = true;
+}
+
+bool GameWorld::restoreInitialState() {
+  if (!initialState.valid)
+    return false;
+
+  // Copy over the existing allocations and only allocate for objects that
+  // were removed during play (collected items)
+  const size_t objectCount = initialState.objects.size();
+  if (gameObjects.size() > objectCount) {
+    gameObjects.resize(objectCount);
+  }
+  for (size_t i = 0; i < objectCount; i++) {
+    if (i < gameObjects.size()) {
+      *gameObjects[i] = initialState.objects[i];
+    } else {
+      gameObjects.push_back(
+          std::make_unique<GameObject>(initialState.objects[i]));
+    }
+  }
+
+  const size_t enemyCount = initialState.enemies.size();
+  if (enemies.size() > enemyCount) {
+    enemies.resize(enemyCount);
+  }
+  for (size_t i = 0; i < enemyCount; i++) {
+    if (i < enemies.size()) {
+      *enemies[i] = initialState.enemies[i];
+    } else {
+      enemies.push_back(std::make_unique<Enemy>(initialState.enemies[i]));
+    }
+  }
+
+  enemyAnimations.resize(enemyCount);
+  for (size_t i = 0; i < enemyCount; i++) {
+    enemyAnimations[i] = initialEnemyAnimation(i);
+  }
+  resetEnemyClock();
+  objectGridDirty = enemyGridDirty = true;
+
+  player = initialState.playerIndex >= 0
+               ? gameObjects[initialState.playerIndex].get()
+               : nullptr;
+
+  cameraPosition = initialState.cameraPosition;
+  previousCameraPosition = cameraPosition;
+  cameraFollowSpeed = initialState.cameraFollowSpeed;
+  cameraFollowEnabled = initialState.cameraFollowEnabled;
+
+  gameStateManager.resetGame();
+  stopPathfinding();
+  return true;
+}
+
+void GameWorld::clearEntities() {
+  gameObjects.clear();
+  enemies.clear();
+  enemyAnimations.clear();
+  resetEnemyClock();
+  objectGridDirty = enemyGridDirty = true;
+  player = nullptr;
+  initialState.valid = false;
+
+  gameStateManager.resetGame();
+  stopPathfinding();
+}
+
 void GameWorld::addObject(std::unique_ptr<GameObject> object) {
   gameObjects.push_back(std::move(object));
+  objectGridDirty = true;
 }
 
 GameObject *GameWorld::createPlayer(float x, float y) {
@@ -194,76 +362,373 @@ Enemy *GameWorld::createEnemy(float x, float y, MovementPattern pattern) {
   enemy->type = ObjectType::ENEMY;
   Enemy *enemyPtr = enemy.get();
   enemies.push_back(std::move(enemy));
+  enemyAnimations.push_back(initialEnemyAnimation(enemies.size() - 1));
+  enemySyncTimes.push_back(enemyClock);
+  enemyGridDirty = true;
   return enemyPtr;
 }
 
+AnimationState GameWorld::initialEnemyAnimation(size_t index) const {
+  // Start each pig at a different point of the cycle so they don't waddle
+  // in step
+  AnimationState state;
+  state.clip = pigWalkClip;
+  state.time = std::fmod(index * 0.37f, animations.getClipDuration(state.clip));
+  return state;
+}
+
+void GameWorld::removeObject(GameObject *object) {
+  auto it = std::find_if(gameObjects.begin(), gameObjects.end(),
+                         [object](const std::unique_ptr<GameObject> &o) {
+                           return o.get() == object;
+                         });
+  if (it == gameObjects.end())
+    return;
+
+  if (object == player) {
+    player = nullptr;
+  }
+  gameObjects.erase(it);
+  objectGridDirty = true;
+}
+
+void GameWorld::removeEnemy(Enemy *enemy) {
+  auto it = std::find_if(
+      enemies.begin(), enemies.end(),
+      [enemy](const std::unique_ptr<Enemy> &e) { return e.get() == enemy; });
+  if (it != enemies.end()) {
+    enemyAnimations.erase(enemyAnimations.begin() + (it - enemies.begin()));
+    enemySyncTimes.erase(enemySyncTimes.begin() + (it - enemies.begin()));
+    nearEnemies.clear();
+    enemies.erase(it);
+    enemyGridDirty = true;
+  }
+}
+
 void GameWorld::updateEnemies(float deltaTime) {
-  for (auto &enemy : enemies) {
-    enemy->update(deltaTime);
+  PROFILE_SCOPE("Enemies");
+  if (enemyGridDirty)
+    rebuildEnemyGrid();
+
+  enemyClock += deltaTime;
+  enemyStep++;
+  nearEnemies.clear();
+  midEnemyUpdates = 0;
+
+  if (!enemyLodEnabled) {
+    for (size_t i = 0; i < enemies.size(); i++) {
+      syncEnemy(i, deltaTime);
+      nearEnemies.push_back(static_cast<uint32_t>(i));
+    }
+    return;
+  }
+
+  // Tiers go by movement range rather than position, so an enemy is up to
+  // date every step before it can possibly reach the view
+  auto grow = [](const Rectangle &area, float margin) {
+    return Rectangle(area.x - margin, area.y - margin,
+                     area.width + 2.0f * margin, area.height + 2.0f * margin);
+  };
+  const Rectangle view(cameraPosition.x, cameraPosition.y,
+                       static_cast<float>(screenWidth),
+                       static_cast<float>(screenHeight));
+  const Rectangle nearArea =
+      grow(view, VISIBILITY_MARGIN + NEAR_ENEMY_MARGIN);
+
+  // Far enemies aren't looked at; they catch up once they get closer
+  enemyGrid.query(grow(view, VISIBILITY_MARGIN + MID_ENEMY_MARGIN),
+                  enemyCandidates);
+  for (uint32_t index : enemyCandidates) {
+    if (CollisionDetection::checkRectangleCollision(enemyRanges[index],
+                                                    nearArea)) {
+      syncEnemy(index, deltaTime);
+      nearEnemies.push_back(index);
+    } else if ((index + enemyStep) % MID_ENEMY_INTERVAL == 0) {
+      // Staggered so each step takes its share of the mid-range enemies
+      syncEnemy(index, deltaTime);
+      midEnemyUpdates++;
+    }
+  }
+
+  // The player isn't necessarily in view (camera follow off), and
+  // checkPlayerEnemyCollisions relies on everything around it being current
+  if (player) {
+    enemyGrid.query(grow(player->bounds, NEAR_ENEMY_MARGIN), enemyCandidates);
+    for (uint32_t index : enemyCandidates) {
+      if (enemySyncTimes[index] != enemyClock) {
+        syncEnemy(index, deltaTime);
+        nearEnemies.push_back(index);
+      }
+    }
+  }
+}
+
+void GameWorld::syncEnemy(size_t index, float deltaTime) {
+  const float elapsed = static_cast<float>(enemyClock - enemySyncTimes[index]);
+  if (elapsed <= 0.0f)
+    return;
+  enemySyncTimes[index] = enemyClock;
+
+  Enemy &enemy = *enemies[index];
+  const glm::vec2 before(enemy.bounds.x, enemy.bounds.y);
+  enemy.update(elapsed);
+
+  // Keep enemies within world bounds
+  enemy.bounds.x = std::max(
+      0.0f, std::min(enemy.bounds.x, worldWidth - enemy.bounds.width));
+  enemy.bounds.y = std::max(
+      0.0f, std::min(enemy.bounds.y, worldHeight - enemy.bounds.height));
 
-    // Keep enemies within world bounds
-    enemy->bounds.x = std::max(
-        0.0f, std::min(enemy->bounds.x, worldWidth - enemy->bounds.width));
-    enemy->bounds.y = std::max(
-        0.0f, std::min(enemy->bounds.y, worldHeight - enemy->bounds.height));
+  // Interpolate over a single step; after catching up on several there is
+  // nothing sensible to interpolate from (and it is out of view anyway)
+  enemy.previousPosition = elapsed > deltaTime * 1.5f
+                               ? glm::vec2(enemy.bounds.x, enemy.bounds.y)
+                               : before;
+
+  animations.advance(&enemyAnimations[index], 1, elapsed);
+}
+
+void GameWorld::syncAllEnemies() {
+  for (size_t i = 0; i < enemies.size(); i++) {
+    syncEnemy(i, 0.0f);
+  }
+}
+
+void GameWorld::setEnemyLodEnabled(bool enable) {
+  if (enemyLodEnabled == enable)
+    return;
+  // Everything is current when switching, whatever the tier was
+  syncAllEnemies();
+  enemyLodEnabled = enable;
+}
+
+void GameWorld::resetEnemyClock() {
+  enemyClock = 0.0;
+  enemySyncTimes.assign(enemies.size(), 0.0);
+  nearEnemies.clear();
+  midEnemyUpdates = 0;
+}
+
+void GameWorld::rebuildObjectGrid() {
+  objectGrid.clear();
+  movingObjects.clear();
+  for (size_t i = 0; i < gameObjects.size(); i++) {
+    if (gameObjects[i]->isStatic) {
+      objectGrid.insert(static_cast<uint32_t>(i), gameObjects[i]->bounds);
+    } else {
+      movingObjects.push_back(static_cast<uint32_t>(i));
+    }
+  }
+  objectGridDirty = false;
+}
+
+void GameWorld::rebuildEnemyGrid() {
+  enemyGrid.clear();
+  enemyRanges.resize(enemies.size());
+  // Resizing the world dirties the grid too, so the limits are current
+  const Rectangle world(0.0f, 0.0f, worldWidth, worldHeight);
+  for (size_t i = 0; i < enemies.size(); i++) {
+    enemies[i]->setMovementLimits(world);
+    enemyRanges[i] = enemies[i]->getMovementBounds();
+    enemyGrid.insert(static_cast<uint32_t>(i), enemyRanges[i]);
+  }
+  enemyGridDirty = false;
+}
+
+Rectangle GameWorld::getVisibilityRect() const {
+  // The grids hold simulation positions; the margin also covers the
+  // interpolation towards them
+  const glm::vec2 camera = getRenderCameraPosition();
+  return Rectangle(camera.x - VISIBILITY_MARGIN, camera.y - VISIBILITY_MARGIN,
+                   screenWidth + 2.0f * VISIBILITY_MARGIN,
+                   screenHeight + 2.0f * VISIBILITY_MARGIN);
+}
+
+void GameWorld::updateVisibility() {
+  PROFILE_SCOPE("Visibility");
+  if (objectGridDirty)
+    rebuildObjectGrid();
+  if (enemyGridDirty)
+    rebuildEnemyGrid();
+
+  const Rectangle view = getVisibilityRect();
+
+  visibleObjects.clear();
+  objectGrid.query(view, gridCandidates);
+  for (uint32_t index : gridCandidates) {
+    if (CollisionDetection::checkRectangleCollision(
+            gameObjects[index]->bounds, view))
+      visibleObjects.push_back(index);
+  }
+  for (uint32_t index : movingObjects) {
+    if (CollisionDetection::checkRectangleCollision(
+            getRenderBounds(*gameObjects[index]), view))
+      visibleObjects.push_back(index);
+  }
+  // Keep submission order the same as without culling
+  std::sort(visibleObjects.begin(), visibleObjects.end());
+
+  visibleEnemies.clear();
+  enemyGrid.query(view, gridCandidates);
+  for (uint32_t index : gridCandidates) {
+    if (CollisionDetection::checkRectangleCollision(enemies[index]->bounds,
+                                                    view))
+      visibleEnemies.push_back(index);
   }
 }
 
 void GameWorld::checkPlayerEnemyCollisions() {
+  PROFILE_SCOPE("Player vs enemies");
   if (!player || gameStateManager.isGameOver())
     return;
 
-  for (const auto &enemy : enemies) {
-    if (player->isColliding(*enemy)) {
+  // Only enemies whose movement range touches the player can hit it, and
+  // updateEnemies has just brought those up to date. Candidates come in
+  // index order, so the same enemy is hit first as in a full scan.
+  enemyGrid.query(player->bounds, contactCandidates);
+  for (uint32_t index : contactCandidates) {
+    const Enemy &enemy = *enemies[index];
+    if (player->isColliding(enemy)) {
       gameStateManager.triggerGameOver();
+      emitBurst(Burst::ENEMY_HIT, enemy.bounds);
       std::cout << "Game Over! You touched a pig!" << std::endl;
       break;
     }
   }
 }
 
-void GameWorld::update(float deltaTime) {
-  // Update game state
-  gameStateManager.update(deltaTime);
-
-  // Only update game objects if playing
-  if (gameStateManager.isPlaying()) {
-    // Cache screen bounds for better performance
+namespace {
+
+// Data the update systems declare access to (SystemScheduler bits)
+enum WorldData : SystemScheduler::AccessMask {
+  GAME_STATE = 1 << 0,
+  PLAYER = 1 << 1,  // The player object and the path it follows
+  OBJECTS = 1 << 2, // Every other object and the object list
+  ENEMIES = 1 << 3, // Enemies, their animations and the enemy grid
+  PARTICLES = 1 << 4,
+  CAMERA = 1 << 5,
+  AUDIO = 1 << 6
+};
+
+} // namespace
+
+void GameWorld::addUpdateSystems() {
+  systems.setDataNames({"game state", "player", "objects", "enemies",
+                        "particles", "camera", "audio"});
+
+  // The order below is the order of a step; systems that don't touch the
+  // same data (e.g. particles, enemies and object bounds) run side by side
+  systems.addSystem("Previous state", 0, PLAYER | OBJECTS | ENEMIES | CAMERA,
+                    [this](float) { storePreviousState(); });
+
+  systems.addSystem("Game state", 0, GAME_STATE, [this](float deltaTime) {
+    gameStateManager.update(deltaTime);
+  });
+
+  // Bursts keep playing out after a game over
+  systems.addSystem("Particles", 0, PARTICLES, [this](float deltaTime) {
+    PROFILE_SCOPE("Particles");
+    if (particles)
+      particles->system.applyMovement(deltaTime);
+  });
+
+  systems.addSystem("Object bounds", GAME_STATE, OBJECTS, [this](float) {
+    if (!gameStateManager.isPlaying())
+      return;
+    // Only non-player objects are kept on screen
     const float screenW = static_cast<float>(screenWidth);
     const float screenH = static_cast<float>(screenHeight);
-
-    // Update non-static objects if needed
     for (auto &obj : gameObjects) {
-      if (!obj->isStatic && obj.get() != player) {
-        // Only constrain non-player objects to screen bounds
+      if (!obj->isStatic && obj.get() != player)
         obj->constrainToBounds(screenW, screenH);
-      }
     }
+  });
+
+  // The player is kept in the larger world bounds
+  systems.addSystem("Player bounds", GAME_STATE, PLAYER, [this](float) {
+    if (!gameStateManager.isPlaying() || !player)
+      return;
+    player->bounds.x = std::max(
+        0.0f, std::min(player->bounds.x, worldWidth - player->bounds.width));
+    player->bounds.y = std::max(
+        0.0f, std::min(player->bounds.y, worldHeight - player->bounds.height));
+  });
+
+  // Picks the enemies to update by their distance to the camera and player
+  systems.addSystem("Enemies", GAME_STATE | PLAYER | CAMERA, ENEMIES,
+                    [this](float deltaTime) {
+                      if (gameStateManager.isPlaying())
+                        updateEnemies(deltaTime);
+                    });
+
+  // Plays the pickup sound, so it stays on the main thread
+  systems.addSystem(
+      "Pickups", GAME_STATE, PLAYER | OBJECTS | PARTICLES | AUDIO,
+      [this](float) {
+        if (gameStateManager.isPlaying())
+          handleCollisions();
+      },
+      true);
+
+  systems.addSystem("Enemy contact", PLAYER | ENEMIES,
+                    GAME_STATE | PARTICLES, [this](float) {
+                      if (gameStateManager.isPlaying())
+                        checkPlayerEnemyCollisions();
+                    });
+
+  // Keyboard movement takes over from a path being followed
+  systems.addSystem("Player movement", GAME_STATE | OBJECTS, PLAYER,
+                    [this](float deltaTime) {
+                      if (!gameStateManager.isPlaying() ||
+                          glm::length(playerMovement) <= 0.1f)
+                        return;
+                      stopPathfinding();
+                      updatePlayer(playerMovement.x, playerMovement.y,
+                                   playerSpeed, deltaTime);
+                    });
+
+  systems.addSystem("Camera", PLAYER, CAMERA,
+                    [this](float deltaTime) { updateCamera(deltaTime); });
+
+  systems.addSystem("Pathfinding", GAME_STATE | OBJECTS, PLAYER,
+                    [this](float deltaTime) {
+                      if (gameStateManager.isPlaying())
+                        updatePathfinding(deltaTime, playerSpeed);
+                    });
+}
 
-    // Constrain player to larger world bounds
-    if (player) {
-      player->bounds.x = std::max(
-          0.0f, std::min(player->bounds.x, worldWidth - player->bounds.width));
-      player->bounds.y =
-          std::max(0.0f, std::min(player->bounds.y,
-                                  worldHeight - player->bounds.height));
-    }
+void GameWorld::update(float deltaTime) {
+  PROFILE_SCOPE("GameWorld::update");
+  systems.run(deltaTime);
+}
 
-    // Update enemies
-    updateEnemies(deltaTime);
+void GameWorld::storePreviousState() {
+  for (auto &obj : gameObjects) {
+    obj->previousPosition = glm::vec2(obj->bounds.x, obj->bounds.y);
+  }
+  // The other enemies set theirs when they are brought up to date
+  for (uint32_t index : nearEnemies) {
+    Enemy &enemy = *enemies[index];
+    enemy.previousPosition = glm::vec2(enemy.bounds.x, enemy.bounds.y);
+  }
+  previousCameraPosition = cameraPosition;
+}
 
-    // Update pathfinding (will be called from Application with player speed)
-    // updatePathfinding(deltaTime, playerSpeed); // This will be called from
-    // Application
+glm::vec2 GameWorld::getRenderCameraPosition() const {
+  return glm::mix(previousCameraPosition, cameraPosition, renderAlpha);
+}
 
-    // Check collisions
-    handleCollisions();
-    checkPlayerEnemyCollisions();
-  }
+Rectangle GameWorld::getRenderBounds(const GameObject &object) const {
+  glm::vec2 position = glm::mix(
+      object.previousPosition, glm::vec2(object.bounds.x, object.bounds.y),
+      renderAlpha);
+  return Rectangle(position.x, position.y, object.bounds.width,
+                   object.bounds.height);
 }
 
 void GameWorld::updatePlayer(float moveX, float moveY, float speed,
                              float deltaTime) {
+  PROFILE_SCOPE("Player movement");
   if (!player)
     return;
 
@@ -271,20 +736,30 @@ void GameWorld::updatePlayer(float moveX, float moveY, float speed,
   float deltaX = moveX * speed * deltaTime;
   float deltaY = moveY * speed * deltaTime;
 
-  // Store current position
-  float currentX = player->bounds.x;
-  float currentY = player->bounds.y;
-
-  // Try moving horizontally first
-  player->setPosition(currentX + deltaX, currentY);
-  if (checkPlayerCollisions(player->bounds.x, player->bounds.y)) {
-    player->setPosition(currentX, currentY); // Revert horizontal movement
-  }
+  // Sweep the move in small increments so a long step can't pass through
+  // an obstacle thinner than the step
+  float distance = std::max(std::abs(deltaX), std::abs(deltaY));
+  int subSteps =
+      std::max(1, static_cast<int>(std::ceil(distance / MAX_MOVE_STEP)));
+  float stepX = deltaX / subSteps;
+  float stepY = deltaY / subSteps;
+
+  for (int i = 0; i < subSteps; i++) {
+    // Store current position
+    float currentX = player->bounds.x;
+    float currentY = player->bounds.y;
+
+    // Try moving horizontally first
+    player->setPosition(currentX + stepX, currentY);
+    if (checkPlayerCollisions(player->bounds.x, player->bounds.y)) {
+      player->setPosition(currentX, currentY); // Revert horizontal movement
+    }
 
-  // Try moving vertically
-  player->setPosition(player->bounds.x, currentY + deltaY);
-  if (checkPlayerCollisions(player->bounds.x, player->bounds.y)) {
-    player->setPosition(player->bounds.x, currentY); // Revert vertical movement
+    // Try moving vertically
+    player->setPosition(player->bounds.x, currentY + stepY);
+    if (checkPlayerCollisions(player->bounds.x, player->bounds.y)) {
+      player->setPosition(player->bounds.x, currentY); // Revert vertical move
+    }
   }
 
   // With camera following, player doesn't need to be constrained to screen
@@ -292,6 +767,7 @@ void GameWorld::updatePlayer(float moveX, float moveY, float speed,
 }
 
 void GameWorld::handleCollisions() {
+  PROFILE_SCOPE("Collisions");
   if (!player)
     return;
 
@@ -304,8 +780,10 @@ void GameWorld::handleCollisions() {
       if (audioManager) {
         audioManager->playSoundMulti("collectible_pickup");
       }
+      emitBurst(Burst::PICKUP, (*it)->bounds);
 
       it = gameObjects.erase(it);
+      objectGridDirty = true;
       // Update player pointer if it was the erased object
       if (it != gameObjects.end() && (*it).get() == player) {
         player = nullptr;
@@ -334,35 +812,53 @@ bool GameWorld::checkPlayerCollisions(float newX, float newY) {
 }
 
 void GameWorld::render(void *rendererPtr) {
+  PROFILE_SCOPE("GameWorld::render");
   gl2d::Renderer2D &renderer = *static_cast<gl2d::Renderer2D *>(rendererPtr);
 
   // Render tile map first (background)
-  tileMapManager.renderCurrentMap(rendererPtr, cameraPosition,
+  renderer.setLayer(RenderLayer::TILES);
+  const glm::vec2 renderCamera = getRenderCameraPosition();
+  tileMapManager.renderCurrentMap(rendererPtr, renderCamera,
                                   glm::vec2(screenWidth, screenHeight));
 
+  // Only what overlaps the view is submitted
+  updateVisibility();
+
   // Render regular game objects
-  for (const auto &obj : gameObjects) {
+  renderer.setLayer(RenderLayer::OBJECTS);
+  for (uint32_t index : visibleObjects) {
+    const GameObject *obj = gameObjects[index].get();
     gl2d::Color4f color = {obj->color.r, obj->color.g, obj->color.b,
                            obj->color.a};
-    renderer.renderRectangle(
-        {obj->bounds.x, obj->bounds.y, obj->bounds.width, obj->bounds.height},
-        color);
+    Rectangle bounds = getRenderBounds(*obj);
+    renderer.renderRectangle({bounds.x, bounds.y, bounds.width, bounds.height},
+                             color);
   }
 
-  // Render enemies with pig texture
+  // Render enemies as instanced sprites, each showing its current frame of
+  // the pig sheet
+  renderer.setLayer(RenderLayer::ENEMIES);
   if (pigTexture) {
     gl2d::Texture *texture = static_cast<gl2d::Texture *>(pigTexture);
-    for (const auto &enemy : enemies) {
-      renderer.renderRectangle({enemy->bounds.x, enemy->bounds.y,
-                                enemy->bounds.width, enemy->bounds.height},
-                               *texture);
+    for (uint32_t i : visibleEnemies) {
+      Rectangle bounds = getRenderBounds(*enemies[i]);
+      renderer.renderSprite({bounds.x, bounds.y, bounds.width, bounds.height},
+                            *texture, {1, 1, 1, 1}, {}, 0,
+                            animations.getFrameUV(enemyAnimations[i]));
     }
   }
 
+  if (particles) {
+    renderer.setLayer(RenderLayer::PARTICLES);
+    particles->system.draw(renderer);
+  }
+
   // Render pathfinding path
+  renderer.setLayer(RenderLayer::PATH);
   renderPath(rendererPtr);
 
   // Render game over banner on top of everything
+  renderer.setLayer(RenderLayer::OVERLAY);
   renderGameOverBanner(rendererPtr);
 }
 
@@ -371,6 +867,14 @@ void GameWorld::updateScreenSize(int width, int height) {
   screenHeight = height;
 }
 
+void GameWorld::setWorldSize(float width, float height) {
+  worldWidth = width;
+  worldHeight = height;
+  objectGrid.reset(worldWidth, worldHeight);
+  enemyGrid.reset(worldWidth, worldHeight);
+  objectGridDirty = enemyGridDirty = true;
+}
+
 void GameWorld::renderGameOverBanner(void *rendererPtr) {
   if (!gameStateManager.isGameOver())
     return;
@@ -378,7 +882,7 @@ void GameWorld::renderGameOverBanner(void *rendererPtr) {
   gl2d::Renderer2D &renderer = *static_cast<gl2d::Renderer2D *>(rendererPtr);
 
   // Get camera position to render overlay in screen space
-  glm::vec2 camPos = cameraPosition;
+  glm::vec2 camPos = getRenderCameraPosition();
 
   // Calculate screen-space coordinates
   float overlayX = camPos.x;
@@ -393,27 +897,42 @@ void GameWorld::renderGameOverBanner(void *rendererPtr) {
                            overlayColor);
 
   // Render "GAME OVER" text
-  if (gameFont) {
-    gl2d::Font *font = static_cast<gl2d::Font *>(gameFont);
+  renderer.setLayer(RenderLayer::OVERLAY_TEXT);
+  const gl2d::Font *font =
+      assetManager ? assetManager->getFont(AssetManager::DEFAULT_FONT)
+                   : nullptr;
+  if (font) {
+    // Rebuilt when the font is reloaded
+    if (!bannerText || bannerText->font != font ||
+        bannerText->fontTexture != font->texture.id) {
+      bannerText = std::make_unique<BannerText>();
+      bannerText->font = font;
+      bannerText->fontTexture = font->texture.id;
+
+      // Main "GAME OVER" text (much smaller size, increased character
+      // spacing), then the restart instructions
+      gl2d::layoutText(bannerText->title, "GAME OVER", *font, 1.8f, 8, 2,
+                       true);
+      gl2d::layoutText(bannerText->restart, "Press R to Restart", *font, 1.0f,
+                       5, 1, true);
+      gl2d::layoutText(bannerText->hint, "or click Restart button", *font,
+                       0.8f, 4, 1, true);
+    }
+
     gl2d::Color4f textColor = {1.0f, 0.0f, 0.0f, 1.0f}; // Red text
 
     // Center the text on screen
     float centerX = camPos.x + screenWidth / 2.0f;
     float centerY = camPos.y + screenHeight / 2.0f;
 
-    // Render main "GAME OVER" text (much smaller size, increased character
-    // spacing)
-    renderer.renderText({centerX, centerY - 80}, "GAME OVER", *font, textColor,
-                        1.8f, 8, 2, true);
+    renderer.renderTextRun({centerX, centerY - 80}, bannerText->title,
+                           textColor);
 
-    // Render restart instruction (smaller size, increased character spacing)
     gl2d::Color4f instructionColor = {1.0f, 1.0f, 1.0f, 1.0f}; // White text
-    renderer.renderText({centerX, centerY + 20}, "Press R to Restart", *font,
-                        instructionColor, 1.0f, 5, 1, true);
-
-    // Additional instruction (increased character spacing)
-    renderer.renderText({centerX, centerY + 80}, "or click Restart button",
-                        *font, instructionColor, 0.8f, 4, 1, true);
+    renderer.renderTextRun({centerX, centerY + 20}, bannerText->restart,
+                           instructionColor);
+    renderer.renderTextRun({centerX, centerY + 80}, bannerText->hint,
+                           instructionColor);
   } else {
     // Fallback: render colored rectangles to spell out "GAME OVER"
     gl2d::Color4f redColor = {1.0f, 0.0f, 0.0f, 1.0f};
@@ -475,14 +994,18 @@ bool GameWorld::initializeTileSystem() {
     return true;
   }
 
+  // Tile images go through the asset manager if there is one
+  tileMapManager.setAssetManager(assetManager);
+
   // Calculate tile map dimensions to match playable world bounds
   // World: 2000x1500 pixels, Tiles: 64x64 pixels each
   int tilesWide = static_cast<int>(worldWidth / 64.0f);  // 2000/64 = 31 tiles
   int tilesHigh = static_cast<int>(worldHeight / 64.0f); // 1500/64 = 23 tiles
 
   // Update world bounds to exactly match tile map dimensions
-  worldWidth = static_cast<float>(tilesWide * 64);  // 31 * 64 = 1,984 pixels
-  worldHeight = static_cast<float>(tilesHigh * 64); // 23 * 64 = 1,472 pixels
+  // (31 * 64 = 1,984 by 23 * 64 = 1,472 pixels)
+  setWorldSize(static_cast<float>(tilesWide * 64),
+               static_cast<float>(tilesHigh * 64));
 
   std::cout << "Creating tile map to match world bounds:" << std::endl;
   std::cout << "Updated world size: " << worldWidth << "x" << worldHeight
@@ -559,6 +1082,7 @@ void GameWorld::verifyMapPreloaded() const {
 }
 
 void GameWorld::handleMouseInput(const glm::vec2 &mouseScreenPos) {
+  PROFILE_SCOPE("Path search");
   if (!player || gameStateManager.isGameOver()) {
     return;
   }
@@ -588,6 +1112,7 @@ void GameWorld::handleMouseInput(const glm::vec2 &mouseScreenPos) {
 }
 
 void GameWorld::updatePathfinding(float deltaTime, float playerSpeed) {
+  PROFILE_SCOPE("Pathfinding");
   if (!followingPath || !player || currentPath.empty()) {
     return;
   }
@@ -664,8 +1189,9 @@ void GameWorld::stopPathfinding() {
 }
 
 glm::vec2 GameWorld::screenToWorldPosition(const glm::vec2 &screenPos) const {
-  return glm::vec2(screenPos.x + cameraPosition.x,
-                   screenPos.y + cameraPosition.y);
+  // Map against what is on screen, which is the interpolated camera
+  glm::vec2 renderCamera = getRenderCameraPosition();
+  return glm::vec2(screenPos.x + renderCamera.x, screenPos.y + renderCamera.y);
 }
 
 void GameWorld::renderPath(void *rendererPtr) {
@@ -677,23 +1203,26 @@ void GameWorld::renderPath(void *rendererPtr) {
   gl2d::Color4f destinationColor = {1.0f, 1.0f, 0.0f,
                                     1.0f}; // Yellow destination
 
-  // Only render the final destination waypoint
-  if (!currentPath.empty()) {
-    glm::vec2 destination = currentPath.back();
-    float destinationSize = 12.0f;
-
-    // Render destination as a larger yellow square
-    renderer.renderRectangle({destination.x - destinationSize / 2,
-                              destination.y - destinationSize / 2,
-                              destinationSize, destinationSize},
-                             destinationColor);
-
-    // Add a smaller inner square for visual contrast
-    gl2d::Color4f innerColor = {1.0f, 0.5f, 0.0f, 1.0f}; // Orange inner
-    float innerSize = 6.0f;
-    renderer.renderRectangle({destination.x - innerSize / 2,
-                              destination.y - innerSize / 2, innerSize,
-                              innerSize},
-                             innerColor);
+  // Only render the final destination waypoint, when it is in view
+  glm::vec2 destination = currentPath.back();
+  if (!CollisionDetection::checkPointInRectangle(
+          destination.x, destination.y, getVisibilityRect())) {
+    return;
   }
+
+  float destinationSize = 12.0f;
+
+  // Render destination as a larger yellow square
+  renderer.renderRectangle({destination.x - destinationSize / 2,
+                            destination.y - destinationSize / 2,
+                            destinationSize, destinationSize},
+                           destinationColor);
+
+  // Add a smaller inner square for visual contrast
+  gl2d::Color4f innerColor = {1.0f, 0.5f, 0.0f, 1.0f}; // Orange inner
+  float innerSize = 6.0f;
+  renderer.renderRectangle({destination.x - innerSize / 2,
+                            destination.y - innerSize / 2, innerSize,
+                            innerSize},
+                           innerColor);
 }
\ No newline at end of file
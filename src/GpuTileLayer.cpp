@@ -0,0 +1,354 @@
+#include "GpuTileLayer.h"
+#include "TileMap.h"
+#include <algorithm>
+#include <fstream>
+#include <gl2d/gl2d.h>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+struct TileShader {
+  GLuint program = 0;
+  GLint mapRect = -1;
+  GLint mapSize = -1;
+  GLint cameraPosition = -1;
+  GLint cameraZoom = -1;
+  GLint cameraRotation = -1;
+  GLint viewSize = -1;
+};
+
+TileShader tileShader;
+
+bool readFile(const std::string &path, std::string &contents) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    std::cerr << "GpuTileLayer: failed to open " << path << std::endl;
+    return false;
+  }
+
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  contents = buffer.str();
+  return true;
+}
+
+GLuint compileShader(GLenum type, const std::string &path) {
+  std::string source;
+  if (!readFile(path, source))
+    return 0;
+
+  GLuint shader = glCreateShader(type);
+  const char *text = source.c_str();
+  glShaderSource(shader, 1, &text, nullptr);
+  glCompileShader(shader);
+
+  GLint status = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if (status != GL_TRUE) {
+    char log[1024] = {};
+    glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+    std::cerr << "GpuTileLayer: failed to compile " << path << ":\n"
+              << log << std::endl;
+    glDeleteShader(shader);
+    return 0;
+  }
+
+  return shader;
+}
+
+} // namespace
+
+GpuTileLayer::GpuTileLayer()
+    : indexTexture(0), imageArray(0), infoTexture(0), mapWidth(0),
+      mapHeight(0), dirty(false), dirtyMinX(0), dirtyMinY(0), dirtyMaxX(0),
+      dirtyMaxY(0) {}
+
+GpuTileLayer::~GpuTileLayer() { destroy(); }
+
+std::string GpuTileLayer::getVertexShaderPath() {
+  return RESOURCES_PATH "shaders/tilemap.vert";
+}
+
+std::string GpuTileLayer::getFragmentShaderPath() {
+  return RESOURCES_PATH "shaders/tilemap.frag";
+}
+
+bool GpuTileLayer::reloadShader() {
+  GLuint vertex = compileShader(GL_VERTEX_SHADER, getVertexShaderPath());
+  GLuint fragment = compileShader(GL_FRAGMENT_SHADER, getFragmentShaderPath());
+  if (!vertex || !fragment) {
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    return false;
+  }
+
+  GLuint program = glCreateProgram();
+  glAttachShader(program, vertex);
+  glAttachShader(program, fragment);
+  glLinkProgram(program);
+  glDeleteShader(vertex);
+  glDeleteShader(fragment);
+
+  GLint status = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &status);
+  if (status != GL_TRUE) {
+    char log[1024] = {};
+    glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+    std::cerr << "GpuTileLayer: failed to link the tile map shader:\n"
+              << log << std::endl;
+    glDeleteProgram(program);
+    return false;
+  }
+
+  if (tileShader.program) {
+    glDeleteProgram(tileShader.program);
+  }
+
+  tileShader.program = program;
+  tileShader.mapRect = glGetUniformLocation(program, "u_mapRect");
+  tileShader.mapSize = glGetUniformLocation(program, "u_mapSize");
+  tileShader.cameraPosition = glGetUniformLocation(program, "u_cameraPosition");
+  tileShader.cameraZoom = glGetUniformLocation(program, "u_cameraZoom");
+  tileShader.cameraRotation = glGetUniformLocation(program, "u_cameraRotation");
+  tileShader.viewSize = glGetUniformLocation(program, "u_viewSize");
+
+  glUseProgram(program);
+  glUniform1i(glGetUniformLocation(program, "u_tileIndices"), 0);
+  glUniform1i(glGetUniformLocation(program, "u_tileImages"), 1);
+  glUniform1i(glGetUniformLocation(program, "u_tileInfo"), 2);
+  glUseProgram(0);
+
+  std::cout << "GpuTileLayer: loaded tile map shader" << std::endl;
+  return true;
+}
+
+bool GpuTileLayer::create(const TileMap &map) {
+  destroy();
+
+  if (!tileShader.program && !reloadShader())
+    return false;
+
+  Tileset *tileset = map.getTileset();
+  if (!tileset || map.getMapWidth() <= 0 || map.getMapHeight() <= 0)
+    return false;
+
+  // Tiles without an image are skipped by the quad path too
+  std::vector<Tile *> tiles;
+  std::vector<gl2d::Texture *> images;
+  for (Tile *tile : tileset->getAllTiles()) {
+    auto *image = static_cast<gl2d::Texture *>(
+        tileset->getTileTexture(tile->name));
+    if (image && image->id != 0) {
+      tiles.push_back(tile);
+      images.push_back(image);
+    }
+  }
+  if (images.empty() || images.size() > UINT16_MAX - 1)
+    return false;
+
+  // A texture array needs every layer to be the same size
+  glm::ivec2 imageSize = images[0]->GetSize();
+  for (gl2d::Texture *image : images) {
+    if (image->GetSize() != imageSize) {
+      std::cerr << "GpuTileLayer: tile images of " << tileset->getName()
+                << " differ in size, using the quad path" << std::endl;
+      return false;
+    }
+  }
+
+  // Keep the filtering the tile textures were loaded with
+  GLint minFilter = GL_NEAREST;
+  GLint magFilter = GL_NEAREST;
+  glBindTexture(GL_TEXTURE_2D, images[0]->id);
+  glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &minFilter);
+  glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &magFilter);
+  const bool mipmapped = minFilter != GL_NEAREST && minFilter != GL_LINEAR;
+
+  const GLsizei layers = static_cast<GLsizei>(images.size());
+  glGenTextures(1, &imageArray);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, imageArray);
+  glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, imageSize.x, imageSize.y,
+               layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, minFilter);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, magFilter);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  // The images are already on the GPU as separate textures; read them back
+  // once rather than decoding the files again
+  std::vector<unsigned char> pixels(imageSize.x * imageSize.y * 4);
+  std::vector<float> info(layers * 2 * 4);
+  for (GLsizei slot = 0; slot < layers; slot++) {
+    glBindTexture(GL_TEXTURE_2D, images[slot]->id);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D_ARRAY, imageArray);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, slot, imageSize.x,
+                    imageSize.y, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    // Same colour and texture coordinates TileMap::renderTile uses
+    const Tile *tile = tiles[slot];
+    float *tint = &info[slot * 4];
+    tint[0] = tile->tintColor.r;
+    tint[1] = tile->tintColor.g;
+    tint[2] = tile->tintColor.b;
+    tint[3] = tile->tintColor.a * tile->opacity;
+
+    glm::vec2 topLeft, topRight, bottomLeft, bottomRight;
+    tile->getTextureQuad(topLeft, topRight, bottomLeft, bottomRight);
+    float *uvRect = &info[(layers + slot) * 4];
+    uvRect[0] = topLeft.x;
+    uvRect[1] = topLeft.y;
+    uvRect[2] = bottomRight.x;
+    uvRect[3] = bottomRight.y;
+
+    slotsById[tile->id] = static_cast<uint16_t>(slot + 1);
+  }
+  if (mipmapped) {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, imageArray);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+  }
+
+  glGenTextures(1, &infoTexture);
+  glBindTexture(GL_TEXTURE_2D, infoTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, layers, 2, 0, GL_RGBA, GL_FLOAT,
+               info.data());
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  mapWidth = map.getMapWidth();
+  mapHeight = map.getMapHeight();
+  glGenTextures(1, &indexTexture);
+  glBindTexture(GL_TEXTURE_2D, indexTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, mapWidth, mapHeight, 0,
+               GL_RED_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  markDirty(0, 0, mapWidth, mapHeight);
+  uploadDirtyRegion(map);
+
+  std::cout << "GpuTileLayer: " << mapWidth << "x" << mapHeight << " map with "
+            << layers << " tile images" << std::endl;
+  return true;
+}
+
+void GpuTileLayer::destroy() {
+  GLuint textures[] = {indexTexture, imageArray, infoTexture};
+  if (indexTexture || imageArray || infoTexture) {
+    glDeleteTextures(3, textures);
+  }
+
+  indexTexture = 0;
+  imageArray = 0;
+  infoTexture = 0;
+  mapWidth = 0;
+  mapHeight = 0;
+  slotsById.clear();
+  dirty = false;
+}
+
+void GpuTileLayer::markDirty(int x, int y, int width, int height) {
+  int minX = std::max(x, 0);
+  int minY = std::max(y, 0);
+  int maxX = std::min(x + width, mapWidth) - 1;
+  int maxY = std::min(y + height, mapHeight) - 1;
+  if (minX > maxX || minY > maxY)
+    return;
+
+  if (!dirty) {
+    dirtyMinX = minX;
+    dirtyMinY = minY;
+    dirtyMaxX = maxX;
+    dirtyMaxY = maxY;
+    dirty = true;
+    return;
+  }
+
+  dirtyMinX = std::min(dirtyMinX, minX);
+  dirtyMinY = std::min(dirtyMinY, minY);
+  dirtyMaxX = std::max(dirtyMaxX, maxX);
+  dirtyMaxY = std::max(dirtyMaxY, maxY);
+}
+
+void GpuTileLayer::uploadDirtyRegion(const TileMap &map) {
+  if (!dirty || !indexTexture)
+    return;
+
+  const int width = dirtyMaxX - dirtyMinX + 1;
+  const int height = dirtyMaxY - dirtyMinY + 1;
+  std::vector<uint16_t> slots(width * height);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      auto it = slotsById.find(map.getTile(dirtyMinX + x, dirtyMinY + y));
+      slots[y * width + x] = it != slotsById.end() ? it->second : 0;
+    }
+  }
+
+  // Rows of 16 bit texels aren't 4 byte aligned for odd widths
+  GLint alignment = 4;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+  glBindTexture(GL_TEXTURE_2D, indexTexture);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyMinX, dirtyMinY, width, height,
+                  GL_RED_INTEGER, GL_UNSIGNED_SHORT, slots.data());
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+  dirty = false;
+}
+
+void GpuTileLayer::render(void *renderer, const TileMap &map) {
+  if (!indexTexture || !tileShader.program)
+    return;
+
+  uploadDirtyRegion(map);
+
+  auto *r = static_cast<gl2d::Renderer2D *>(renderer);
+  const glm::vec2 mapPosition = map.tileToWorldPosition(0, 0);
+  const glm::vec4 mapRect(
+      mapPosition.x, mapPosition.y,
+      static_cast<float>(mapWidth * map.getTilePixelWidth()),
+      static_cast<float>(mapHeight * map.getTilePixelHeight()));
+  const glm::vec2 mapSize(static_cast<float>(mapWidth),
+                          static_cast<float>(mapHeight));
+  const glm::vec2 viewSize(static_cast<float>(r->windowW),
+                           static_cast<float>(r->windowH));
+  const gl2d::Camera camera = r->currentCamera;
+  const GLuint indices = indexTexture;
+  const GLuint images = imageArray;
+  const GLuint info = infoTexture;
+
+  // Runs inside the flush, after the camera of this call may have changed,
+  // so everything it needs is captured now. The flush may happen on another
+  // renderer (and context), so the vao is the flushing renderer's: vaos
+  // aren't shared between contexts, and the quad comes from gl_VertexID so
+  // the shader reads no attributes anyway.
+  r->renderCustom([=](gl2d::Renderer2D &target) {
+    glUseProgram(tileShader.program);
+    glUniform4f(tileShader.mapRect, mapRect.x, mapRect.y, mapRect.z,
+                mapRect.w);
+    glUniform2f(tileShader.mapSize, mapSize.x, mapSize.y);
+    glUniform2f(tileShader.cameraPosition, camera.position.x,
+                camera.position.y);
+    glUniform1f(tileShader.cameraZoom, camera.zoom);
+    glUniform1f(tileShader.cameraRotation, glm::radians(camera.rotation));
+    glUniform2f(tileShader.viewSize, viewSize.x, viewSize.y);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, indices);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, images);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, info);
+
+    glBindVertexArray(target.vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+
+    target.stats.drawCalls++;
+  });
+}
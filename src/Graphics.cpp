@@ -0,0 +1,13 @@
+#include "Graphics.h"
+
+namespace {
+bool graphicsEnabled = true;
+}
+
+namespace Graphics {
+
+bool isEnabled() { return graphicsEnabled; }
+
+void setEnabled(bool enabled) { graphicsEnabled = enabled; }
+
+} // namespace Graphics
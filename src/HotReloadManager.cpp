@@ -1,15 +1,17 @@
 #include "HotReloadManager.h"
 #include "Application.h"
 #include "AudioManager.h"
+#include "GpuTileLayer.h"
 #include "SceneManager.h"
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 
 
 HotReloadManager::HotReloadManager()
     : application(nullptr), sceneManager(nullptr), audioManager(nullptr),
-      isEnabled(false) {}
+      isEnabled(false), coalescedReloadCount(0) {}
 
 HotReloadManager::~HotReloadManager() { shutdown(); }
 
@@ -44,6 +46,13 @@ void HotReloadManager::shutdown() {
   textureRegistry.clear();
   sceneRegistry.clear();
   audioRegistry.clear();
+  shaderRegistry.clear();
+
+  ReloadEvent discarded;
+  while (reloadQueue.pop(discarded)) {
+  }
+  deferredReloads.clear();
+  deferredPaths.clear();
 
   application = nullptr;
   sceneManager = nullptr;
@@ -61,7 +70,7 @@ void HotReloadManager::registerScene(const std::string &sceneName,
 
   fileWatcher.watchFile(
       filePath, FileType::SCENE,
-      [this](const std::string &path) { onSceneChanged(path); });
+      [this](const std::string &path) { queueReload(FileType::SCENE, path); });
 
   std::cout << "HotReloadManager: Registered scene " << sceneName << " -> "
             << filePath << std::endl;
@@ -76,12 +85,27 @@ void HotReloadManager::registerAudio(const std::string &soundId,
 
   fileWatcher.watchFile(
       filePath, FileType::AUDIO,
-      [this](const std::string &path) { onAudioChanged(path); });
+      [this](const std::string &path) { queueReload(FileType::AUDIO, path); });
 
   std::cout << "HotReloadManager: Registered audio " << soundId << " -> "
             << filePath << std::endl;
 }
 
+void HotReloadManager::registerShader(const std::string &shaderId,
+                                      const std::string &filePath) {
+  if (!isEnabled)
+    return;
+
+  shaderRegistry[shaderId] = filePath;
+
+  fileWatcher.watchFile(
+      filePath, FileType::SHADER,
+      [this](const std::string &path) { queueReload(FileType::SHADER, path); });
+
+  std::cout << "HotReloadManager: Registered shader " << shaderId << " -> "
+            << filePath << std::endl;
+}
+
 void HotReloadManager::reloadScene(const std::string &filePath) {
   std::cout << "HotReloadManager: Reloading scene " << filePath << std::endl;
 
@@ -93,34 +117,14 @@ void HotReloadManager::reloadScene(const std::string &filePath) {
     return;
   }
 
-  // Check if this is the currently active scene
-  if (sceneManager->getCurrentScene() &&
-      sceneManager->getCurrentScene()->getName() == sceneName) {
-    std::cout << "HotReloadManager: Reloading current scene " << sceneName
+  // Patches the loaded scene in place, only entities that actually changed
+  // are touched
+  if (sceneManager->reloadSceneFromFile(sceneName, filePath)) {
+    std::cout << "HotReloadManager: Successfully reloaded scene " << sceneName
               << std::endl;
-
-    // Reload the scene from file
-    if (sceneManager->loadSceneFromFile(sceneName, filePath)) {
-      // If successful, restart the current scene to apply changes
-      sceneManager->restartCurrentScene();
-      std::cout << "HotReloadManager: Successfully reloaded current scene "
-                << sceneName << std::endl;
-    } else {
-      std::cerr << "HotReloadManager: Failed to reload scene " << sceneName
-                << std::endl;
-    }
   } else {
-    // Scene is not currently active, just reload it in memory
-    std::cout << "HotReloadManager: Reloading inactive scene " << sceneName
+    std::cerr << "HotReloadManager: Failed to reload scene " << sceneName
               << std::endl;
-    sceneManager->unloadScene(sceneName);
-    if (sceneManager->loadSceneFromFile(sceneName, filePath)) {
-      std::cout << "HotReloadManager: Successfully reloaded inactive scene "
-                << sceneName << std::endl;
-    } else {
-      std::cerr << "HotReloadManager: Failed to reload scene " << sceneName
-                << std::endl;
-    }
   }
 }
 
@@ -145,6 +149,27 @@ void HotReloadManager::reloadAudio(const std::string &filePath) {
   }
 }
 
+void HotReloadManager::reloadShader(const std::string &filePath) {
+  std::cout << "HotReloadManager: Reloading shader " << filePath << std::endl;
+
+  std::string shaderId = getAssetIdFromPath(filePath, shaderRegistry);
+  if (shaderId.empty()) {
+    std::cout << "HotReloadManager: No registered shader found for path "
+              << filePath << std::endl;
+    return;
+  }
+
+  // The tile map shader is the only one loaded from files; a failed compile
+  // keeps the program that is already running
+  if (GpuTileLayer::reloadShader()) {
+    std::cout << "HotReloadManager: Successfully reloaded shader " << shaderId
+              << std::endl;
+  } else {
+    std::cerr << "HotReloadManager: Failed to reload shader " << shaderId
+              << std::endl;
+  }
+}
+
 void HotReloadManager::enable() {
   isEnabled = true;
   fileWatcher.setEnabled(true);
@@ -157,6 +182,10 @@ void HotReloadManager::disable() {
   std::cout << "HotReloadManager: Disabled" << std::endl;
 }
 
+void HotReloadManager::setWatchInterval(int milliseconds) {
+  fileWatcher.setPollInterval(milliseconds);
+}
+
 size_t HotReloadManager::getWatchedFileCount() const {
   return fileWatcher.getWatchedFileCount();
 }
@@ -165,6 +194,92 @@ std::vector<std::string> HotReloadManager::getWatchedFiles() const {
   return fileWatcher.getWatchedFiles();
 }
 
+void HotReloadManager::queueReload(FileType type,
+                                   const std::string &filePath) {
+  ReloadEvent event;
+  event.type = type;
+  event.path = filePath;
+  reloadQueue.push(std::move(event));
+}
+
+size_t HotReloadManager::processPendingReloads(double budgetMs) {
+  // Move everything the watcher produced since last frame into the deferred
+  // list, collapsing repeated changes of the same file into one reload
+  ReloadEvent event;
+  while (reloadQueue.pop(event)) {
+    if (deferredPaths.insert(event.path).second) {
+      deferredReloads.push_back(std::move(event));
+    } else {
+      coalescedReloadCount++;
+    }
+  }
+
+  if (deferredReloads.empty()) {
+    return 0;
+  }
+
+  if (onBeforeReload) {
+    onBeforeReload();
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  size_t applied = 0;
+
+  while (applied < deferredReloads.size()) {
+    if (applied > 0) {
+      double elapsedMs = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+      if (elapsedMs >= budgetMs) {
+        break;
+      }
+    }
+
+    const ReloadEvent &next = deferredReloads[applied];
+    deferredPaths.erase(next.path);
+    // A half-written or malformed file must not take the session down; the
+    // version loaded before stays in use until the next save fixes it
+    try {
+      applyReload(next);
+    } catch (const std::exception &e) {
+      std::cerr << "HotReloadManager: Error reloading " << next.path << ": "
+                << e.what() << std::endl;
+    }
+    applied++;
+  }
+
+  deferredReloads.erase(deferredReloads.begin(),
+                        deferredReloads.begin() + applied);
+
+  if (!deferredReloads.empty()) {
+    std::cout << "HotReloadManager: " << deferredReloads.size()
+              << " reload(s) deferred to the next frame" << std::endl;
+  }
+
+  return applied;
+}
+
+void HotReloadManager::applyReload(const ReloadEvent &event) {
+  switch (event.type) {
+  case FileType::SCENE:
+    onSceneChanged(event.path);
+    break;
+  case FileType::AUDIO:
+    onAudioChanged(event.path);
+    break;
+  case FileType::TEXTURE:
+    onTextureChanged(event.path);
+    break;
+  case FileType::SHADER:
+    onShaderChanged(event.path);
+    break;
+  default:
+    std::cout << "HotReloadManager: No reload handler for " << event.path
+              << std::endl;
+    break;
+  }
+}
+
 void HotReloadManager::onSceneChanged(const std::string &filePath) {
   std::cout << "HotReloadManager: Scene file changed: " << filePath
             << std::endl;
@@ -177,6 +292,12 @@ void HotReloadManager::onAudioChanged(const std::string &filePath) {
   reloadAudio(filePath);
 }
 
+void HotReloadManager::onShaderChanged(const std::string &filePath) {
+  std::cout << "HotReloadManager: Shader file changed: " << filePath
+            << std::endl;
+  reloadShader(filePath);
+}
+
 std::string HotReloadManager::getAssetIdFromPath(
     const std::string &filePath,
     const std::unordered_map<std::string, std::string> &registry) const {
@@ -199,8 +320,19 @@ void HotReloadManager::unregisterTexture(const std::string &assetId) {}
 void HotReloadManager::unregisterScene(const std::string &sceneName) {}
 void HotReloadManager::unregisterAudio(const std::string &soundId) {}
 void HotReloadManager::reloadTexture(const std::string &filePath) {}
-void HotReloadManager::reloadAllAssets() {}
-void HotReloadManager::setWatchInterval(int milliseconds) {}
+void HotReloadManager::reloadAllAssets() {
+  // Goes through the same queue as watcher events so the work is spread
+  // over frames like any other batch of changes
+  for (const auto &[sceneName, path] : sceneRegistry) {
+    queueReload(FileType::SCENE, path);
+  }
+  for (const auto &[soundId, path] : audioRegistry) {
+    queueReload(FileType::AUDIO, path);
+  }
+  for (const auto &[shaderId, path] : shaderRegistry) {
+    queueReload(FileType::SHADER, path);
+  }
+}
 void HotReloadManager::printStatus() const {}
 void HotReloadManager::watchDirectory(const std::string &directory,
                                       bool recursive) {}
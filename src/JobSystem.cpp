@@ -0,0 +1,326 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace {
+
+// Deque of the calling thread if it is a worker
+thread_local size_t workerIndex = std::numeric_limits<size_t>::max();
+
+// Tries before a worker with nothing to do goes to sleep
+constexpr int IDLE_SPINS = 64;
+
+} // namespace
+
+JobSystem &JobSystem::get() {
+  static JobSystem instance;
+  return instance;
+}
+
+JobSystem::JobSystem()
+    : initialized(false), mainThreadId(std::this_thread::get_id()),
+      queuedCount(0), sleepingCount(0), stopping(false) {
+  // Jobs scheduled before initialize run in wait() on the waiting thread
+  queues.push_back(std::make_unique<JobQueue>());
+}
+
+JobSystem::~JobSystem() { shutdown(); }
+
+bool JobSystem::initialize(int workerCount) {
+  if (initialized)
+    return true;
+
+  if (workerCount < 0) {
+    unsigned hardwareThreads = std::thread::hardware_concurrency();
+    workerCount = hardwareThreads > 1 ? static_cast<int>(hardwareThreads) - 1
+                                      : 0;
+  }
+
+  mainThreadId = std::this_thread::get_id();
+  stopping = false;
+
+  // Whatever was scheduled so far stays in the shared deque
+  std::unique_ptr<JobQueue> shared = std::move(queues.back());
+  queues.clear();
+  for (int i = 0; i < workerCount; i++) {
+    queues.push_back(std::make_unique<JobQueue>());
+  }
+  queues.push_back(std::move(shared));
+
+  for (int i = 0; i < workerCount; i++) {
+    workers.emplace_back(&JobSystem::workerLoop, this, static_cast<size_t>(i));
+  }
+
+  initialized = true;
+  std::cout << "JobSystem: started " << workerCount << " worker thread(s)"
+            << std::endl;
+  return true;
+}
+
+void JobSystem::shutdown() {
+  if (!initialized)
+    return;
+
+  // Workers only leave once the deques are empty
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  wakeUp.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+
+  // Nothing left unless there were no workers
+  Job job;
+  const size_t shared = queues.size() - 1;
+  while (popOrSteal(shared, job)) {
+    execute(job, shared);
+  }
+  runMainThreadJobs();
+
+  queues.erase(queues.begin(), queues.end() - 1);
+  queues.back()->executed = 0;
+  queues.back()->stolen = 0;
+  initialized = false;
+  std::cout << "JobSystem: stopped" << std::endl;
+}
+
+bool JobSystem::isMainThread() const {
+  return std::this_thread::get_id() == mainThreadId;
+}
+
+void JobSystem::schedule(std::function<void()> function, JobCounter *counter,
+                         JobCounter *after) {
+  if (counter) {
+    counter->value.fetch_add(1, std::memory_order_relaxed);
+  }
+  enqueue(Job{std::move(function), counter, false}, after);
+}
+
+void JobSystem::scheduleOnMainThread(std::function<void()> function,
+                                     JobCounter *counter, JobCounter *after) {
+  if (counter) {
+    counter->value.fetch_add(1, std::memory_order_relaxed);
+  }
+  enqueue(Job{std::move(function), counter, true}, after);
+}
+
+void JobSystem::wait(JobCounter &counter) {
+  const size_t index = currentQueueIndex();
+  const bool mainThread = isMainThread();
+
+  while (!counter.isDone()) {
+    if (mainThread && runMainThreadJobs() > 0)
+      continue;
+
+    Job job;
+    if (popOrSteal(index, job)) {
+      execute(job, index);
+    } else {
+      // What's left is running on other threads
+      std::this_thread::yield();
+    }
+  }
+
+  // The last job may still be in finish() holding the lock
+  std::lock_guard<std::mutex> lock(counter.dependentsMutex);
+}
+
+void JobSystem::parallelFor(
+    size_t count, size_t batchSize,
+    const std::function<void(size_t, size_t)> &function) {
+  if (count == 0)
+    return;
+
+  batchSize = std::max<size_t>(batchSize, 1);
+  const size_t threads = getWorkerCount() + 1;
+  if (threads == 1 || count <= batchSize) {
+    function(0, count);
+    return;
+  }
+
+  // A few batches per thread so threads that finish early can steal from
+  // slower ones, but none smaller than batchSize
+  const size_t batches =
+      std::min((count + batchSize - 1) / batchSize, threads * 4);
+  const size_t perBatch = (count + batches - 1) / batches;
+
+  JobCounter counter;
+  for (size_t begin = perBatch; begin < count; begin += perBatch) {
+    const size_t end = std::min(begin + perBatch, count);
+    schedule([&function, begin, end]() { function(begin, end); }, &counter);
+  }
+
+  function(0, perBatch);
+  wait(counter);
+}
+
+size_t JobSystem::runMainThreadJobs() {
+  if (!isMainThread())
+    return 0;
+
+  const size_t shared = queues.size() - 1;
+  size_t count = 0;
+  Job job;
+  while (mainThreadJobs.pop(job)) {
+    execute(job, shared);
+    count++;
+  }
+  return count;
+}
+
+size_t JobSystem::getExecutedCount() const {
+  size_t count = 0;
+  for (const auto &queue : queues) {
+    count += queue->executed.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+size_t JobSystem::getStolenCount() const {
+  size_t count = 0;
+  for (const auto &queue : queues) {
+    count += queue->stolen.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+void JobSystem::workerLoop(size_t index) {
+  PROFILE_THREAD(("Job worker " + std::to_string(index)).c_str());
+  workerIndex = index;
+
+  while (true) {
+    Job job;
+    bool found = false;
+    for (int spin = 0; spin < IDLE_SPINS && !found; spin++) {
+      found = popOrSteal(index, job);
+      if (!found)
+        std::this_thread::yield();
+    }
+    if (found) {
+      execute(job, index);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    sleepingCount++;
+    wakeUp.wait(lock, [this] { return queuedCount > 0 || stopping; });
+    sleepingCount--;
+    if (stopping && queuedCount == 0)
+      break;
+  }
+
+  workerIndex = std::numeric_limits<size_t>::max();
+}
+
+size_t JobSystem::currentQueueIndex() const {
+  const size_t shared = queues.size() - 1;
+  return workerIndex < shared ? workerIndex : shared;
+}
+
+void JobSystem::enqueue(Job job, JobCounter *after) {
+  if (after) {
+    // finish() takes the dependents under the same lock once the count
+    // reaches zero, so the job is either queued here or picked up there
+    std::lock_guard<std::mutex> lock(after->dependentsMutex);
+    if (!after->isDone()) {
+      after->dependents.push_back(std::move(job));
+      return;
+    }
+  }
+
+  if (job.mainThread) {
+    mainThreadJobs.push(std::move(job));
+  } else {
+    push(std::move(job));
+  }
+}
+
+void JobSystem::push(Job job) {
+  JobQueue &queue = *queues[currentQueueIndex()];
+  {
+    // Counted under the lock, so a thread taking the job can't decrement
+    // before this increment
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back(std::move(job));
+    queuedCount.fetch_add(1);
+  }
+
+  // Pairs with the sleeping count / queued count check in workerLoop: either
+  // the worker sees the job or we see the worker asleep
+  if (sleepingCount.load() > 0) {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    wakeUp.notify_one();
+  }
+}
+
+bool JobSystem::popOrSteal(size_t index, Job &job) {
+  if (queuedCount.load(std::memory_order_relaxed) == 0)
+    return false;
+
+  // Newest of our own first
+  {
+    JobQueue &own = *queues[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.jobs.empty()) {
+      job = std::move(own.jobs.back());
+      own.jobs.pop_back();
+      queuedCount.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  // Then the oldest of someone else's, starting after our own deque so
+  // thieves spread over the victims
+  const size_t count = queues.size();
+  for (size_t offset = 1; offset < count; offset++) {
+    JobQueue &victim = *queues[(index + offset) % count];
+    std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+    if (!lock.owns_lock() || victim.jobs.empty())
+      continue;
+
+    job = std::move(victim.jobs.front());
+    victim.jobs.pop_front();
+    queuedCount.fetch_sub(1, std::memory_order_relaxed);
+    queues[index]->stolen.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+void JobSystem::execute(Job &job, size_t index) {
+  job.function();
+  queues[index]->executed.fetch_add(1, std::memory_order_relaxed);
+
+  if (job.counter) {
+    finish(*job.counter);
+  }
+}
+
+void JobSystem::finish(JobCounter &counter) {
+  // Not the last job: the decrement is the last touch of the counter
+  int value = counter.value.load(std::memory_order_relaxed);
+  while (value > 1) {
+    if (counter.value.compare_exchange_weak(value, value - 1,
+                                            std::memory_order_acq_rel))
+      return;
+  }
+
+  // The count only reaches zero under the lock, and wait() takes the lock
+  // before returning, so the counter can't be destroyed while it is held
+  std::vector<Job> ready;
+  {
+    std::lock_guard<std::mutex> lock(counter.dependentsMutex);
+    if (counter.value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      ready.swap(counter.dependents);
+    }
+  }
+  for (Job &job : ready) {
+    enqueue(std::move(job), nullptr);
+  }
+}
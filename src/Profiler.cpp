@@ -0,0 +1,260 @@
+#include "Profiler.h"
+
+#if CROWNFLAME_PROFILER
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// Hands the calling thread's buffer back to the profiler when it exits
+struct ThreadBufferOwner {
+  Profiler::ThreadBuffer *buffer = nullptr;
+
+  ~ThreadBufferOwner() {
+    if (buffer) {
+      Profiler::get().releaseThreadBuffer(buffer);
+    }
+  }
+};
+
+namespace {
+
+void writeJsonString(std::ofstream &out, const std::string &text) {
+  out << '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) >= 0x20) {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+} // namespace
+
+Profiler &Profiler::get() {
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::Profiler() {
+  epochTicks = now();
+
+#if PROFILER_USE_RDTSC
+  // Measure the timestamp counter against the steady clock once; modern CPUs
+  // have an invariant TSC so the rate does not change afterwards
+  auto clockStart = std::chrono::steady_clock::now();
+  uint64_t tickStart = now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  uint64_t tickEnd = now();
+  double elapsedMs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - clockStart)
+                         .count();
+  if (elapsedMs > 0.0 && tickEnd > tickStart) {
+    ticksPerMs = (tickEnd - tickStart) / elapsedMs;
+  }
+#else
+  using Period = std::chrono::steady_clock::period;
+  ticksPerMs = static_cast<double>(Period::den) / (Period::num * 1000.0);
+#endif
+}
+
+Profiler::ThreadBuffer &Profiler::threadBuffer() {
+  thread_local ThreadBufferOwner owner;
+  if (!owner.buffer) {
+    owner.buffer = get().acquireThreadBuffer();
+  }
+  return *owner.buffer;
+}
+
+Profiler::ThreadBuffer *Profiler::acquireThreadBuffer() {
+  std::lock_guard<std::mutex> lock(buffersMutex);
+
+  // Short-lived threads (scene preloads) reuse the buffer of one that exited
+  // instead of growing the list
+  for (auto &buffer : buffers) {
+    if (!buffer->inUse) {
+      buffer->inUse = true;
+      buffer->depth = 0;
+      buffer->name = "Thread " + std::to_string(buffer->index);
+      return buffer.get();
+    }
+  }
+
+  auto buffer = std::make_unique<ThreadBuffer>();
+  buffer->zones.resize(ThreadBuffer::CAPACITY);
+  buffer->index = static_cast<uint32_t>(buffers.size());
+  buffer->inUse = true;
+  buffer->name = "Thread " + std::to_string(buffer->index);
+  buffers.push_back(std::move(buffer));
+  return buffers.back().get();
+}
+
+void Profiler::releaseThreadBuffer(ThreadBuffer *buffer) {
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  buffer->inUse = false;
+}
+
+void Profiler::setThreadName(const char *name) {
+  ThreadBuffer &buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  buffer.name = name;
+}
+
+void Profiler::beginFrame() {
+  uint64_t frameStart = now();
+
+  if (currentFrameStart != 0 && !isPaused()) {
+    uint64_t count = frameCount.load(std::memory_order_relaxed);
+    frames[count % MAX_FRAMES] = {currentFrameStart, frameStart};
+    frameCount.store(count + 1, std::memory_order_release);
+  }
+  currentFrameStart = frameStart;
+}
+
+size_t Profiler::getFrameCount() const {
+  uint64_t count = frameCount.load(std::memory_order_acquire);
+  return static_cast<size_t>(std::min<uint64_t>(count, MAX_FRAMES));
+}
+
+bool Profiler::getFrame(size_t framesAgo, Frame &frame) const {
+  uint64_t count = frameCount.load(std::memory_order_acquire);
+  if (framesAgo >= std::min<uint64_t>(count, MAX_FRAMES))
+    return false;
+
+  frame = frames[(count - 1 - framesAgo) % MAX_FRAMES];
+  return true;
+}
+
+double Profiler::getFrameMs(size_t framesAgo) const {
+  Frame frame;
+  return getFrame(framesAgo, frame) ? ticksToMs(frame.end - frame.start)
+                                    : 0.0;
+}
+
+double Profiler::ticksToMs(uint64_t ticks) const {
+  return static_cast<double>(ticks) / ticksPerMs;
+}
+
+void Profiler::snapshot(const ThreadBuffer &buffer, uint64_t fromTicks,
+                        std::vector<Zone> &out) const {
+  const uint64_t mask = ThreadBuffer::CAPACITY - 1;
+  uint64_t end = buffer.written.load(std::memory_order_acquire);
+  uint64_t begin = end > ThreadBuffer::CAPACITY ? end - ThreadBuffer::CAPACITY
+                                                : 0;
+
+  // Zones are written when they end, so walking back from the newest one
+  // can stop at the first zone that ended before the range
+  std::vector<uint64_t> slots;
+  size_t first = out.size();
+  for (uint64_t i = end; i-- > begin;) {
+    const Zone &zone = buffer.zones[i & mask];
+    if (zone.end < fromTicks)
+      break;
+    out.push_back(zone);
+    slots.push_back(i);
+  }
+
+  // The owning thread keeps writing while we copy; drop anything it may
+  // have overwritten in the meantime
+  uint64_t after = buffer.written.load(std::memory_order_acquire);
+  uint64_t validFrom =
+      after > ThreadBuffer::CAPACITY ? after - ThreadBuffer::CAPACITY : 0;
+  size_t keep = 0;
+  while (keep < slots.size() && slots[keep] >= validFrom) {
+    keep++;
+  }
+  out.resize(first + keep);
+}
+
+std::vector<Profiler::ZoneRecord>
+Profiler::collectZones(uint64_t start, uint64_t end) const {
+  std::vector<ZoneRecord> records;
+  std::vector<Zone> zones;
+
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  for (const auto &buffer : buffers) {
+    zones.clear();
+    snapshot(*buffer, start, zones);
+
+    for (const Zone &zone : zones) {
+      if (zone.start < start || zone.start >= end)
+        continue;
+      records.push_back({zone.name, ticksToMs(zone.start - start),
+                         ticksToMs(zone.end - zone.start), zone.depth,
+                         buffer->index});
+    }
+  }
+
+  std::sort(records.begin(), records.end(),
+            [](const ZoneRecord &a, const ZoneRecord &b) {
+              if (a.thread != b.thread)
+                return a.thread < b.thread;
+              if (a.startMs != b.startMs)
+                return a.startMs < b.startMs;
+              return a.depth < b.depth;
+            });
+  return records;
+}
+
+size_t Profiler::getThreadCount() const {
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  return buffers.size();
+}
+
+std::string Profiler::getThreadName(uint32_t index) const {
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  return index < buffers.size() ? buffers[index]->name : std::string();
+}
+
+bool Profiler::exportChromeTrace(const std::string &path) const {
+  std::ofstream out(path);
+  if (!out.is_open()) {
+    std::cerr << "Profiler: failed to open " << path << std::endl;
+    return false;
+  }
+
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  size_t zoneCount = 0;
+  bool first = true;
+  std::vector<Zone> zones;
+
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  for (const auto &buffer : buffers) {
+    out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\","
+        << "\"pid\":1,\"tid\":" << buffer->index << ",\"args\":{\"name\":";
+    writeJsonString(out, buffer->name);
+    out << "}}";
+    first = false;
+
+    zones.clear();
+    snapshot(*buffer, 0, zones);
+    for (auto it = zones.rbegin(); it != zones.rend(); ++it) {
+      // Timestamps are microseconds since the profiler started
+      out << ",\n{\"name\":";
+      writeJsonString(out, it->name);
+      out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->index
+          << ",\"ts\":" << ticksToMs(it->start - epochTicks) * 1000.0
+          << ",\"dur\":" << ticksToMs(it->end - it->start) * 1000.0 << "}";
+      zoneCount++;
+    }
+  }
+
+  out << "\n]}\n";
+  if (!out.good()) {
+    std::cerr << "Profiler: failed to write " << path << std::endl;
+    return false;
+  }
+
+  std::cout << "Profiler: wrote " << zoneCount << " zones to " << path
+            << std::endl;
+  return true;
+}
+
+#endif
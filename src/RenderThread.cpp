@@ -0,0 +1,178 @@
+#include "RenderThread.h"
+#include "Profiler.h"
+#include <GLFW/glfw3.h>
+#include <iostream>
+
+void RenderSnapshot::clear() {
+  drawData.clearDrawData();
+  ui.clear();
+  if (uploadFence) {
+    glDeleteSync(uploadFence);
+    uploadFence = nullptr;
+  }
+}
+
+RenderThread::RenderThread()
+    : window(nullptr), renderer(nullptr), vsync(true), hasPending(false),
+      drawing(false), stopRequested(false), pauseRequested(false),
+      paused(false) {}
+
+RenderThread::~RenderThread() { stop(); }
+
+bool RenderThread::start(GLFWwindow *window, gl2d::Renderer2D *renderer,
+                         bool vsync) {
+  if (isRunning() || !window || !renderer)
+    return false;
+
+  this->window = window;
+  this->renderer = renderer;
+  this->vsync = vsync;
+  hasPending = false;
+  drawing = false;
+  stopRequested = false;
+  pauseRequested = false;
+  paused = false;
+
+  thread = std::thread(&RenderThread::renderLoop, this);
+  std::cout << "RenderThread: started" << std::endl;
+  return true;
+}
+
+void RenderThread::stop() {
+  if (!isRunning())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopRequested = true;
+  }
+  changed.notify_all();
+  thread.join();
+
+  // Spare buffers and the copied UI of the last frames
+  pending.clear();
+  ui.clear();
+  std::cout << "RenderThread: stopped" << std::endl;
+}
+
+void RenderThread::submit(RenderSnapshot &snapshot) {
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this] { return !hasPending; });
+
+  // pending holds the (emptied) buffers of an earlier frame, trading them
+  // keeps the allocations circulating instead of growing new ones
+  pending.drawData.swapDrawData(snapshot.drawData);
+  pending.ui.swap(snapshot.ui);
+  std::swap(pending.width, snapshot.width);
+  std::swap(pending.height, snapshot.height);
+  std::swap(pending.uploadFence, snapshot.uploadFence);
+  hasPending = true;
+
+  lock.unlock();
+  changed.notify_all();
+}
+
+void RenderThread::waitForIdle() {
+  if (!isRunning())
+    return;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this] { return !hasPending && !drawing; });
+}
+
+void RenderThread::pause() {
+  if (!isRunning())
+    return;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  pauseRequested = true;
+  changed.notify_all();
+  changed.wait(lock, [this] { return paused; });
+}
+
+void RenderThread::resume() {
+  if (!isRunning())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pauseRequested = false;
+  }
+  changed.notify_all();
+}
+
+gl2d::RenderStats RenderThread::getLastStats() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return lastStats;
+}
+
+void RenderThread::renderLoop() {
+  PROFILE_THREAD("Render");
+  glfwMakeContextCurrent(window);
+  glfwSwapInterval(vsync ? 1 : 0);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    changed.wait(lock, [this] {
+      return hasPending || stopRequested || pauseRequested;
+    });
+
+    // Queued frames are drawn before pausing or stopping
+    if (hasPending) {
+      renderer->swapDrawData(pending.drawData);
+      ui.swap(pending.ui);
+      const int width = pending.width;
+      const int height = pending.height;
+      GLsync uploadFence = pending.uploadFence;
+      pending.uploadFence = nullptr;
+      hasPending = false;
+      drawing = true;
+
+      lock.unlock();
+      changed.notify_all(); // The slot is free for the next snapshot
+      drawFrame(width, height, uploadFence);
+      lock.lock();
+
+      drawing = false;
+      lastStats = renderer->stats;
+      changed.notify_all();
+    } else if (stopRequested) {
+      break;
+    } else {
+      glfwMakeContextCurrent(nullptr);
+      paused = true;
+      changed.notify_all();
+      changed.wait(lock, [this] { return !pauseRequested || stopRequested; });
+      paused = false;
+      if (stopRequested)
+        break;
+      glfwMakeContextCurrent(window);
+    }
+  }
+
+  glfwMakeContextCurrent(nullptr);
+}
+
+void RenderThread::drawFrame(int width, int height, GLsync uploadFence) {
+  PROFILE_SCOPE("RenderThread::drawFrame");
+
+  // Textures and buffers the main thread filled for this frame
+  if (uploadFence) {
+    glWaitSync(uploadFence, 0, GL_TIMEOUT_IGNORED);
+    glDeleteSync(uploadFence);
+  }
+
+  renderer->resetStats();
+  renderer->updateWindowMetrics(width, height);
+  glViewport(0, 0, width, height);
+  glClear(GL_COLOR_BUFFER_BIT);
+
+  {
+    PROFILE_SCOPE("gl2d flush");
+    renderer->flush();
+  }
+  UIManager::renderDrawData(ui);
+
+  PROFILE_SCOPE("Swap buffers");
+  glfwSwapBuffers(window);
+}
@@ -4,13 +4,14 @@
 
 Scene::Scene()
     : isLoaded(false), isActive(false), gameWorld(nullptr),
-      initialCollectibleCount(0), initialEnemyCount(0),
-      completionTriggered(false) {}
+      assetManager(nullptr), initialCollectibleCount(0), initialEnemyCount(0),
+      completionTriggered(false), screenWidth(800), screenHeight(600) {}
 
 Scene::Scene(const SceneData::SceneDefinition &definition)
     : sceneDefinition(definition), isLoaded(false), isActive(false),
-      gameWorld(nullptr), initialCollectibleCount(0), initialEnemyCount(0),
-      completionTriggered(false) {}
+      gameWorld(nullptr), assetManager(nullptr), initialCollectibleCount(0),
+      initialEnemyCount(0), completionTriggered(false), screenWidth(800),
+      screenHeight(600) {}
 
 Scene::~Scene() { unloadScene(); }
 
@@ -23,8 +24,18 @@ bool Scene::loadScene(int screenWidth, int screenHeight) {
 
   std::cout << "Loading scene: " << sceneDefinition.name << std::endl;
 
+  this->screenWidth = screenWidth;
+  this->screenHeight = screenHeight;
+
   // Create a new GameWorld instance
   gameWorld = std::make_unique<GameWorld>();
+  // Before initializing, the world loads its textures through it
+  gameWorld->setAssetManager(assetManager);
+
+  // The tilemap built by initializeEmpty is sized to the world, which it
+  // then snaps to whole tiles
+  gameWorld->setWorldSize(sceneDefinition.world.width,
+                          sceneDefinition.world.height);
 
   // Initialize the GameWorld with basic settings (no default objects)
   gameWorld->initializeEmpty(screenWidth, screenHeight);
@@ -49,6 +60,9 @@ bool Scene::loadScene(int screenWidth, int screenHeight) {
   initialEnemyCount = static_cast<int>(sceneDefinition.enemies.size());
   completionTriggered = false;
 
+  // Restarts restore this instead of rebuilding the world
+  gameWorld->captureInitialState();
+
   isLoaded = true;
   std::cout << "Scene '" << sceneDefinition.name << "' loaded successfully."
             << std::endl;
@@ -82,6 +96,24 @@ void Scene::deactivateScene() {
   std::cout << "Deactivated scene: " << sceneDefinition.name << std::endl;
 }
 
+bool Scene::restartScene() {
+  if (!isLoaded || !gameWorld)
+    return false;
+
+  if (!gameWorld->restoreInitialState()) {
+    gameWorld->clearEntities();
+    applySceneSettings();
+    createSceneObjects();
+    gameWorld->captureInitialState();
+  }
+
+  initialCollectibleCount =
+      static_cast<int>(sceneDefinition.collectibles.size());
+  initialEnemyCount = static_cast<int>(sceneDefinition.enemies.size());
+  completionTriggered = false;
+  return true;
+}
+
 void Scene::update(float deltaTime) {
   if (!isLoaded || !isActive || !gameWorld)
     return;
@@ -135,11 +167,152 @@ void Scene::setDefinition(const SceneData::SceneDefinition &definition) {
 
   // If already loaded, need to reload
   if (isLoaded) {
-    // Use default screen dimensions since GameWorld doesn't expose getters
-    int currentWidth = 800;
-    int currentHeight = 600;
+    bool wasActive = isActive;
     unloadScene();
-    loadScene(currentWidth, currentHeight);
+    loadScene(screenWidth, screenHeight);
+    isActive = wasActive;
+  }
+}
+
+bool Scene::applyDefinition(const SceneData::SceneDefinition &definition) {
+  if (!isLoaded || !gameWorld) {
+    sceneDefinition = definition;
+    return true;
+  }
+
+  SceneData::SceneDiff diff =
+      SceneData::diffScenes(sceneDefinition, definition);
+  if (diff.isEmpty()) {
+    std::cout << "Scene '" << sceneDefinition.name
+              << "' unchanged, nothing to apply." << std::endl;
+    return true;
+  }
+
+  if (diff.requiresFullReload()) {
+    std::cout << "Scene '" << sceneDefinition.name
+              << "' needs a full reload (" << diff.describe() << ")"
+              << std::endl;
+    return false;
+  }
+
+  if (!diff.obstacles.isEmpty()) {
+    patchObjects(ObjectType::OBSTACLE, diff.obstacles, definition);
+    // The current path was planned around the old obstacles
+    gameWorld->stopPathfinding();
+  }
+  if (!diff.collectibles.isEmpty()) {
+    patchObjects(ObjectType::COLLECTIBLE, diff.collectibles, definition);
+  }
+  if (!diff.enemies.isEmpty()) {
+    patchEnemies(diff.enemies, definition);
+  }
+
+  sceneDefinition = definition;
+
+  if (diff.cameraChanged) {
+    applySceneSettings();
+  }
+
+  // The snapshot describes the old layout, the next restart rebuilds the
+  // entities from the new definition instead
+  gameWorld->invalidateInitialState();
+
+  // The player keeps its current position, a moved spawn point takes effect
+  // on the next restart.
+  initialCollectibleCount =
+      static_cast<int>(sceneDefinition.collectibles.size());
+  initialEnemyCount = static_cast<int>(sceneDefinition.enemies.size());
+  completionTriggered = completionTriggered && isSceneComplete();
+
+  std::cout << "Scene '" << sceneDefinition.name
+            << "' patched in place: " << diff.describe() << std::endl;
+  return true;
+}
+
+void Scene::patchObjects(ObjectType type, const SceneData::ListDiff &diff,
+                         const SceneData::SceneDefinition &definition) {
+  const int oldCount = static_cast<int>(diff.oldToNew.size());
+
+  // Collect first, removing while iterating would invalidate the loop.
+  // Collectibles that were already picked up have no live object and stay
+  // collected.
+  std::vector<GameObject *> removed;
+  for (const auto &object : gameWorld->getObjects()) {
+    if (object->type != type || object->sourceIndex < 0 ||
+        object->sourceIndex >= oldCount)
+      continue;
+
+    int oldIndex = object->sourceIndex;
+    int newIndex = diff.oldToNew[oldIndex];
+    if (newIndex < 0) {
+      removed.push_back(object.get());
+      continue;
+    }
+
+    object->sourceIndex = newIndex;
+    if (!diff.changed[oldIndex])
+      continue;
+
+    if (type == ObjectType::OBSTACLE) {
+      const auto &data = definition.obstacles[newIndex];
+      object->bounds = Rectangle(data.x, data.y, data.width, data.height);
+      object->color = data.color;
+    } else {
+      const auto &data = definition.collectibles[newIndex];
+      object->bounds.x = data.x;
+      object->bounds.y = data.y;
+      object->color = data.color;
+    }
+  }
+
+  // Bounds were edited in place
+  gameWorld->invalidateObjectGrid();
+
+  for (GameObject *object : removed) {
+    gameWorld->removeObject(object);
+  }
+
+  for (size_t index : diff.added) {
+    if (type == ObjectType::OBSTACLE) {
+      spawnObstacle(definition.obstacles[index], static_cast<int>(index));
+    } else {
+      spawnCollectible(definition.collectibles[index],
+                       static_cast<int>(index));
+    }
+  }
+}
+
+void Scene::patchEnemies(const SceneData::ListDiff &diff,
+                         const SceneData::SceneDefinition &definition) {
+  const int oldCount = static_cast<int>(diff.oldToNew.size());
+
+  // Movement state is derived from the pattern setup, so changed enemies
+  // are recreated rather than edited
+  std::vector<Enemy *> removed;
+  std::vector<size_t> respawn = diff.added;
+  for (const auto &enemy : gameWorld->getEnemies()) {
+    if (enemy->sourceIndex < 0 || enemy->sourceIndex >= oldCount)
+      continue;
+
+    int oldIndex = enemy->sourceIndex;
+    int newIndex = diff.oldToNew[oldIndex];
+    if (newIndex < 0 || diff.changed[oldIndex]) {
+      removed.push_back(enemy.get());
+      if (newIndex >= 0) {
+        respawn.push_back(static_cast<size_t>(newIndex));
+      }
+      continue;
+    }
+
+    enemy->sourceIndex = newIndex;
+  }
+
+  for (Enemy *enemy : removed) {
+    gameWorld->removeEnemy(enemy);
+  }
+
+  for (size_t index : respawn) {
+    spawnEnemy(definition.enemies[index], static_cast<int>(index));
   }
 }
 
@@ -149,7 +322,16 @@ void Scene::setAudioManager(AudioManager *audioManager) {
   }
 }
 
+void Scene::setAssetManager(AssetManager *assetManager) {
+  this->assetManager = assetManager;
+  if (gameWorld) {
+    gameWorld->setAssetManager(assetManager);
+  }
+}
+
 void Scene::updateScreenSize(int width, int height) {
+  screenWidth = width;
+  screenHeight = height;
   if (gameWorld) {
     gameWorld->updateScreenSize(width, height);
   }
@@ -160,8 +342,8 @@ void Scene::applySceneSettings() {
     return;
 
   // Apply world settings
-  // Note: GameWorld doesn't currently have setters for world size,
-  // but we can store these for future use or when GameWorld is extended
+  // Note: the world size is set once in loadScene, the tilemap is built to
+  // match it. Changing it later goes through a full reload.
 
   // Apply camera settings
   gameWorld->setCameraFollowSpeed(sceneDefinition.camera.followSpeed);
@@ -193,12 +375,9 @@ void Scene::createObstacles() {
   if (!gameWorld)
     return;
 
-  for (const auto &obstacle : sceneDefinition.obstacles) {
-    auto *obj = gameWorld->createObstacle(obstacle.x, obstacle.y,
-                                          obstacle.width, obstacle.height);
-    if (obj) {
-      obj->color = obstacle.color;
-    }
+  const auto &obstacles = sceneDefinition.obstacles;
+  for (size_t i = 0; i < obstacles.size(); i++) {
+    spawnObstacle(obstacles[i], static_cast<int>(i));
   }
 }
 
@@ -206,11 +385,9 @@ void Scene::createCollectibles() {
   if (!gameWorld)
     return;
 
-  for (const auto &collectible : sceneDefinition.collectibles) {
-    auto *obj = gameWorld->createCollectible(collectible.x, collectible.y);
-    if (obj) {
-      obj->color = collectible.color;
-    }
+  const auto &collectibles = sceneDefinition.collectibles;
+  for (size_t i = 0; i < collectibles.size(); i++) {
+    spawnCollectible(collectibles[i], static_cast<int>(i));
   }
 }
 
@@ -218,24 +395,53 @@ void Scene::createEnemies() {
   if (!gameWorld)
     return;
 
-  for (const auto &enemy : sceneDefinition.enemies) {
-    auto *enemyObj = gameWorld->createEnemy(enemy.x, enemy.y, enemy.pattern);
-    if (enemyObj) {
-      // Apply additional enemy settings
-      enemyObj->setMovementSpeed(enemy.speed);
+  const auto &enemies = sceneDefinition.enemies;
+  for (size_t i = 0; i < enemies.size(); i++) {
+    spawnEnemy(enemies[i], static_cast<int>(i));
+  }
+}
 
-      // Set patrol points for patrol enemies
-      if (enemy.pattern == MovementPattern::PATROL) {
-        enemyObj->setPatrolMovement(enemy.patrolPoint1, enemy.patrolPoint2);
-      }
+GameObject *Scene::spawnObstacle(const SceneData::ObstacleData &data,
+                                 int index) {
+  auto *obj = gameWorld->createObstacle(data.x, data.y, data.width,
+                                        data.height);
+  if (obj) {
+    obj->color = data.color;
+    obj->sourceIndex = index;
+  }
+  return obj;
+}
 
-      // Set center and radius for circular enemies
-      if (enemy.pattern == MovementPattern::CIRCULAR) {
-        glm::vec2 center(enemy.x, enemy.y);
-        enemyObj->setCircularMovement(center, enemy.radius);
-      }
+GameObject *Scene::spawnCollectible(const SceneData::CollectibleData &data,
+                                    int index) {
+  auto *obj = gameWorld->createCollectible(data.x, data.y);
+  if (obj) {
+    obj->color = data.color;
+    obj->sourceIndex = index;
+  }
+  return obj;
+}
+
+Enemy *Scene::spawnEnemy(const SceneData::EnemyData &data, int index) {
+  auto *enemyObj = gameWorld->createEnemy(data.x, data.y, data.pattern);
+  if (enemyObj) {
+    enemyObj->sourceIndex = index;
+
+    // Apply additional enemy settings
+    enemyObj->setMovementSpeed(data.speed);
+
+    // Set patrol points for patrol enemies
+    if (data.pattern == MovementPattern::PATROL) {
+      enemyObj->setPatrolMovement(data.patrolPoint1, data.patrolPoint2);
+    }
+
+    // Set center and radius for circular enemies
+    if (data.pattern == MovementPattern::CIRCULAR) {
+      glm::vec2 center(data.x, data.y);
+      enemyObj->setCircularMovement(center, data.radius);
     }
   }
+  return enemyObj;
 }
 
 void Scene::setupCamera() {
@@ -0,0 +1,239 @@
+#include "SceneDiff.h"
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+
+namespace SceneData {
+
+namespace {
+
+void hashCombine(size_t &seed, float value) {
+  seed ^= std::hash<float>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+void hashCombine(size_t &seed, const glm::vec2 &value) {
+  hashCombine(seed, value.x);
+  hashCombine(seed, value.y);
+}
+
+void hashCombine(size_t &seed, const glm::vec4 &value) {
+  hashCombine(seed, value.x);
+  hashCombine(seed, value.y);
+  hashCombine(seed, value.z);
+  hashCombine(seed, value.w);
+}
+
+bool isSame(const ObstacleData &a, const ObstacleData &b) {
+  return a.x == b.x && a.y == b.y && a.width == b.width &&
+         a.height == b.height && a.color == b.color;
+}
+
+bool isSame(const CollectibleData &a, const CollectibleData &b) {
+  return a.x == b.x && a.y == b.y && a.color == b.color;
+}
+
+bool isSame(const EnemyData &a, const EnemyData &b) {
+  return a.x == b.x && a.y == b.y && a.pattern == b.pattern &&
+         a.speed == b.speed && a.patrolPoint1 == b.patrolPoint1 &&
+         a.patrolPoint2 == b.patrolPoint2 && a.radius == b.radius;
+}
+
+size_t hashOf(const ObstacleData &data) {
+  size_t seed = 0;
+  hashCombine(seed, data.x);
+  hashCombine(seed, data.y);
+  hashCombine(seed, data.width);
+  hashCombine(seed, data.height);
+  hashCombine(seed, data.color);
+  return seed;
+}
+
+size_t hashOf(const CollectibleData &data) {
+  size_t seed = 0;
+  hashCombine(seed, data.x);
+  hashCombine(seed, data.y);
+  hashCombine(seed, data.color);
+  return seed;
+}
+
+size_t hashOf(const EnemyData &data) {
+  size_t seed = static_cast<size_t>(data.pattern);
+  hashCombine(seed, data.x);
+  hashCombine(seed, data.y);
+  hashCombine(seed, data.speed);
+  hashCombine(seed, data.patrolPoint1);
+  hashCombine(seed, data.patrolPoint2);
+  hashCombine(seed, data.radius);
+  return seed;
+}
+
+template <typename T>
+ListDiff diffList(const std::vector<T> &oldList,
+                  const std::vector<T> &newList) {
+  ListDiff diff;
+  diff.oldToNew.assign(oldList.size(), -1);
+  diff.changed.assign(oldList.size(), false);
+
+  std::vector<bool> newMatched(newList.size(), false);
+
+  // Pass 1: unchanged entries that kept their index (the common case when
+  // editing a single value in the file)
+  size_t common = std::min(oldList.size(), newList.size());
+  for (size_t i = 0; i < common; i++) {
+    if (isSame(oldList[i], newList[i])) {
+      diff.oldToNew[i] = static_cast<int>(i);
+      newMatched[i] = true;
+    }
+  }
+
+  // Pass 2: unchanged entries that moved because something was inserted or
+  // removed before them
+  std::unordered_multimap<size_t, size_t> unmatchedNew;
+  for (size_t j = 0; j < newList.size(); j++) {
+    if (!newMatched[j]) {
+      unmatchedNew.emplace(hashOf(newList[j]), j);
+    }
+  }
+  for (size_t i = 0; i < oldList.size() && !unmatchedNew.empty(); i++) {
+    if (diff.oldToNew[i] >= 0)
+      continue;
+
+    auto range = unmatchedNew.equal_range(hashOf(oldList[i]));
+    for (auto it = range.first; it != range.second; ++it) {
+      if (isSame(oldList[i], newList[it->second])) {
+        diff.oldToNew[i] = static_cast<int>(it->second);
+        newMatched[it->second] = true;
+        unmatchedNew.erase(it);
+        break;
+      }
+    }
+  }
+
+  // Pass 3: an unmatched old entry sitting between two matched neighbours is
+  // paired with an unmatched new entry between their new positions (an
+  // edit); anything left over is an addition or removal
+  std::vector<int> nextMatchedNew(oldList.size() + 1,
+                                  static_cast<int>(newList.size()));
+  for (size_t i = oldList.size(); i-- > 0;) {
+    nextMatchedNew[i] =
+        diff.oldToNew[i] >= 0 ? diff.oldToNew[i] : nextMatchedNew[i + 1];
+  }
+
+  int previousNew = -1;
+  for (size_t i = 0; i < oldList.size(); i++) {
+    if (diff.oldToNew[i] >= 0) {
+      previousNew = diff.oldToNew[i];
+      continue;
+    }
+
+    int candidate = -1;
+    for (int j = previousNew + 1; j < nextMatchedNew[i + 1]; j++) {
+      if (!newMatched[j]) {
+        candidate = j;
+        break;
+      }
+    }
+
+    if (candidate >= 0) {
+      diff.oldToNew[i] = candidate;
+      diff.changed[i] = true;
+      newMatched[candidate] = true;
+      diff.changedCount++;
+      previousNew = candidate;
+    } else {
+      diff.removedCount++;
+    }
+  }
+
+  for (size_t j = 0; j < newList.size(); j++) {
+    if (!newMatched[j]) {
+      diff.added.push_back(j);
+    }
+  }
+
+  return diff;
+}
+
+void describeList(std::ostringstream &out, const char *label,
+                  const ListDiff &diff, bool &first) {
+  if (diff.isEmpty())
+    return;
+
+  out << (first ? "" : ", ") << label << " +" << diff.added.size() << " -"
+      << diff.removedCount << " ~" << diff.changedCount;
+  first = false;
+}
+
+void describeFlag(std::ostringstream &out, const char *label, bool changed,
+                  bool &first) {
+  if (!changed)
+    return;
+
+  out << (first ? "" : ", ") << label;
+  first = false;
+}
+
+} // namespace
+
+std::string SceneDiff::describe() const {
+  if (isEmpty())
+    return "no changes";
+
+  std::ostringstream out;
+  bool first = true;
+  describeList(out, "obstacles", obstacles, first);
+  describeList(out, "collectibles", collectibles, first);
+  describeList(out, "enemies", enemies, first);
+  describeFlag(out, "world", worldChanged, first);
+  describeFlag(out, "camera", cameraChanged, first);
+  describeFlag(out, "player spawn", playerSpawnChanged, first);
+  describeFlag(out, "tilemap", tilemapChanged, first);
+  describeFlag(out, "metadata", metadataChanged, first);
+  return out.str();
+}
+
+SceneDiff diffScenes(const SceneDefinition &oldDefinition,
+                     const SceneDefinition &newDefinition) {
+  SceneDiff diff;
+
+  diff.obstacles = diffList(oldDefinition.obstacles, newDefinition.obstacles);
+  diff.collectibles =
+      diffList(oldDefinition.collectibles, newDefinition.collectibles);
+  diff.enemies = diffList(oldDefinition.enemies, newDefinition.enemies);
+
+  const WorldSettings &oldWorld = oldDefinition.world;
+  const WorldSettings &newWorld = newDefinition.world;
+  diff.worldChanged = oldWorld.width != newWorld.width ||
+                      oldWorld.height != newWorld.height ||
+                      oldWorld.backgroundColor != newWorld.backgroundColor ||
+                      oldWorld.backgroundMusic != newWorld.backgroundMusic;
+
+  const CameraSettings &oldCamera = oldDefinition.camera;
+  const CameraSettings &newCamera = newDefinition.camera;
+  diff.cameraChanged = oldCamera.followSpeed != newCamera.followSpeed ||
+                       oldCamera.followEnabled != newCamera.followEnabled ||
+                       oldCamera.startPosition != newCamera.startPosition;
+
+  diff.playerSpawnChanged =
+      oldDefinition.playerSpawn.x != newDefinition.playerSpawn.x ||
+      oldDefinition.playerSpawn.y != newDefinition.playerSpawn.y;
+
+  const TilemapSettings &oldTilemap = oldDefinition.tilemap;
+  const TilemapSettings &newTilemap = newDefinition.tilemap;
+  diff.tilemapChanged = oldTilemap.enabled != newTilemap.enabled ||
+                        oldTilemap.tilesetName != newTilemap.tilesetName ||
+                        oldTilemap.tileWidth != newTilemap.tileWidth ||
+                        oldTilemap.tileHeight != newTilemap.tileHeight ||
+                        oldTilemap.tileData != newTilemap.tileData;
+
+  diff.metadataChanged =
+      oldDefinition.name != newDefinition.name ||
+      oldDefinition.description != newDefinition.description ||
+      oldDefinition.nextScene != newDefinition.nextScene ||
+      oldDefinition.transitionTrigger != newDefinition.transitionTrigger;
+
+  return diff;
+}
+
+} // namespace SceneData
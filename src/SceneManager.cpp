@@ -1,14 +1,21 @@
 #include "SceneManager.h"
 #include "AudioManager.h"
+#include "Profiler.h"
+#include "RenderLayers.h"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <gl2d/gl2d.h>
 #include <iostream>
 #include <sstream>
 
 SceneManager::SceneManager()
-    : currentScene(nullptr), nextScene(nullptr), isTransitioning(false),
-      transitionProgress(0.0f), transitionTimer(0.0f), screenWidth(800),
-      screenHeight(600), audioManager(nullptr) {}
+    : currentScene(nullptr), nextScene(nullptr), maxResidentScenes(0),
+      sceneUseCounter(0), preloadTimer(0.0f), isTransitioning(false),
+      transitionProgress(0.0f), transitionTimer(0.0f), targetWidth(0),
+      targetHeight(0), transitionSwapFrame(-1), postSwapFramesLeft(0),
+      screenWidth(800), screenHeight(600), audioManager(nullptr),
+      assetManager(nullptr) {}
 
 SceneManager::~SceneManager() { shutdown(); }
 
@@ -27,6 +34,15 @@ void SceneManager::shutdown() {
   nextScene = nullptr;
   isTransitioning = false;
   audioManager = nullptr;
+
+  if (outgoingTarget) {
+    outgoingTarget->cleanup();
+    outgoingTarget.reset();
+  }
+  if (incomingTarget) {
+    incomingTarget->cleanup();
+    incomingTarget.reset();
+  }
 }
 
 bool SceneManager::loadSceneFromDefinition(
@@ -43,46 +59,96 @@ bool SceneManager::loadSceneFromDefinition(
     return false;
   }
 
-  auto scene = std::make_unique<Scene>(definition);
+  // The GameWorld is built when the scene is first needed
+  loadedScenes[sceneName] = std::make_unique<Scene>(definition);
 
-  if (!scene->loadScene(screenWidth, screenHeight)) {
-    std::cerr << "Failed to load scene '" << sceneName << "'" << std::endl;
-    return false;
+  std::cout << "Scene '" << sceneName << "' registered." << std::endl;
+  return true;
+}
+
+bool SceneManager::loadSceneFromFile(const std::string &sceneName,
+                                     const std::string &filePath) {
+  if (hasScene(sceneName)) {
+    std::cout << "Scene '" << sceneName << "' is already loaded." << std::endl;
+    return true;
   }
 
-  if (audioManager) {
-    scene->setAudioManager(audioManager);
+  std::ifstream file(filePath);
+  if (!file.is_open()) {
+    std::cerr << "Failed to load scene definition from file: " << filePath
+              << std::endl;
+    return false;
   }
 
-  loadedScenes[sceneName] = std::move(scene);
+  // Parsed on first use (or in the background when it is the next scene)
+  sceneFiles[sceneName] = filePath;
 
-  std::cout << "Scene '" << sceneName << "' loaded successfully." << std::endl;
+  std::cout << "Scene '" << sceneName << "' registered from file " << filePath
+            << std::endl;
   return true;
 }
 
-bool SceneManager::loadSceneFromFile(const std::string &sceneName,
-                                     const std::string &filePath) {
-  SceneData::SceneDefinition definition;
+bool SceneManager::reloadSceneFromFile(const std::string &sceneName,
+                                       const std::string &filePath) {
+  auto it = loadedScenes.find(sceneName);
+  if (it == loadedScenes.end()) {
+    // Not parsed yet, so it will pick up the new contents on first use. A
+    // background parse may have read the old ones though.
+    if (preloadSceneName == sceneName) {
+      cancelPreload();
+    }
+    return loadSceneFromFile(sceneName, filePath);
+  }
 
-  if (!loadSceneDefinitionFromFile(filePath, definition)) {
-    std::cerr << "Failed to load scene definition from file: " << filePath
+  // A live edit may be saved half-typed, the running version stays until
+  // the file parses again
+  SceneData::SceneDefinition definition;
+  bool parsed = false;
+  try {
+    parsed = loadSceneDefinitionFromFile(filePath, definition);
+  } catch (const std::exception &e) {
+    std::cerr << "Error parsing scene file " << filePath << ": " << e.what()
               << std::endl;
+  }
+  if (!parsed) {
+    std::cerr << "Failed to load scene definition from file: " << filePath
+              << ", keeping the current version" << std::endl;
     return false;
   }
-
-  // Always use the provided sceneName to avoid mismatches
-  std::cout << "Loading scene '" << sceneName
-            << "' from file, original name in file was '" << definition.name
-            << "'" << std::endl;
   definition.name = sceneName;
 
-  bool result = loadSceneFromDefinition(sceneName, definition);
-  if (result) {
-    std::cout << "Successfully loaded scene '" << sceneName << "'" << std::endl;
-  } else {
-    std::cout << "Failed to load scene '" << sceneName << "'" << std::endl;
+  if (!validateSceneDefinition(definition)) {
+    std::cerr << "Invalid scene definition for '" << sceneName
+              << "', keeping the current version" << std::endl;
+    return false;
+  }
+
+  Scene *scene = it->second.get();
+  if (scene->applyDefinition(definition)) {
+    return true;
+  }
+
+  // Structural change the live world can't absorb, rebuild the scene
+  bool wasActive = scene->isSceneActive();
+  unloadSceneWorld(scene);
+  scene->setDefinition(definition);
+  if (assetManager) {
+    scene->setAssetManager(assetManager);
+  }
+  if (!scene->loadScene(screenWidth, screenHeight)) {
+    std::cerr << "Failed to reload scene '" << sceneName << "'" << std::endl;
+    return false;
+  }
+
+  if (audioManager) {
+    scene->setAudioManager(audioManager);
+  }
+  if (wasActive) {
+    scene->activateScene();
   }
-  return result;
+
+  std::cout << "Scene '" << sceneName << "' fully reloaded." << std::endl;
+  return true;
 }
 
 void SceneManager::unloadScene(const std::string &sceneName) {
@@ -98,17 +164,26 @@ void SceneManager::unloadScene(const std::string &sceneName) {
     return;
   }
 
-  it->second->unloadScene();
+  if (preloadSceneName == sceneName) {
+    cancelPreload();
+  }
+
+  unloadSceneWorld(it->second.get());
   loadedScenes.erase(it);
+  sceneLastUsed.erase(sceneName);
 
   std::cout << "Scene '" << sceneName << "' unloaded." << std::endl;
 }
 
 void SceneManager::unloadAllScenes() {
+  cancelPreload();
+
   for (auto &pair : loadedScenes) {
-    pair.second->unloadScene();
+    unloadSceneWorld(pair.second.get());
   }
   loadedScenes.clear();
+  sceneFiles.clear();
+  sceneLastUsed.clear();
   currentScene = nullptr;
   nextScene = nullptr;
   std::cout << "All scenes unloaded." << std::endl;
@@ -121,19 +196,24 @@ bool SceneManager::changeScene(const std::string &sceneName,
     return false;
   }
 
-  auto it = loadedScenes.find(sceneName);
-  if (it == loadedScenes.end()) {
+  Scene *target = findOrCreateScene(sceneName);
+  if (!target) {
     std::cerr << "Scene '" << sceneName << "' is not loaded!" << std::endl;
     return false;
   }
 
-  nextScene = it->second.get();
-
-  if (currentScene == nextScene) {
+  if (currentScene == target) {
     std::cout << "Already in scene '" << sceneName << "'" << std::endl;
     return true;
   }
 
+  // Set before instantiating so eviction treats the target as in use
+  nextScene = target;
+  if (!instantiateScene(sceneName, target)) {
+    nextScene = nullptr;
+    return false;
+  }
+
   // Start transition
   if (transition.type == SceneData::TransitionType::INSTANT) {
     // Instant transition
@@ -145,6 +225,10 @@ bool SceneManager::changeScene(const std::string &sceneName,
     transitionProgress = 0.0f;
     transitionTimer = 0.0f;
 
+    transitionTrace.clear();
+    transitionSwapFrame = -1;
+    postSwapFramesLeft = 0;
+
     std::string currentName = currentScene ? currentScene->getName() : "none";
     std::cout << "Starting transition from '" << currentName << "' to '"
               << sceneName << "'" << std::endl;
@@ -167,25 +251,32 @@ void SceneManager::restartCurrentScene() {
     return;
 
   std::string sceneName = currentScene->getName();
-  SceneData::SceneDefinition definition = currentScene->getDefinition();
 
-  // Reload the scene
-  currentScene->unloadScene();
-  currentScene->setDefinition(definition);
-  currentScene->loadScene(screenWidth, screenHeight);
+  // Resets entities in place, a full rebuild is only needed if the world
+  // was never built
+  if (!currentScene->restartScene()) {
+    unloadSceneWorld(currentScene);
+    if (assetManager) {
+      currentScene->setAssetManager(assetManager);
+    }
+    currentScene->loadScene(screenWidth, screenHeight);
 
-  if (audioManager) {
-    currentScene->setAudioManager(audioManager);
-  }
+    if (audioManager) {
+      currentScene->setAudioManager(audioManager);
+    }
 
-  currentScene->activateScene();
+    currentScene->activateScene();
+  }
 
   std::cout << "Restarted scene '" << sceneName << "'" << std::endl;
 }
 
 void SceneManager::update(float deltaTime) {
+  PROFILE_SCOPE("SceneManager::update");
   if (isTransitioning) {
     updateTransition(deltaTime);
+  } else {
+    updatePreload(deltaTime);
   }
 
   // Update current scene
@@ -197,16 +288,28 @@ void SceneManager::update(float deltaTime) {
   checkAutoProgression();
 }
 
+void SceneManager::recordFrameTime(float frameTime) {
+  if (isTransitioning) {
+    transitionTrace.push_back(frameTime * 1000.0f);
+  } else if (postSwapFramesLeft > 0) {
+    transitionTrace.push_back(frameTime * 1000.0f);
+    if (--postSwapFramesLeft == 0) {
+      logTransitionTrace();
+    }
+  }
+}
+
 void SceneManager::render(void *renderer) {
+  // Both scenes are composited while transitioning
+  if (isTransitioning && ensureTransitionTargets()) {
+    renderTransition(renderer);
+    return;
+  }
+
   // Render current scene
   if (currentScene) {
     currentScene->render(renderer);
   }
-
-  // Render transition effects
-  if (isTransitioning) {
-    renderTransition(renderer);
-  }
 }
 
 const std::string &SceneManager::getCurrentSceneName() const {
@@ -215,12 +318,27 @@ const std::string &SceneManager::getCurrentSceneName() const {
 }
 
 bool SceneManager::hasScene(const std::string &sceneName) const {
-  return loadedScenes.find(sceneName) != loadedScenes.end();
+  return loadedScenes.find(sceneName) != loadedScenes.end() ||
+         sceneFiles.find(sceneName) != sceneFiles.end();
 }
 
 Scene *SceneManager::getScene(const std::string &sceneName) {
-  auto it = loadedScenes.find(sceneName);
-  return it != loadedScenes.end() ? it->second.get() : nullptr;
+  return findOrCreateScene(sceneName);
+}
+
+void SceneManager::setMaxResidentScenes(size_t count) {
+  maxResidentScenes = count;
+  evictIdleScenes();
+}
+
+size_t SceneManager::getResidentSceneCount() const {
+  size_t count = 0;
+  for (const auto &pair : loadedScenes) {
+    if (pair.second->isSceneLoaded()) {
+      count++;
+    }
+  }
+  return count;
 }
 
 void SceneManager::setAudioManager(AudioManager *manager) {
@@ -232,10 +350,26 @@ void SceneManager::setAudioManager(AudioManager *manager) {
   }
 }
 
+void SceneManager::setAssetManager(AssetManager *manager) {
+  assetManager = manager;
+
+  // Set for all loaded scenes
+  for (auto &pair : loadedScenes) {
+    pair.second->setAssetManager(manager);
+  }
+}
+
 void SceneManager::updateScreenSize(int width, int height) {
   screenWidth = width;
   screenHeight = height;
 
+  if (outgoingTarget && (targetWidth != width || targetHeight != height)) {
+    outgoingTarget->resize(width, height);
+    incomingTarget->resize(width, height);
+    targetWidth = width;
+    targetHeight = height;
+  }
+
   // Update all loaded scenes
   for (auto &pair : loadedScenes) {
     pair.second->updateScreenSize(width, height);
@@ -252,6 +386,18 @@ void SceneManager::setOnSceneTransitionStartedCallback(
   onSceneTransitionStarted = callback;
 }
 
+void SceneManager::setOnBeforeSceneUnloadCallback(
+    std::function<void()> callback) {
+  onBeforeSceneUnload = callback;
+}
+
+void SceneManager::unloadSceneWorld(Scene *scene) {
+  if (onBeforeSceneUnload) {
+    onBeforeSceneUnload();
+  }
+  scene->unloadScene();
+}
+
 bool SceneManager::saveSceneToFile(const std::string &sceneName,
                                    const std::string &filePath) const {
   auto it = loadedScenes.find(sceneName);
@@ -309,6 +455,12 @@ bool SceneManager::shouldAutoProgress() const {
 }
 
 void SceneManager::finishTransition() {
+  // Keep tracing for a moment so the cost of the swap itself is visible
+  if (isTransitioning) {
+    transitionSwapFrame = static_cast<int>(transitionTrace.size());
+    postSwapFramesLeft = POST_SWAP_TRACE_FRAMES;
+  }
+
   if (currentScene) {
     currentScene->deactivateScene();
   }
@@ -326,6 +478,11 @@ void SceneManager::finishTransition() {
     if (onSceneChanged) {
       onSceneChanged(currentScene->getName());
     }
+
+    // The previous scene is idle now, and the one after this can start
+    // preparing
+    evictIdleScenes();
+    startPreload(currentScene->getNextScene());
   }
 
   isTransitioning = false;
@@ -333,7 +490,206 @@ void SceneManager::finishTransition() {
   transitionTimer = 0.0f;
 }
 
+Scene *SceneManager::findOrCreateScene(const std::string &sceneName) {
+  auto it = loadedScenes.find(sceneName);
+  if (it != loadedScenes.end()) {
+    return it->second.get();
+  }
+
+  auto fileIt = sceneFiles.find(sceneName);
+  if (fileIt == sceneFiles.end()) {
+    return nullptr;
+  }
+
+  std::string filePath = fileIt->second;
+
+  // Use the background parse if there is one, it finishes quickly even if
+  // it is still running
+  SceneData::SceneDefinition definition;
+  bool parsed = false;
+  if (preloadSceneName == sceneName && preloadParse.valid()) {
+    parsed = preloadParse.get();
+    definition = std::move(preloadDefinition);
+    preloadDefinition = SceneData::SceneDefinition();
+  } else {
+    try {
+      parsed = loadSceneDefinitionFromFile(filePath, definition);
+    } catch (const std::exception &e) {
+      std::cerr << "Error parsing scene file " << filePath << ": " << e.what()
+                << std::endl;
+    }
+  }
+
+  if (!parsed) {
+    std::cerr << "Failed to load scene definition from file: " << filePath
+              << std::endl;
+    return nullptr;
+  }
+
+  // Always use the registered name to avoid mismatches
+  definition.name = sceneName;
+
+  if (!validateSceneDefinition(definition)) {
+    std::cerr << "Invalid scene definition for '" << sceneName << "'"
+              << std::endl;
+    return nullptr;
+  }
+
+  // Only now, a file that failed to parse stays registered so a fixed
+  // version can be loaded later
+  sceneFiles.erase(sceneName);
+
+  auto scene = std::make_unique<Scene>(definition);
+  Scene *scenePtr = scene.get();
+  loadedScenes[sceneName] = std::move(scene);
+  return scenePtr;
+}
+
+bool SceneManager::instantiateScene(const std::string &sceneName,
+                                    Scene *scene) {
+  sceneLastUsed[sceneName] = ++sceneUseCounter;
+
+  if (scene->isSceneLoaded()) {
+    return true;
+  }
+
+  // Textures are loaded while the world is built
+  if (assetManager) {
+    scene->setAssetManager(assetManager);
+  }
+  if (!scene->loadScene(screenWidth, screenHeight)) {
+    std::cerr << "Failed to load scene '" << sceneName << "'" << std::endl;
+    return false;
+  }
+
+  if (audioManager) {
+    scene->setAudioManager(audioManager);
+  }
+
+  evictIdleScenes();
+  return true;
+}
+
+bool SceneManager::isSceneInUse(const Scene *scene) const {
+  if (scene == currentScene || scene == nextScene) {
+    return true;
+  }
+
+  // Keep the scene we are about to progress to
+  return currentScene && !currentScene->getNextScene().empty() &&
+         scene->getName() == currentScene->getNextScene();
+}
+
+void SceneManager::evictIdleScenes() {
+  if (maxResidentScenes == 0)
+    return;
+
+  size_t residentCount = getResidentSceneCount();
+  while (residentCount > maxResidentScenes) {
+    Scene *victim = nullptr;
+    uint64_t oldestUse = UINT64_MAX;
+
+    for (auto &pair : loadedScenes) {
+      Scene *scene = pair.second.get();
+      if (!scene->isSceneLoaded() || isSceneInUse(scene))
+        continue;
+
+      auto usedIt = sceneLastUsed.find(pair.first);
+      uint64_t lastUsed = usedIt != sceneLastUsed.end() ? usedIt->second : 0;
+      if (lastUsed < oldestUse) {
+        oldestUse = lastUsed;
+        victim = scene;
+      }
+    }
+
+    // Everything still resident is in use
+    if (!victim)
+      break;
+
+    std::cout << "Evicting idle scene '" << victim->getName()
+              << "' (resident limit " << maxResidentScenes << ")"
+              << std::endl;
+    unloadSceneWorld(victim);
+    residentCount--;
+  }
+}
+
+void SceneManager::startPreload(const std::string &sceneName) {
+  cancelPreload();
+
+  if (sceneName.empty() || !hasScene(sceneName))
+    return;
+
+  // Already resident, nothing to prepare
+  auto it = loadedScenes.find(sceneName);
+  if (it != loadedScenes.end() && it->second->isSceneLoaded())
+    return;
+
+  preloadSceneName = sceneName;
+  preloadTimer = 0.0f;
+
+  auto fileIt = sceneFiles.find(sceneName);
+  if (fileIt != sceneFiles.end()) {
+    std::string filePath = fileIt->second;
+    preloadParse = std::async(std::launch::async, [this, filePath]() {
+      PROFILE_SCOPE("Scene preload parse");
+      // Caught here, get() would rethrow it on the main thread mid transition
+      try {
+        return loadSceneDefinitionFromFile(filePath, preloadDefinition);
+      } catch (const std::exception &e) {
+        std::cerr << "Error parsing scene file " << filePath << ": "
+                  << e.what() << std::endl;
+        return false;
+      }
+    });
+  }
+
+  std::cout << "Preloading next scene '" << sceneName << "'" << std::endl;
+}
+
+void SceneManager::cancelPreload() {
+  // The worker writes preloadDefinition, so it has to finish first
+  if (preloadParse.valid()) {
+    preloadParse.wait();
+    preloadParse = std::future<bool>();
+  }
+  preloadDefinition = SceneData::SceneDefinition();
+  preloadSceneName.clear();
+}
+
+void SceneManager::updatePreload(float deltaTime) {
+  if (preloadSceneName.empty())
+    return;
+
+  // Give the scene that was just activated a moment before adding more
+  // loading work to the main thread
+  preloadTimer += deltaTime;
+  if (preloadTimer < PRELOAD_DELAY)
+    return;
+
+  if (preloadParse.valid() &&
+      preloadParse.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready)
+    return;
+
+  std::string sceneName = preloadSceneName;
+  Scene *scene = findOrCreateScene(sceneName);
+  cancelPreload();
+
+  // GL resources (textures, fonts, tiles) have to be created on the main
+  // thread, so the GameWorld itself is built here
+  if (scene && instantiateScene(sceneName, scene)) {
+    std::cout << "Next scene '" << sceneName << "' is ready." << std::endl;
+  }
+}
+
 void SceneManager::updateTransition(float deltaTime) {
+  // The incoming scene is already built (changeScene instantiates it), let
+  // its camera settle on the player so it's ready the moment it is shown
+  if (nextScene && nextScene->getGameWorld()) {
+    nextScene->getGameWorld()->updateCamera(deltaTime);
+  }
+
   transitionTimer += deltaTime;
   transitionProgress = transitionTimer / currentTransition.duration;
 
@@ -344,6 +700,15 @@ void SceneManager::updateTransition(float deltaTime) {
 }
 
 void SceneManager::renderTransition(void *renderer) {
+  auto *gl2dRenderer = static_cast<gl2d::Renderer2D *>(renderer);
+
+  renderSceneToTarget(renderer, currentScene, *outgoingTarget);
+  renderSceneToTarget(renderer, nextScene, *incomingTarget);
+
+  // Composite in screen space
+  gl2dRenderer->setCamera(gl2d::Camera{});
+  gl2dRenderer->setLayer(RenderLayer::TRANSITION_SCENES);
+
   switch (currentTransition.type) {
   case SceneData::TransitionType::FADE_TO_BLACK:
     renderFadeTransition(renderer, transitionProgress);
@@ -355,63 +720,133 @@ void SceneManager::renderTransition(void *renderer) {
     renderSlideTransition(renderer, transitionProgress, currentTransition.type);
     break;
   default:
+    gl2dRenderer->renderRectangle(
+        {0, 0, (float)screenWidth, (float)screenHeight},
+        outgoingTarget->texture);
     break;
   }
 }
 
+bool SceneManager::ensureTransitionTargets() {
+  if (screenWidth <= 0 || screenHeight <= 0)
+    return false;
+
+  if (!outgoingTarget) {
+    outgoingTarget = std::make_unique<gl2d::FrameBuffer>();
+    incomingTarget = std::make_unique<gl2d::FrameBuffer>();
+    outgoingTarget->create(screenWidth, screenHeight);
+    incomingTarget->create(screenWidth, screenHeight);
+    targetWidth = screenWidth;
+    targetHeight = screenHeight;
+  }
+
+  return outgoingTarget->fbo != 0 && incomingTarget->fbo != 0;
+}
+
+void SceneManager::renderSceneToTarget(void *renderer, Scene *scene,
+                                       gl2d::FrameBuffer &target) {
+  auto *gl2dRenderer = static_cast<gl2d::Renderer2D *>(renderer);
+
+  target.clear();
+
+  GameWorld *world = scene ? scene->getGameWorld() : nullptr;
+  if (!world)
+    return;
+
+  // Each scene is drawn with its own camera
+  gl2d::Camera camera;
+  camera.position = world->getRenderCameraPosition();
+  gl2dRenderer->setCamera(camera);
+
+  world->render(renderer);
+
+  PROFILE_SCOPE("gl2d flushFBO");
+  gl2dRenderer->flushFBO(target);
+}
+
 void SceneManager::renderFadeTransition(void *renderer, float progress) {
   auto *gl2dRenderer = static_cast<gl2d::Renderer2D *>(renderer);
+  gl2d::Rect screenRect = {0, 0, (float)screenWidth, (float)screenHeight};
 
+  // Fade out of the old scene, then into the new one
   float alpha = 0.0f;
   if (progress < 0.5f) {
-    // Fade out
     alpha = progress * 2.0f;
+    gl2dRenderer->renderRectangle(screenRect, outgoingTarget->texture);
   } else {
-    // Fade in
     alpha = (1.0f - progress) * 2.0f;
+    gl2dRenderer->renderRectangle(screenRect, incomingTarget->texture);
   }
 
   glm::vec4 fadeColor = currentTransition.fadeColor;
   fadeColor.a = alpha;
 
   // Render fullscreen fade overlay
-  gl2dRenderer->renderRectangle({0, 0, (float)screenWidth, (float)screenHeight},
-                                fadeColor);
+  gl2dRenderer->setLayer(RenderLayer::TRANSITION_FADE);
+  gl2dRenderer->renderRectangle(screenRect, fadeColor);
 }
 
 void SceneManager::renderSlideTransition(void *renderer, float progress,
                                          SceneData::TransitionType type) {
-  // Slide transitions would require rendering both scenes offset
-  // This is a simplified implementation
   auto *gl2dRenderer = static_cast<gl2d::Renderer2D *>(renderer);
 
-  glm::vec2 offset(0.0f, 0.0f);
-
+  // Direction the outgoing scene leaves in, the incoming scene follows it
+  // in from the opposite side
+  glm::vec2 direction(0.0f, 0.0f);
   switch (type) {
   case SceneData::TransitionType::SLIDE_LEFT:
-    offset.x = -screenWidth * progress;
+    direction.x = -1.0f;
     break;
   case SceneData::TransitionType::SLIDE_RIGHT:
-    offset.x = screenWidth * progress;
+    direction.x = 1.0f;
     break;
   case SceneData::TransitionType::SLIDE_UP:
-    offset.y = -screenHeight * progress;
+    direction.y = -1.0f;
     break;
   case SceneData::TransitionType::SLIDE_DOWN:
-    offset.y = screenHeight * progress;
+    direction.y = 1.0f;
     break;
   default:
     break;
   }
 
-  // For now, just render a simple sliding overlay
-  float alpha = 0.8f * progress;
-  glm::vec4 slideColor = currentTransition.fadeColor;
-  slideColor.a = alpha;
+  glm::vec2 screenSize((float)screenWidth, (float)screenHeight);
+  glm::vec2 outgoingOffset = direction * screenSize * progress;
+  glm::vec2 incomingOffset = outgoingOffset - direction * screenSize;
 
   gl2dRenderer->renderRectangle(
-      {offset.x, offset.y, (float)screenWidth, (float)screenHeight},
-      slideColor);
+      {outgoingOffset.x, outgoingOffset.y, screenSize.x, screenSize.y},
+      outgoingTarget->texture);
+  gl2dRenderer->renderRectangle(
+      {incomingOffset.x, incomingOffset.y, screenSize.x, screenSize.y},
+      incomingTarget->texture);
+}
+
+void SceneManager::logTransitionTrace() const {
+  if (transitionSwapFrame < 0 ||
+      transitionSwapFrame >= static_cast<int>(transitionTrace.size()))
+    return;
+
+  // Median of the frames leading up to the swap is the baseline
+  std::vector<float> before(transitionTrace.begin(),
+                            transitionTrace.begin() + transitionSwapFrame);
+  if (before.empty())
+    return;
+  std::sort(before.begin(), before.end());
+  float median = before[before.size() / 2];
+
+  float swapFrame = transitionTrace[transitionSwapFrame];
+  float worstAfter =
+      *std::max_element(transitionTrace.begin() + transitionSwapFrame,
+                        transitionTrace.end());
+
+  // A frame more than 1.5x the baseline counts as a hitch
+  bool hitch = worstAfter > median * 1.5f;
+
+  std::cout << "Transition trace: " << transitionTrace.size()
+            << " frames, median " << median << " ms, swap frame " << swapFrame
+            << " ms, worst after swap " << worstAfter << " ms"
+            << (hitch ? " (HITCH)" : " (no hitch)") << std::endl;
 }
 
 bool SceneManager::validateSceneDefinition(
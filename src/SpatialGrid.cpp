@@ -0,0 +1,63 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : cellSize(cellSize), columns(1), rows(1), entryCount(0), cells(1) {}
+
+void SpatialGrid::reset(float worldWidth, float worldHeight) {
+  columns = std::max(1, static_cast<int>(std::ceil(worldWidth / cellSize)));
+  rows = std::max(1, static_cast<int>(std::ceil(worldHeight / cellSize)));
+  cells.resize(static_cast<size_t>(columns) * rows);
+  clear();
+}
+
+void SpatialGrid::clear() {
+  for (auto &cell : cells) {
+    cell.clear();
+  }
+  entryCount = 0;
+}
+
+void SpatialGrid::cellRange(const Rectangle &area, int &minX, int &minY,
+                            int &maxX, int &maxY) const {
+  // Clamp in float first, huge coordinates would overflow the int cast
+  auto toCell = [this](float coordinate, int count) {
+    float cell = std::floor(coordinate / cellSize);
+    return static_cast<int>(
+        std::min(std::max(cell, 0.0f), static_cast<float>(count - 1)));
+  };
+  minX = toCell(area.x, columns);
+  minY = toCell(area.y, rows);
+  maxX = toCell(area.x + area.width, columns);
+  maxY = toCell(area.y + area.height, rows);
+}
+
+void SpatialGrid::insert(uint32_t id, const Rectangle &bounds) {
+  int minX, minY, maxX, maxY;
+  cellRange(bounds, minX, minY, maxX, maxY);
+  for (int y = minY; y <= maxY; y++) {
+    for (int x = minX; x <= maxX; x++) {
+      cells[static_cast<size_t>(y) * columns + x].push_back(id);
+    }
+  }
+  entryCount++;
+}
+
+void SpatialGrid::query(const Rectangle &area,
+                        std::vector<uint32_t> &out) const {
+  out.clear();
+
+  int minX, minY, maxX, maxY;
+  cellRange(area, minX, minY, maxX, maxY);
+  for (int y = minY; y <= maxY; y++) {
+    for (int x = minX; x <= maxX; x++) {
+      const auto &cell = cells[static_cast<size_t>(y) * columns + x];
+      out.insert(out.end(), cell.begin(), cell.end());
+    }
+  }
+
+  // Entries spanning several cells show up once per cell
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+}
@@ -0,0 +1,152 @@
+#include "SpriteAnimation.h"
+#include <algorithm>
+#include <cmath>
+#include <gl2d/gl2d.h>
+#include <iostream>
+
+uint16_t AnimationLibrary::addClip(const std::string &name,
+                                   const std::vector<Frame> &frames,
+                                   bool loop) {
+  if (frames.empty() || clips.size() >= INVALID_CLIP ||
+      frames.size() > INVALID_CLIP) {
+    std::cerr << "AnimationLibrary: can't add clip '" << name << "'"
+              << std::endl;
+    return INVALID_CLIP;
+  }
+
+  float shortest = frames[0].duration;
+  for (const Frame &frame : frames) {
+    if (!(frame.duration > 0.0f)) {
+      std::cerr << "AnimationLibrary: clip '" << name
+                << "' has a frame without a duration" << std::endl;
+      return INVALID_CLIP;
+    }
+    shortest = std::min(shortest, frame.duration);
+  }
+
+  Clip clip;
+  clip.firstFrame = static_cast<uint32_t>(frameUVs.size());
+  clip.frameCount = static_cast<uint32_t>(frames.size());
+  clip.loop = loop;
+
+  float end = 0.0f;
+  for (const Frame &frame : frames) {
+    end += frame.duration;
+    frameUVs.push_back(frame.uv);
+    frameEnds.push_back(end);
+  }
+  clip.duration = end;
+  clip.wrap = loop ? end : 0.0f;
+  shortestClip = clips.empty() ? end : std::min(shortestClip, end);
+
+  clip.slotsPerSecond = 1.0f / shortest;
+  clip.slotCount = std::max(
+      1u, static_cast<uint32_t>(std::ceil(end * clip.slotsPerSecond)));
+  clip.firstSlot = static_cast<uint32_t>(slotFrames.size());
+
+  uint16_t frame = 0;
+  for (uint32_t slot = 0; slot < clip.slotCount; slot++) {
+    float start = slot / clip.slotsPerSecond;
+    while (frame + 1u < clip.frameCount &&
+           start >= frameEnds[clip.firstFrame + frame]) {
+      frame++;
+    }
+    slotFrames.push_back(frame);
+  }
+
+  clips.push_back(clip);
+  clipNames.push_back(name);
+  return static_cast<uint16_t>(clips.size() - 1);
+}
+
+uint16_t AnimationLibrary::addSheetClip(const std::string &name, int columns,
+                                        int rows, int first, int count,
+                                        const std::vector<float> &durations,
+                                        bool loop) {
+  if (columns <= 0 || rows <= 0 || count <= 0 || first < 0 ||
+      first + count > columns * rows || durations.empty() ||
+      (durations.size() != 1 && durations.size() != size_t(count))) {
+    std::cerr << "AnimationLibrary: bad sheet layout for clip '" << name
+              << "'" << std::endl;
+    return INVALID_CLIP;
+  }
+
+  std::vector<Frame> frames;
+  frames.reserve(count);
+  for (int i = 0; i < count; i++) {
+    int cell = first + i;
+    Frame frame;
+    frame.uv = gl2d::computeTextureAtlas(columns, rows, cell % columns,
+                                         cell / columns);
+    frame.duration = durations.size() == 1 ? durations[0] : durations[i];
+    frames.push_back(frame);
+  }
+  return addClip(name, frames, loop);
+}
+
+uint16_t AnimationLibrary::findClip(const std::string &name) const {
+  // Latest clip with the name wins
+  for (size_t i = clipNames.size(); i-- > 0;) {
+    if (clipNames[i] == name)
+      return static_cast<uint16_t>(i);
+  }
+  return INVALID_CLIP;
+}
+
+void AnimationLibrary::advance(AnimationState *states, size_t count,
+                               float deltaTime) const {
+  const Clip *clipData = clips.data();
+
+  // Long steps (hitches) can pass a whole loop
+  if (!(deltaTime < shortestClip)) {
+    for (size_t i = 0; i < count; i++) {
+      AnimationState &state = states[i];
+      const Clip &clip = clipData[state.clip];
+
+      float time = state.time + deltaTime;
+      if (time >= clip.duration) {
+        time = clip.loop ? std::fmod(time, clip.duration) : clip.duration;
+      }
+      state.time = time;
+    }
+    return;
+  }
+
+  // Otherwise at most one wrap per step, done without branches: looping
+  // clips subtract their duration, the others stop at it
+  for (size_t i = 0; i < count; i++) {
+    AnimationState &state = states[i];
+    const Clip &clip = clipData[state.clip];
+
+    float time = state.time + deltaTime;
+    time -= time >= clip.duration ? clip.wrap : 0.0f;
+    state.time = std::min(time, clip.duration);
+  }
+}
+
+uint32_t AnimationLibrary::getFrameIndex(const AnimationState &state) const {
+  const Clip &clip = clips[state.clip];
+
+  uint32_t slot = static_cast<uint32_t>(state.time * clip.slotsPerSecond);
+  slot = std::min(slot, clip.slotCount - 1);
+
+  // The slot's frame, or the next one if its boundary falls inside the slot.
+  // Stepping back only happens when rounding put time in the wrong slot.
+  uint32_t frame = clip.firstFrame + slotFrames[clip.firstSlot + slot];
+  const uint32_t last = clip.firstFrame + clip.frameCount - 1;
+  if (frame < last && state.time >= frameEnds[frame]) {
+    frame++;
+  } else if (frame > clip.firstFrame && state.time < frameEnds[frame - 1]) {
+    frame--;
+  }
+  return frame;
+}
+
+void AnimationLibrary::clear() {
+  clips.clear();
+  clipNames.clear();
+  shortestClip = 0.0f;
+  frameUVs.clear();
+  frameEnds.clear();
+  slotFrames.clear();
+}
@@ -0,0 +1,149 @@
+#include "SystemScheduler.h"
+#include "JobSystem.h"
+#include <algorithm>
+
+SystemScheduler::SystemScheduler()
+    : parallel(true), minParallelSeconds(0.0001), levelCount(0),
+      lastRunSeconds(0.0), lastSystemSeconds(0.0), lastRunParallel(false),
+      runCount(0) {}
+
+size_t SystemScheduler::addSystem(const std::string &name, AccessMask reads,
+                                  AccessMask writes, SystemFunction function,
+                                  bool mainThread) {
+  System system;
+  system.name = name;
+  system.reads = reads;
+  system.writes = writes;
+  system.mainThread = mainThread;
+  system.function = std::move(function);
+  systems.push_back(std::move(system));
+
+  dependents.resize(systems.size());
+  remaining = std::vector<std::atomic<int>>(systems.size());
+  return systems.size() - 1;
+}
+
+void SystemScheduler::setEnabled(size_t system, bool enabled) {
+  if (system < systems.size())
+    systems[system].enabled = enabled;
+}
+
+void SystemScheduler::setDataNames(std::vector<std::string> names) {
+  dataNames = std::move(names);
+}
+
+std::string SystemScheduler::describe(AccessMask mask) const {
+  std::string text;
+  for (size_t bit = 0; bit < dataNames.size(); bit++) {
+    if (!(mask & (AccessMask(1) << bit)))
+      continue;
+    if (!text.empty())
+      text += ", ";
+    text += dataNames[bit];
+  }
+  return text.empty() ? "-" : text;
+}
+
+void SystemScheduler::run(float deltaTime) {
+  buildGraph();
+
+  JobSystem &jobs = JobSystem::get();
+  lastRunParallel = parallel && jobs.getWorkerCount() > 0 &&
+                    jobs.isMainThread() &&
+                    lastSystemSeconds >= minParallelSeconds;
+  runStart = Clock::now();
+
+  if (lastRunParallel) {
+    JobCounter done;
+    for (size_t i = 0; i < systems.size(); i++) {
+      if (systems[i].enabled && systems[i].dependencies.empty())
+        launch(i, deltaTime, done);
+    }
+    jobs.wait(done);
+  } else {
+    for (size_t i = 0; i < systems.size(); i++) {
+      if (systems[i].enabled)
+        execute(i, deltaTime);
+    }
+  }
+
+  lastRunSeconds =
+      std::chrono::duration<double>(Clock::now() - runStart).count();
+  lastSystemSeconds = 0.0;
+  for (System &system : systems) {
+    if (!system.enabled)
+      continue;
+    system.totalSeconds += system.seconds;
+    lastSystemSeconds += system.seconds;
+  }
+  runCount++;
+}
+
+void SystemScheduler::resetTotals() {
+  for (System &system : systems) {
+    system.totalSeconds = 0.0;
+  }
+  runCount = 0;
+}
+
+void SystemScheduler::buildGraph() {
+  // Cheap for the handful of systems of a step, so it is redone every run
+  // and follows systems being switched on and off
+  levelCount = 0;
+  for (size_t i = 0; i < systems.size(); i++) {
+    System &system = systems[i];
+    system.dependencies.clear();
+    system.level = 0;
+    dependents[i].clear();
+    if (!system.enabled)
+      continue;
+
+    for (size_t j = 0; j < i; j++) {
+      const System &earlier = systems[j];
+      if (!earlier.enabled)
+        continue;
+
+      bool conflict = (system.writes & (earlier.reads | earlier.writes)) ||
+                      (earlier.writes & system.reads);
+      if (!conflict)
+        continue;
+
+      system.dependencies.push_back(j);
+      dependents[j].push_back(i);
+      system.level = std::max(system.level, earlier.level + 1);
+    }
+    remaining[i].store(static_cast<int>(system.dependencies.size()),
+                       std::memory_order_relaxed);
+    levelCount = std::max(levelCount, system.level + 1);
+  }
+}
+
+void SystemScheduler::execute(size_t index, float deltaTime) {
+  System &system = systems[index];
+  auto start = Clock::now();
+  system.function(deltaTime);
+  auto end = Clock::now();
+
+  system.startSeconds = std::chrono::duration<double>(start - runStart).count();
+  system.seconds = std::chrono::duration<double>(end - start).count();
+  system.ranOnMainThread = JobSystem::get().isMainThread();
+}
+
+void SystemScheduler::launch(size_t index, float deltaTime, JobCounter &done) {
+  auto job = [this, index, deltaTime, &done]() {
+    execute(index, deltaTime);
+
+    // Scheduled before this job signals done, so the run can't end early
+    for (size_t next : dependents[index]) {
+      if (remaining[next].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        launch(next, deltaTime, done);
+    }
+  };
+
+  JobSystem &jobs = JobSystem::get();
+  if (systems[index].mainThread) {
+    jobs.scheduleOnMainThread(std::move(job), &done);
+  } else {
+    jobs.schedule(std::move(job), &done);
+  }
+}
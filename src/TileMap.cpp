@@ -1,10 +1,14 @@
 #include "TileMap.h"
+#include "GpuTileLayer.h"
+#include "Profiler.h"
 #include <algorithm>
 #include <gl2d/gl2d.h>
 #include <iomanip>
 #include <iostream>
 #include <random>
 
+bool TileMap::gpuRendering = false;
+
 TileMap::TileMap()
     : tileset(nullptr), mapWidth(0), mapHeight(0), tilePixelWidth(64),
       tilePixelHeight(64), worldPosition(0.0f, 0.0f) {}
@@ -32,6 +36,7 @@ bool TileMap::initialize(int width, int height, Tileset *tilesetPtr) {
     return false;
   }
 
+  gpuLayer.reset();
   tileset = tilesetPtr;
   mapWidth = width;
   mapHeight = height;
@@ -48,6 +53,7 @@ bool TileMap::initialize(int width, int height, Tileset *tilesetPtr) {
 }
 
 void TileMap::clear() {
+  gpuLayer.reset();
   tileData.clear();
   mapWidth = 0;
   mapHeight = 0;
@@ -56,6 +62,9 @@ void TileMap::clear() {
 void TileMap::setTile(int x, int y, int tileId) {
   if (isValidCoordinate(x, y)) {
     tileData[y][x] = tileId;
+    if (gpuLayer) {
+      gpuLayer->markDirty(x, y);
+    }
   }
 }
 
@@ -81,6 +90,10 @@ void TileMap::fill(int tileId) {
       tileData[y][x] = tileId;
     }
   }
+
+  if (gpuLayer) {
+    gpuLayer->markDirty(0, 0, mapWidth, mapHeight);
+  }
 }
 
 void TileMap::fillRect(int x, int y, int width, int height, int tileId) {
@@ -94,6 +107,10 @@ void TileMap::fillRect(int x, int y, int width, int height, int tileId) {
       }
     }
   }
+
+  if (gpuLayer) {
+    gpuLayer->markDirty(x, y, width, height);
+  }
 }
 
 void TileMap::createGrassMap() {
@@ -165,6 +182,10 @@ void TileMap::createGrassMap() {
     }
   }
 
+  if (gpuLayer) {
+    gpuLayer->markDirty(0, 0, mapWidth, mapHeight);
+  }
+
   std::cout << "Created grass map of size " << mapWidth << "x" << mapHeight
             << " with " << numPaths << " stone paths" << std::endl;
 }
@@ -175,11 +196,21 @@ bool TileMap::isValidCoordinate(int x, int y) const {
 
 void TileMap::render(void *renderer, const glm::vec2 &cameraPos,
                      const glm::vec2 &screenSize) {
+  PROFILE_SCOPE("TileMap::render");
   if (!tileset || !renderer) {
     return;
   }
 
-  gl2d::Renderer2D *r = static_cast<gl2d::Renderer2D *>(renderer);
+  if (gpuRendering) {
+    if (!gpuLayer) {
+      gpuLayer = std::make_unique<GpuTileLayer>();
+      gpuLayer->create(*this);
+    }
+    if (gpuLayer->isCreated()) {
+      gpuLayer->render(renderer, *this);
+      return;
+    }
+  }
 
   // Render ALL tiles - full map always visible
   for (int y = 0; y < mapHeight; ++y) {
@@ -211,7 +242,7 @@ void TileMap::renderTile(void *renderer, int x, int y,
   // Create texture coordinates vector (left, top, right, bottom)
   glm::vec4 texCoords(topLeft.x, topLeft.y, bottomRight.x, bottomRight.y);
 
-  // Render the tile
+  // Render the tile (instanced, maps can have thousands)
   gl2d::Rect tileRect = {renderPos.x, renderPos.y,
                          static_cast<float>(tilePixelWidth),
                          static_cast<float>(tilePixelHeight)};
@@ -224,8 +255,8 @@ void TileMap::renderTile(void *renderer, int x, int y,
   // Get the specific texture for this tile
   void *tileTexturePtr = tileset->getTileTexture(tile->name);
   if (tileTexturePtr) {
-    r->renderRectangle(tileRect, *static_cast<gl2d::Texture *>(tileTexturePtr),
-                       tileColor, {0, 0}, 0, texCoords);
+    r->renderSprite(tileRect, *static_cast<gl2d::Texture *>(tileTexturePtr),
+                    tileColor, {0, 0}, 0, texCoords);
   }
 }
 
@@ -1,7 +1,8 @@
 #include "TileMapManager.h"
 #include <iostream>
 
-TileMapManager::TileMapManager() : currentMap(nullptr) {}
+TileMapManager::TileMapManager()
+    : currentMap(nullptr), assetManager(nullptr) {}
 
 TileMapManager::~TileMapManager() { clearAll(); }
 
@@ -20,6 +21,7 @@ bool TileMapManager::loadTileset(const std::string &name,
 
 bool TileMapManager::loadGrassTileset() {
   auto tileset = std::make_unique<Tileset>();
+  tileset->setAssetManager(assetManager);
   if (!tileset->loadGrassTileset()) {
     std::cerr << "Failed to load grass tileset" << std::endl;
     return false;
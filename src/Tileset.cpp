@@ -1,18 +1,28 @@
 #include "Tileset.h"
+#include "AssetManager.h"
+#include "Graphics.h"
+#include <filesystem>
 #include <gl2d/gl2d.h>
 #include <iostream>
 
-Tileset::Tileset() : tileWidth(64), tileHeight(64) {}
+Tileset::Tileset() : assetManager(nullptr), tileWidth(64), tileHeight(64) {}
 
 Tileset::~Tileset() {
-  // Clean up all tile textures
+  if (assetManager) {
+    for (const auto &pair : sharedTextures) {
+      assetManager->unpinAsset(pair.second);
+    }
+  }
+
+  // Clean up the tile textures we loaded ourselves
   for (auto &pair : tileTextures) {
-    if (pair.second) {
+    if (pair.second && sharedTextures.count(pair.first) == 0) {
       static_cast<gl2d::Texture *>(pair.second)->cleanup();
       delete static_cast<gl2d::Texture *>(pair.second);
     }
   }
   tileTextures.clear();
+  sharedTextures.clear();
   tiles.clear();
   tileMap.clear();
   tileNameMap.clear();
@@ -26,15 +36,34 @@ bool Tileset::loadTileFromFile(int id, const std::string &tileName,
               << std::endl;
   }
 
-  // Load the texture
-  auto texture = new gl2d::Texture();
-  texture->loadFromFile(imagePath.c_str());
-
-  // Check if texture was loaded successfully
-  if (texture->id == 0) {
-    std::cerr << "Failed to load tile image: " << imagePath << std::endl;
-    delete texture;
-    return false;
+  // Load the texture. Without a GL context the tile is registered with a
+  // null texture so the map data is still usable by the simulation.
+  gl2d::Texture *texture = nullptr;
+  if (Graphics::isEnabled() && assetManager) {
+    // Named like the assets autoDiscoverAssets registers for the same files
+    std::string assetName = std::filesystem::path(imagePath).stem().string();
+    if (!assetManager->loadTexture(assetName, imagePath)) {
+      std::cerr << "Failed to load tile image: " << imagePath << std::endl;
+      return false;
+    }
+    // Pinned while the tileset holds the pointer, one pin per tile
+    texture = assetManager->getTexture(assetName);
+    auto previous = sharedTextures.find(tileName);
+    if (previous != sharedTextures.end()) {
+      assetManager->unpinAsset(previous->second);
+    }
+    assetManager->pinAsset(assetName);
+    sharedTextures[tileName] = assetName;
+  } else if (Graphics::isEnabled()) {
+    texture = new gl2d::Texture();
+    texture->loadFromFile(imagePath.c_str());
+
+    // Check if texture was loaded successfully
+    if (texture->id == 0) {
+      std::cerr << "Failed to load tile image: " << imagePath << std::endl;
+      delete texture;
+      return false;
+    }
   }
 
   // Create tile with full texture coordinates (0,0 to 1,1 since each tile is
@@ -1,30 +1,42 @@
 #include "UIManager.h"
+#include "AssetManager.h"
 #include "FileBrowser.h"
 #include "HotReloadManager.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 #include "Scene.h"
 #include "SceneManager.h"
 #include "SceneTemplates.h"
 #include "SceneValidator.h"
+#include "TileMap.h"
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_opengl3.h"
 #include "imgui.h"
 #include "imguiThemes.h"
 #include <GLFW/glfw3.h>
+#include <gl2d/gl2d.h>
+#include <algorithm>
+#include <cfloat>
+#include <functional>
 #include <iostream>
+#include <unordered_map>
 #include <vector>
 
 UIManager::UIManager()
     : initialized(false), selectedTemplateIndex(0), showTemplateCreator(false),
       showFileBrowser(false), showSceneInfo(false),
-      showValidationResults(false), currentValidationResult(nullptr),
-      needsSceneListRefresh(true) {}
+      showValidationResults(false), showAssetMemory(false),
+      showProfiler(false), showRenderStats(false), showSystemSchedule(false),
+      currentValidationResult(nullptr), needsSceneListRefresh(true),
+      profilerFrame(0), drawCallHistory(), quadHistory(),
+      renderStatsOffset(0) {}
 
 UIManager::~UIManager() {
   if (initialized)
     shutdown();
 }
 
-bool UIManager::initialize(void *window) {
+bool UIManager::initialize(void *window, bool multiViewport) {
   GLFWwindow *glfwWindow = static_cast<GLFWwindow *>(window);
 
 #if REMOVE_IMGUI == 0
@@ -35,7 +47,9 @@ bool UIManager::initialize(void *window) {
   (void)io;
   io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
   io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
-  io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+  if (multiViewport) {
+    io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+  }
 
   io.FontGlobalScale = 2.0f; // make text bigger
 
@@ -91,6 +105,61 @@ void UIManager::endFrame() {
 #endif
 }
 
+void UIManager::endFrame(UIDrawData &drawData) {
+  drawData.clear();
+#if REMOVE_IMGUI == 0
+  ImGui::Render();
+
+  // The draw lists belong to ImGui and are reset by the next NewFrame
+  const ImDrawData *data = ImGui::GetDrawData();
+  drawData.lists.reserve(data->CmdListsCount);
+  for (int i = 0; i < data->CmdListsCount; i++) {
+    drawData.lists.push_back(data->CmdLists[i]->CloneOutput());
+  }
+  drawData.displayPos = glm::vec2(data->DisplayPos.x, data->DisplayPos.y);
+  drawData.displaySize = glm::vec2(data->DisplaySize.x, data->DisplaySize.y);
+  drawData.framebufferScale =
+      glm::vec2(data->FramebufferScale.x, data->FramebufferScale.y);
+#endif
+}
+
+void UIManager::renderDrawData(const UIDrawData &drawData) {
+#if REMOVE_IMGUI == 0
+  if (drawData.empty())
+    return;
+
+  ImDrawData data;
+  data.Valid = true;
+  data.CmdLists = const_cast<ImDrawList **>(drawData.lists.data());
+  data.CmdListsCount = static_cast<int>(drawData.lists.size());
+  for (const ImDrawList *list : drawData.lists) {
+    data.TotalVtxCount += list->VtxBuffer.Size;
+    data.TotalIdxCount += list->IdxBuffer.Size;
+  }
+  data.DisplayPos = ImVec2(drawData.displayPos.x, drawData.displayPos.y);
+  data.DisplaySize = ImVec2(drawData.displaySize.x, drawData.displaySize.y);
+  data.FramebufferScale =
+      ImVec2(drawData.framebufferScale.x, drawData.framebufferScale.y);
+  ImGui_ImplOpenGL3_RenderDrawData(&data);
+#endif
+}
+
+void UIDrawData::clear() {
+#if REMOVE_IMGUI == 0
+  for (ImDrawList *list : lists) {
+    IM_DELETE(list);
+  }
+#endif
+  lists.clear();
+}
+
+void UIDrawData::swap(UIDrawData &other) {
+  lists.swap(other.lists);
+  std::swap(displayPos, other.displayPos);
+  std::swap(displaySize, other.displaySize);
+  std::swap(framebufferScale, other.framebufferScale);
+}
+
 void UIManager::renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
                              float &playerSpeed) {
 #if REMOVE_IMGUI == 0
@@ -98,6 +167,7 @@ void UIManager::renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
 
   // Display FPS
   ImGui::Text("FPS: %.1f", fpsCounter.getFPS());
+  renderFrameTiming(fpsCounter);
   ImGui::Separator();
 
   // Player and camera info
@@ -123,6 +193,11 @@ void UIManager::renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
     gameWorld.enableCameraFollow(cameraFollow);
   }
 
+  bool gpuTileMap = TileMap::isGpuRendering();
+  if (ImGui::Checkbox("GPU Tile Map", &gpuTileMap)) {
+    TileMap::setGpuRendering(gpuTileMap);
+  }
+
   if (ImGui::Button("Reset Game World")) {
     int width, height;
     glfwGetFramebufferSize(glfwGetCurrentContext(), &width, &height);
@@ -146,6 +221,7 @@ void UIManager::renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
 
   // Display FPS
   ImGui::Text("FPS: %.1f", fpsCounter.getFPS());
+  renderFrameTiming(fpsCounter);
   ImGui::Separator();
 
   // Scene selector and new features
@@ -169,6 +245,24 @@ void UIManager::renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
   if (ImGui::Button("✅ Validate")) {
     validateCurrentScene(sceneManager);
   }
+  ImGui::SameLine();
+  if (ImGui::Button("💾 Assets")) {
+    showAssetMemory = true;
+  }
+  ImGui::SameLine();
+  if (ImGui::Button("🎨 Render Stats")) {
+    showRenderStats = true;
+  }
+  ImGui::SameLine();
+  if (ImGui::Button("🧩 Systems")) {
+    showSystemSchedule = true;
+  }
+#if CROWNFLAME_PROFILER
+  ImGui::SameLine();
+  if (ImGui::Button("📊 Profiler")) {
+    showProfiler = true;
+  }
+#endif
 
   // Render feature windows
   if (showFileBrowser) {
@@ -206,6 +300,11 @@ void UIManager::renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
     gameWorld.enableCameraFollow(cameraFollow);
   }
 
+  bool gpuTileMap = TileMap::isGpuRendering();
+  if (ImGui::Checkbox("GPU Tile Map", &gpuTileMap)) {
+    TileMap::setGpuRendering(gpuTileMap);
+  }
+
   if (ImGui::Button("Restart Current Scene")) {
     sceneManager.restartCurrentScene();
   }
@@ -220,6 +319,40 @@ void UIManager::renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
 #endif
 }
 
+void UIManager::renderFrameTiming(const FPSCounter &fpsCounter) {
+#if REMOVE_IMGUI == 0
+  const FPSCounter::FrameStats &stats = fpsCounter.getStats();
+  ImGui::Text("Frame ms  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f", stats.p50Ms,
+              stats.p95Ms, stats.p99Ms, stats.maxMs);
+  ImGui::Text("1%% low: %.1f FPS   Hitches (> %.1f ms): %zu",
+              fpsCounter.getOnePercentLowFPS(),
+              fpsCounter.getHitchThreshold(), fpsCounter.getHitchCount());
+
+  size_t count = fpsCounter.getFrameTimeCount();
+  if (count > 0) {
+    size_t offset = fpsCounter.getFrameTimeOffset();
+    float lastMs = fpsCounter.getFrameTimes()[(offset + count - 1) %
+                                              FPSCounter::HISTORY_SIZE];
+    char overlay[32];
+    snprintf(overlay, sizeof(overlay), "%.2f ms", lastMs);
+
+    // Scale so the hitch threshold is always on the graph
+    float scaleMax =
+        std::max(stats.maxMs, fpsCounter.getHitchThreshold() * 1.2f);
+    ImGui::PlotLines("##FrameTimes", fpsCounter.getFrameTimes(),
+                     static_cast<int>(count), static_cast<int>(offset),
+                     overlay, 0.0f, scaleMax, ImVec2(-1, 60));
+  }
+
+  if (fpsCounter.isDumping()) {
+    ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.0f, 1.0f),
+                       "Recording frame times: %zu frames -> %s",
+                       fpsCounter.getDumpedFrameCount(),
+                       fpsCounter.getDumpPath().c_str());
+  }
+#endif
+}
+
 void UIManager::renderPlayerInfo(GameObject *player,
                                  const glm::vec2 &cameraPos) {
   ImGui::Text("Player Position: (%.1f, %.1f)", player->bounds.x,
@@ -244,6 +377,22 @@ void UIManager::renderWorldInfo(GameWorld &gameWorld) {
   ImGui::Text("Pink Pigs - Enemies (avoid!)");
   ImGui::Text("Total Objects: %d", (int)gameWorld.getObjects().size());
   ImGui::Text("Total Enemies: %d", (int)gameWorld.getEnemies().size());
+  // Entities overlapping the view, the rest are culled
+  ImGui::Text("Drawn Objects: %d / %d",
+              (int)gameWorld.getVisibleObjects().size(),
+              (int)gameWorld.getObjects().size());
+  ImGui::Text("Drawn Enemies: %d / %d",
+              (int)gameWorld.getVisibleEnemies().size(),
+              (int)gameWorld.getEnemies().size());
+
+  // Off-screen enemies update less often or not at all
+  bool enemyLod = gameWorld.isEnemyLodEnabled();
+  if (ImGui::Checkbox("Enemy LOD", &enemyLod)) {
+    gameWorld.setEnemyLodEnabled(enemyLod);
+  }
+  ImGui::Text("Updated Enemies: %d near, %d mid-range",
+              (int)gameWorld.getNearEnemyCount(),
+              (int)gameWorld.getMidEnemyUpdateCount());
 }
 
 void UIManager::renderGameState(GameWorld &gameWorld) {
@@ -409,6 +558,30 @@ void UIManager::renderSceneSelector(SceneManager &sceneManager) {
     ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Transitioning...");
   }
 
+  // Resident scenes
+  if (sceneManager.getMaxResidentScenes() > 0) {
+    ImGui::Text("Resident Scenes: %zu / %zu",
+                sceneManager.getResidentSceneCount(),
+                sceneManager.getMaxResidentScenes());
+  } else {
+    ImGui::Text("Resident Scenes: %zu", sceneManager.getResidentSceneCount());
+  }
+  if (!sceneManager.getPreloadSceneName().empty()) {
+    ImGui::Text("Preloading: %s",
+                sceneManager.getPreloadSceneName().c_str());
+  }
+
+  // Frame times of the last animated transition
+  const auto &transitionTrace = sceneManager.getLastTransitionTrace();
+  if (!transitionTrace.empty()) {
+    char overlay[64];
+    snprintf(overlay, sizeof(overlay), "swap at frame %d",
+             sceneManager.getLastTransitionSwapFrame());
+    ImGui::PlotLines("Transition (ms)", transitionTrace.data(),
+                     static_cast<int>(transitionTrace.size()), 0, overlay,
+                     0.0f, FLT_MAX, ImVec2(0, 50));
+  }
+
   // Scene loading buttons
   ImGui::Text("Load Example Scenes:");
 
@@ -798,6 +971,7 @@ void UIManager::renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
 
   // Display FPS
   ImGui::Text("FPS: %.1f", fpsCounter.getFPS());
+  renderFrameTiming(fpsCounter);
   ImGui::Separator();
 
   // Hot Reload Controls
@@ -825,6 +999,10 @@ void UIManager::renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
   if (ImGui::Button("✅ Validate")) {
     validateCurrentScene(sceneManager);
   }
+  ImGui::SameLine();
+  if (ImGui::Button("🧩 Systems")) {
+    showSystemSchedule = true;
+  }
 
   // Render feature windows
   if (showFileBrowser) {
@@ -862,6 +1040,11 @@ void UIManager::renderGameUI(GameWorld &gameWorld, const FPSCounter &fpsCounter,
     gameWorld.enableCameraFollow(cameraFollow);
   }
 
+  bool gpuTileMap = TileMap::isGpuRendering();
+  if (ImGui::Checkbox("GPU Tile Map", &gpuTileMap)) {
+    TileMap::setGpuRendering(gpuTileMap);
+  }
+
   if (ImGui::Button("Reset Game World")) {
     int width, height;
     glfwGetFramebufferSize(glfwGetCurrentContext(), &width, &height);
@@ -893,6 +1076,9 @@ void UIManager::renderHotReloadControls(HotReloadManager &hotReloadManager) {
 
     if (isEnabled) {
       ImGui::Text("Watched Files: %zu", hotReloadManager.getWatchedFileCount());
+      ImGui::Text("Pending Reloads: %zu (coalesced: %zu)",
+                  hotReloadManager.getPendingReloadCount(),
+                  hotReloadManager.getCoalescedReloadCount());
 
       if (ImGui::Button("🔄 Reload All Assets")) {
         hotReloadManager.reloadAllAssets();
@@ -928,11 +1114,428 @@ void UIManager::renderHotReloadControls(HotReloadManager &hotReloadManager) {
       }
 
       ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f),
-                         "Note: Files are monitored for changes every 500ms");
+                         "Watcher backend: %s",
+                         hotReloadManager.getWatcherBackendName());
     } else {
       ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f),
                          "Hot reloading is disabled");
     }
   }
 #endif
-}
\ No newline at end of file
+}
+
+void UIManager::renderAssetMemoryWindow(AssetManager &assetManager) {
+#if REMOVE_IMGUI == 0
+  if (!showAssetMemory)
+    return;
+
+  ImGui::Begin("Asset Memory", &showAssetMemory);
+
+  auto toMB = [](size_t bytes) { return bytes / (1024.0f * 1024.0f); };
+
+  ImGui::Text("CPU: %.2f MB   GPU: %.2f MB   Total: %.2f MB",
+              toMB(assetManager.getCpuMemoryUsage()),
+              toMB(assetManager.getGpuMemoryUsage()),
+              toMB(assetManager.getTotalMemoryUsage()));
+  ImGui::Text("Texture cache: %zu hits, %zu misses",
+              assetManager.getCacheHitCount(),
+              assetManager.getCacheMissCount());
+  ImGui::Separator();
+
+  // Usage against budget for every asset type
+  const AssetManager::AssetType types[] = {
+      AssetManager::AssetType::TEXTURE, AssetManager::AssetType::AUDIO,
+      AssetManager::AssetType::SCENE, AssetManager::AssetType::FONT};
+
+  for (AssetManager::AssetType type : types) {
+    std::string typeName = AssetManager::getAssetTypeString(type);
+    size_t used = assetManager.getMemoryUsageByType(type);
+    size_t budget = assetManager.getMemoryBudget(type);
+
+    if (budget > 0) {
+      float fraction = (float)used / (float)budget;
+      char overlay[64];
+      snprintf(overlay, sizeof(overlay), "%.2f / %.2f MB", toMB(used),
+               toMB(budget));
+      ImGui::PushStyleColor(ImGuiCol_PlotHistogram,
+                            fraction > 1.0f ? ImVec4(1.0f, 0.2f, 0.2f, 1.0f)
+                                            : ImVec4(0.2f, 0.8f, 0.2f, 1.0f));
+      ImGui::ProgressBar(std::min(fraction, 1.0f), ImVec2(-120, 0), overlay);
+      ImGui::PopStyleColor();
+      ImGui::SameLine();
+      ImGui::Text("%s", typeName.c_str());
+    } else {
+      ImGui::Text("%s: %.2f MB (no budget)", typeName.c_str(), toMB(used));
+    }
+  }
+
+  ImGui::Separator();
+
+  // Per-asset breakdown
+  auto assets = assetManager.getLoadedAssets();
+  std::sort(assets.begin(), assets.end(),
+            [](const AssetManager::AssetInfo &a,
+               const AssetManager::AssetInfo &b) {
+              return a.cpuBytes + a.gpuBytes > b.cpuBytes + b.gpuBytes;
+            });
+
+  ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                          ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+  if (ImGui::BeginTable("AssetMemoryTable", 6, flags, ImVec2(0, 300))) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Name");
+    ImGui::TableSetupColumn("Type");
+    ImGui::TableSetupColumn("Disk KB");
+    ImGui::TableSetupColumn("CPU KB");
+    ImGui::TableSetupColumn("GPU KB");
+    ImGui::TableSetupColumn("Cache");
+    ImGui::TableHeadersRow();
+
+    for (const auto &asset : assets) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("%s", asset.name.c_str());
+      if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("%s", asset.filepath.c_str());
+      }
+      ImGui::TableNextColumn();
+      ImGui::Text("%s", AssetManager::getAssetTypeString(asset.type).c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", asset.size / 1024.0f);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", asset.cpuBytes / 1024.0f);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", asset.gpuBytes / 1024.0f);
+      ImGui::TableNextColumn();
+      switch (asset.cacheStatus) {
+      case AssetManager::CacheStatus::HIT:
+        ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "hit");
+        break;
+      case AssetManager::CacheStatus::MISS:
+        ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.0f, 1.0f), "miss");
+        break;
+      default:
+        ImGui::Text("-");
+        break;
+      }
+    }
+
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+#endif
+}
+
+void UIManager::renderProfilerWindow() {
+#if REMOVE_IMGUI == 0 && CROWNFLAME_PROFILER
+  if (!showProfiler)
+    return;
+
+  ImGui::Begin("Profiler", &showProfiler);
+  Profiler &profiler = Profiler::get();
+
+  bool paused = profiler.isPaused();
+  if (ImGui::Checkbox("Pause", &paused)) {
+    profiler.setPaused(paused);
+  }
+  ImGui::SameLine();
+  if (ImGui::Button("Export Chrome Trace")) {
+    profilerExportStatus = profiler.exportChromeTrace("profile_trace.json")
+                               ? "Saved profile_trace.json"
+                               : "Export failed";
+  }
+  if (!profilerExportStatus.empty()) {
+    ImGui::SameLine();
+    ImGui::TextUnformatted(profilerExportStatus.c_str());
+  }
+
+  int frameCount = static_cast<int>(profiler.getFrameCount());
+  if (frameCount == 0) {
+    ImGui::Text("No frames recorded yet");
+    ImGui::End();
+    return;
+  }
+  profilerFrame = std::min(profilerFrame, frameCount - 1);
+
+  // Timeline of recent frames, oldest on the left; click to select one
+  std::vector<float> frameTimes(frameCount);
+  float slowest = 1000.0f / 60.0f;
+  for (int i = 0; i < frameCount; i++) {
+    frameTimes[frameCount - 1 - i] = static_cast<float>(profiler.getFrameMs(i));
+    slowest = std::max(slowest, frameTimes[frameCount - 1 - i]);
+  }
+  ImGui::PlotHistogram("##ProfilerFrames", frameTimes.data(), frameCount, 0,
+                       nullptr, 0.0f, slowest, ImVec2(-1, 60));
+  if (ImGui::IsItemHovered() && ImGui::IsMouseClicked(0)) {
+    float width = ImGui::GetItemRectSize().x;
+    float x = ImGui::GetMousePos().x - ImGui::GetItemRectMin().x;
+    int index = static_cast<int>(x / width * frameCount);
+    profilerFrame = frameCount - 1 - std::clamp(index, 0, frameCount - 1);
+  }
+  ImGui::SliderInt("Frames ago", &profilerFrame, 0, frameCount - 1);
+
+  Profiler::Frame frame;
+  if (!profiler.getFrame(profilerFrame, frame)) {
+    ImGui::End();
+    return;
+  }
+  double frameMs = profiler.ticksToMs(frame.end - frame.start);
+  ImGui::Text("Frame: %.3f ms", frameMs);
+  ImGui::Separator();
+
+  // Flame graph: one lane per thread, nesting depth grows downwards, the
+  // width of the panel is the length of the frame
+  auto zones = profiler.collectZones(frame.start, frame.end);
+  ImDrawList *drawList = ImGui::GetWindowDrawList();
+  const float rowHeight = 18.0f;
+  const float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+  const ImVec2 mouse = ImGui::GetMousePos();
+
+  size_t laneStart = 0;
+  while (laneStart < zones.size()) {
+    uint32_t thread = zones[laneStart].thread;
+    size_t laneEnd = laneStart;
+    uint32_t maxDepth = 0;
+    while (laneEnd < zones.size() && zones[laneEnd].thread == thread) {
+      maxDepth = std::max(maxDepth, zones[laneEnd].depth);
+      laneEnd++;
+    }
+
+    ImGui::Text("%s", profiler.getThreadName(thread).c_str());
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float laneHeight = (maxDepth + 1) * rowHeight;
+    drawList->PushClipRect(origin,
+                           ImVec2(origin.x + width, origin.y + laneHeight),
+                           true);
+
+    for (size_t i = laneStart; i < laneEnd; i++) {
+      const Profiler::ZoneRecord &zone = zones[i];
+      double endMs = zone.startMs + zone.durationMs;
+      float x0 = origin.x + static_cast<float>(zone.startMs / frameMs) * width;
+      float x1 = origin.x + static_cast<float>(endMs / frameMs) * width;
+      x1 = std::max(x1, x0 + 1.0f);
+      float y0 = origin.y + zone.depth * rowHeight;
+      ImVec2 min(x0, y0);
+      ImVec2 max(x1, y0 + rowHeight - 1.0f);
+
+      // Stable colour per zone name
+      size_t hash = std::hash<std::string>()(zone.name);
+      float hue = (hash % 360) / 360.0f;
+      drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.5f, 0.75f));
+
+      if (x1 - x0 > 20.0f) {
+        drawList->PushClipRect(min, max, true);
+        drawList->AddText(ImVec2(x0 + 3.0f, y0 + 2.0f),
+                          IM_COL32(0, 0, 0, 255), zone.name);
+        drawList->PopClipRect();
+      }
+
+      if (ImGui::IsWindowHovered() && mouse.x >= x0 && mouse.x < x1 &&
+          mouse.y >= min.y && mouse.y < max.y) {
+        ImGui::SetTooltip("%s\n%.3f ms", zone.name, zone.durationMs);
+      }
+    }
+
+    drawList->PopClipRect();
+    ImGui::Dummy(ImVec2(width, laneHeight));
+    laneStart = laneEnd;
+  }
+
+  // Totals per zone name for the selected frame
+  struct ZoneTotal {
+    int calls = 0;
+    double totalMs = 0.0;
+  };
+  std::unordered_map<std::string, ZoneTotal> totals;
+  for (const auto &zone : zones) {
+    ZoneTotal &total = totals[zone.name];
+    total.calls++;
+    total.totalMs += zone.durationMs;
+  }
+  std::vector<std::pair<std::string, ZoneTotal>> sortedTotals(totals.begin(),
+                                                              totals.end());
+  std::sort(sortedTotals.begin(), sortedTotals.end(),
+            [](const auto &a, const auto &b) {
+              return a.second.totalMs > b.second.totalMs;
+            });
+
+  ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                          ImGuiTableFlags_ScrollY;
+  if (ImGui::BeginTable("ProfilerZones", 3, flags, ImVec2(0, 200))) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Zone");
+    ImGui::TableSetupColumn("Calls");
+    ImGui::TableSetupColumn("Total (ms)");
+    ImGui::TableHeadersRow();
+
+    for (const auto &entry : sortedTotals) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(entry.first.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%d", entry.second.calls);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", entry.second.totalMs);
+    }
+
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+#endif
+}
+
+void UIManager::renderRenderStatsWindow(const gl2d::RenderStats &stats) {
+#if REMOVE_IMGUI == 0
+  // Keep the history running while the window is closed so it has data as
+  // soon as it is opened
+  drawCallHistory[renderStatsOffset] = static_cast<float>(stats.drawCalls);
+  quadHistory[renderStatsOffset] =
+      static_cast<float>(stats.quads + stats.sprites);
+  renderStatsOffset = (renderStatsOffset + 1) % RENDER_STATS_HISTORY;
+
+  if (!showRenderStats)
+    return;
+
+  ImGui::Begin("Render Stats", &showRenderStats);
+
+  ImGui::Text("Flushes: %u", stats.flushes);
+  ImGui::Text("Draw calls: %u", stats.drawCalls);
+  ImGui::Text("Texture binds: %u", stats.textureBinds);
+  unsigned int totalQuads = stats.quads + stats.sprites;
+  ImGui::Text("Quads: %u (%.1f per draw call)", totalQuads,
+              stats.drawCalls > 0 ? (float)totalQuads / stats.drawCalls
+                                  : 0.0f);
+  ImGui::Text("  of which instanced sprites: %u", stats.sprites);
+  ImGui::Text("Vertices: %u", stats.vertices);
+  ImGui::Text("Uploaded: %.1f KB", stats.uploadedBytes / 1024.0f);
+  ImGui::Separator();
+
+  float maxDrawCalls = 1.0f;
+  float maxQuads = 1.0f;
+  for (int i = 0; i < RENDER_STATS_HISTORY; i++) {
+    maxDrawCalls = std::max(maxDrawCalls, drawCallHistory[i]);
+    maxQuads = std::max(maxQuads, quadHistory[i]);
+  }
+  ImGui::PlotLines("Draw calls", drawCallHistory, RENDER_STATS_HISTORY,
+                   renderStatsOffset, nullptr, 0.0f, maxDrawCalls * 1.2f,
+                   ImVec2(0, 50));
+  ImGui::PlotLines("Quads", quadHistory, RENDER_STATS_HISTORY,
+                   renderStatsOffset, nullptr, 0.0f, maxQuads * 1.2f,
+                   ImVec2(0, 50));
+
+  ImGui::End();
+#endif
+}
+
+void UIManager::renderSystemScheduleWindow(GameWorld &gameWorld) {
+#if REMOVE_IMGUI == 0
+  if (!showSystemSchedule)
+    return;
+
+  ImGui::Begin("System Schedule", &showSystemSchedule);
+
+  SystemScheduler &scheduler = gameWorld.getSystemScheduler();
+  const auto &systems = scheduler.getSystems();
+
+  bool parallel = scheduler.isParallel();
+  if (ImGui::Checkbox("Run on job workers", &parallel)) {
+    scheduler.setParallel(parallel);
+  }
+  ImGui::SameLine();
+  ImGui::TextDisabled("(%zu workers)", JobSystem::get().getWorkerCount());
+
+  double systemSeconds = 0.0;
+  for (const auto &system : systems) {
+    if (system.enabled)
+      systemSeconds += system.seconds;
+  }
+  const double runSeconds = scheduler.getLastRunSeconds();
+  ImGui::Text("Last step: %.3f ms, %.3f ms of systems, %d levels, %s",
+              runSeconds * 1000.0, systemSeconds * 1000.0,
+              scheduler.getLevelCount(),
+              scheduler.ranInParallel() ? "parallel" : "in order");
+  ImGui::Separator();
+
+  ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                          ImGuiTableFlags_Resizable;
+  if (ImGui::BeginTable("SystemScheduleTable", 8, flags)) {
+    ImGui::TableSetupColumn("System");
+    ImGui::TableSetupColumn("Level");
+    ImGui::TableSetupColumn("Thread");
+    ImGui::TableSetupColumn("ms");
+    ImGui::TableSetupColumn("Timeline", ImGuiTableColumnFlags_WidthFixed,
+                            160.0f);
+    ImGui::TableSetupColumn("Reads");
+    ImGui::TableSetupColumn("Writes");
+    ImGui::TableSetupColumn("After");
+    ImGui::TableHeadersRow();
+
+    for (const auto &system : systems) {
+      if (!system.enabled)
+        continue;
+
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("%s", system.name.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%d", system.level);
+      ImGui::TableNextColumn();
+      ImGui::Text("%s%s", system.ranOnMainThread ? "main" : "worker",
+                  system.mainThread ? " (pinned)" : "");
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", system.seconds * 1000.0);
+
+      // Where the system fell within the step
+      ImGui::TableNextColumn();
+      ImVec2 origin = ImGui::GetCursorScreenPos();
+      float width = ImGui::GetContentRegionAvail().x;
+      float height = ImGui::GetTextLineHeight();
+      if (runSeconds > 0.0) {
+        float begin = static_cast<float>(system.startSeconds / runSeconds);
+        float end = static_cast<float>(
+            (system.startSeconds + system.seconds) / runSeconds);
+        end = std::max(end, begin + 2.0f / std::max(width, 1.0f));
+        ImGui::GetWindowDrawList()->AddRectFilled(
+            ImVec2(origin.x + begin * width, origin.y),
+            ImVec2(origin.x + std::min(end, 1.0f) * width, origin.y + height),
+            system.ranOnMainThread ? IM_COL32(90, 160, 240, 255)
+                                   : IM_COL32(240, 170, 60, 255));
+      }
+      ImGui::Dummy(ImVec2(width, height));
+
+      ImGui::TableNextColumn();
+      ImGui::TextWrapped("%s", scheduler.describe(system.reads).c_str());
+      ImGui::TableNextColumn();
+      ImGui::TextWrapped("%s", scheduler.describe(system.writes).c_str());
+      ImGui::TableNextColumn();
+      std::string after;
+      for (size_t dependency : system.dependencies) {
+        if (!after.empty())
+          after += ", ";
+        after += systems[dependency].name;
+      }
+      ImGui::TextWrapped("%s", after.empty() ? "-" : after.c_str());
+    }
+
+    ImGui::EndTable();
+  }
+
+  if (scheduler.getRunCount() > 0) {
+    ImGui::Separator();
+    ImGui::Text("Average over %llu steps:",
+                static_cast<unsigned long long>(scheduler.getRunCount()));
+    for (const auto &system : systems) {
+      ImGui::BulletText("%s: %.3f ms", system.name.c_str(),
+                        system.totalSeconds * 1000.0 /
+                            scheduler.getRunCount());
+    }
+    if (ImGui::Button("Reset averages")) {
+      scheduler.resetTotals();
+    }
+  }
+
+  ImGui::End();
+#endif
+}
@@ -1,14 +1,44 @@
 #include "Application.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 
-int main() {
+int main(int argc, char **argv) {
   Application app;
 
+  // --headless <steps>: run the simulation without rendering and report
+  // its throughput
+  int headlessSteps = 0;
+  // --perf-dump <file> [--perf-frames <n>]: record every frame time and
+  // write it as CSV (or JSON for .json) on exit, optionally quitting after
+  // n frames
+  std::string perfDumpPath;
+  int perfDumpFrames = 0;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--headless") == 0) {
+      headlessSteps = (i + 1 < argc) ? std::atoi(argv[++i]) : 0;
+      if (headlessSteps <= 0) {
+        headlessSteps = 10000;
+      }
+    } else if (std::strcmp(argv[i], "--perf-dump") == 0 && i + 1 < argc) {
+      perfDumpPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--perf-frames") == 0 && i + 1 < argc) {
+      perfDumpFrames = std::atoi(argv[++i]);
+    }
+  }
+  app.setHeadless(headlessSteps > 0);
+  app.setPerfDump(perfDumpPath, perfDumpFrames);
+
   if (!app.initialize(800, 600, "Game with Collision Detection")) {
     std::cerr << "Failed to initialize application!" << std::endl;
     return -1;
   }
 
+  if (app.isHeadless()) {
+    return app.runHeadless(headlessSteps) ? 0 : -1;
+  }
+
   app.run();
 
   return 0;
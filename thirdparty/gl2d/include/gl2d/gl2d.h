@@ -27,13 +27,15 @@
 
 #pragma once
 
-//enable simd functions
+//enable simd functions (SSE2, present on every x86-64 cpu)
 //set GL2D_SIMD to 0 if it doesn't work on your platform
-#ifdef _WIN32
+#ifndef GL2D_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
 #define GL2D_SIMD 1
 #else
 #define GL2D_SIMD 0
 #endif
+#endif
 
 //if you are not using visual studio make shure you link to "Opengl32.lib"
 
@@ -54,9 +56,13 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <functional>
 #include <random>
 #include <stb_image/stb_image.h>
 #include <stb_truetype/stb_truetype.h>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace gl2d
@@ -151,6 +157,20 @@ namespace gl2d
 		void createFromBuffer(const char* image_data, const int width,
 			const int height, bool pixelated = GL2D_DEFAULT_TEXTURE_LOAD_MODE_PIXELATED, bool useMipMaps = GL2D_DEFAULT_TEXTURE_LOAD_MODE_USE_MIPMAPS);
 		
+		//Note: This function expects levelCount buffers of bytes in GL_RGBA format,
+		//level 0 being width x height and every next level half the size of the previous one.
+		//No mipmaps are generated, the given chain is uploaded as is.
+		void createFromMipChain(const unsigned char* const* levels, const int levelCount,
+			const int width, const int height, bool pixelated = GL2D_DEFAULT_TEXTURE_LOAD_MODE_PIXELATED,
+			bool useMipMaps = GL2D_DEFAULT_TEXTURE_LOAD_MODE_USE_MIPMAPS);
+
+		//Same as createFromMipChain but the levels are already compressed in internalFormat
+		//(for example GL_COMPRESSED_RGBA_S3TC_DXT5_EXT), levelSizes holds the byte size of each level.
+		void createFromCompressedMipChain(GLenum internalFormat, const unsigned char* const* levels,
+			const int* levelSizes, const int levelCount, const int width, const int height,
+			bool pixelated = GL2D_DEFAULT_TEXTURE_LOAD_MODE_PIXELATED,
+			bool useMipMaps = GL2D_DEFAULT_TEXTURE_LOAD_MODE_USE_MIPMAPS);
+
 		//used internally. It creates a 1by1 white texture
 		void create1PxSquare(const char* b = 0);
 		
@@ -321,11 +341,95 @@ namespace gl2d
 	};
 
 
+	//Counters filled by Renderer2D::flush and flushFBO. They accumulate until
+	//Renderer2D::resetStats() is called, call it once per frame for per frame numbers.
+	struct RenderStats
+	{
+		unsigned int flushes = 0;
+		unsigned int drawCalls = 0;
+		unsigned int textureBinds = 0;
+		unsigned int quads = 0;
+		unsigned int sprites = 0; //instanced, see renderSprite
+		unsigned int vertices = 0;
+		size_t uploadedBytes = 0;
+	};
+
+	//Interleaved vertex streamed by Renderer2D (20 bytes). The colour is
+	//normalized to a vec4 by the vertex attribute so shaders are unchanged.
+	struct Vertex2D
+	{
+		glm::vec2 position = {};
+		std::uint8_t color[4] = {}; //RGBA8
+		glm::vec2 texturePosition = {};
+	};
+	static_assert(sizeof(Vertex2D) == 20, "Vertex2D is expected to be tightly packed");
+
+	//Per-instance record of renderSprite (48 bytes instead of 4 vertices). The
+	//camera is already applied: origin is the rotation pivot in window pixels
+	//with y pointing up, rect is the top left corner relative to the pivot and the
+	//size, both scaled by the zoom. The corners are expanded and rotated by the
+	//vertex shader.
+	struct SpriteInstance
+	{
+		glm::vec4 rect = {};
+		glm::vec2 origin = {};
+		float rotation = 0; //radians, sprite and camera rotation combined
+		std::uint8_t color[4] = {}; //RGBA8
+		glm::vec4 textureCoords = {};
+	};
+	static_assert(sizeof(SpriteInstance) == 48, "SpriteInstance is expected to be tightly packed");
+
+	//Glyph quads of a laid out string, relative to the position passed to
+	//renderText (centering already applied). Build it once with layoutText and
+	//submit it with Renderer2D::renderTextRun for labels that don't change.
+	struct TextRun
+	{
+		Texture fontTexture = {};
+		float size = 0; //scales the shadow and light offsets
+		std::vector<glm::vec4> glyphRects; //x y w h
+		std::vector<glm::vec4> glyphTextureCoords;
+	};
+
+	void layoutText(TextRun &run, const char *text, const Font &font, const float size = 1.5f,
+		const float spacing = 4, const float line_space = 3, bool showInCenter = 1);
+
+	//Text runs keyed by (text, font, size, spacing, line space, centering). Entries
+	//are found by a hash of the key and then compared, so a hit doesn't allocate.
+	//Once more than capacity runs are held, endFrame drops the ones that weren't
+	//used in the last two frames.
+	struct TextLayoutCache
+	{
+		size_t capacity = 1024;
+		size_t hits = 0;
+		size_t misses = 0;
+
+		const TextRun &get(const char *text, const Font &font, const float size,
+			const float spacing, const float line_space, bool showInCenter);
+		void endFrame();
+		void clear() { entries.clear(); }
+		size_t size() const { return entries.size(); }
+
+	private:
+		struct Entry
+		{
+			std::string text;
+			GLuint font = 0;
+			float size = 0;
+			float spacing = 0;
+			float lineSpace = 0;
+			bool showInCenter = 0;
+			std::uint64_t lastUsed = 0;
+			TextRun run;
+		};
+		std::unordered_map<std::uint64_t, Entry> entries;
+		std::uint64_t frame = 0;
+	};
+
 	enum Renderer2DBufferType
 	{
-		quadPositions,
-		quadColors,
-		texturePositions,
+		vertexBuffer,
+		indexBuffer,
+		instanceBuffer,
 
 		bufferSize
 	};
@@ -355,12 +459,66 @@ namespace gl2d
 
 		GLuint buffers[Renderer2DBufferType::bufferSize] = {};
 		GLuint vao = {};
+		GLuint instanceVao = {};
+
+		RenderStats stats = {};
+		void resetStats() { stats = {}; }
 
-		//4 elements each component
-		std::vector<glm::vec2>spritePositions;
-		std::vector<glm::vec4>spriteColors;
-		std::vector<glm::vec2>texturePositions;
+		//4 vertices and 1 texture per quad, drawn as 2 indexed triangles
+		std::vector<Vertex2D>vertices;
 		std::vector<Texture>spriteTextures;
+
+		//Sort key of every quad: layer in the high 32 bits, texture id in the low ones.
+		//With textureSorting on, flush draws the layers in increasing order and inside
+		//a layer groups the quads by texture, keeping submission order for quads with
+		//the same key. Only use it when quads of one layer don't rely on being drawn
+		//over quads of another texture in the same layer.
+		std::vector<std::uint64_t>sortKeys;
+		bool textureSorting = false;
+		std::uint32_t currentLayer = 0;
+		void setLayer(std::uint32_t layer) { currentLayer = layer; }
+
+		//Stable radix sort of the pending quads by their keys, called by flush when
+		//textureSorting is on
+		void sortDrawData();
+
+		//scratch space for sortDrawData, kept to avoid allocating every flush
+		std::vector<std::uint32_t>sortOrder;
+		std::vector<std::uint32_t>sortOrderScratch;
+		std::vector<std::uint64_t>sortedKeys;
+		std::vector<Vertex2D>sortedVertices;
+		std::vector<Texture>sortedTextures;
+		std::vector<SpriteInstance>sortedSprites;
+
+		//Instanced sprites, one record and one texture per sprite. They use their own
+		//shader, so pushShader doesn't affect them. With textureSorting on they are
+		//drawn after the quads of the same layer, otherwise after all quads.
+		std::vector<SpriteInstance>spriteInstances;
+		std::vector<Texture>spriteInstanceTextures;
+		std::vector<std::uint64_t>spriteSortKeys;
+
+		//Drawing gl2d can't batch (a full screen pass with its own shader, say).
+		//flush calls draw with its framebuffer bound and the viewport set, before the
+		//quads and sprites of the layer it was submitted in; without textureSorting
+		//before everything else in the flush. The callback may change GL state other
+		//than the framebuffer and viewport. It gets the renderer doing the flush, which
+		//is not the one it was submitted to if the draw data was moved with swapDrawData.
+		struct CustomDraw
+		{
+			std::uint32_t layer = 0;
+			std::function<void(Renderer2D &)> draw;
+		};
+		std::vector<CustomDraw>customDraws;
+		void renderCustom(std::function<void(Renderer2D &)> draw) { customDraws.push_back({currentLayer, std::move(draw)}); }
+
+		//The vertex buffer is used as a ring: every flush appends after the previous
+		//one and when it is full the storage is orphaned. It holds 3 flushes of the
+		//largest size seen so the GPU can still be reading older ones.
+		size_t vertexBufferCapacity = 0; //bytes
+		size_t vertexBufferHead = 0; //bytes
+		size_t indexBufferQuads = 0;
+		size_t instanceBufferCapacity = 0; //bytes, a ring like the vertex buffer
+		size_t instanceBufferHead = 0; //bytes
 		
 		//glm::vec2 spritePositions[GL2D_Renderer2D_Max_Triangle_Capacity * 6];
 		//glm::vec4 spriteColors[GL2D_Renderer2D_Max_Triangle_Capacity * 6];
@@ -396,10 +554,13 @@ namespace gl2d
 		//clears the things that are to be drawn when calling flush
 		inline void clearDrawData()
 		{
-			spritePositions.clear();
-			spriteColors.clear();
-			texturePositions.clear();
+			vertices.clear();
 			spriteTextures.clear();
+			sortKeys.clear();
+			spriteInstances.clear();
+			spriteInstanceTextures.clear();
+			spriteSortKeys.clear();
+			customDraws.clear();
 
 			//spritePositionsCount = 0;
 			//spriteColorsCount = 0;
@@ -407,16 +568,32 @@ namespace gl2d
 			//texturePositionsCount = 0;
 		}
 
+		//exchanges the things that are to be drawn with another renderer, so draw data
+		//can be recorded into one that was never created (no gl calls are made while
+		//recording) and flushed by another, on another thread for example
+		void swapDrawData(Renderer2D &other);
+
 		glm::vec2 getTextSize(const char *text, const Font font, const float size = 1.5f,
 			const float spacing = 4, const float line_space = 3);
 
 		// The origin will be the bottom left corner since it represents the line for the text to be drawn
 		//Pacing and lineSpace are influenced by size
 		//todo the function should returns the size of the text drawn also refactor
+		//The glyphs are instanced sprites (see renderSprite) and the layout comes
+		//from textLayoutCache unless textLayoutCaching is off.
 		void renderText(glm::vec2 position, const char *text, const Font font, const Color4f color, const float size = 1.5f,
 			const float spacing = 4, const float line_space = 3, bool showInCenter = 1, const Color4f ShadowColor = {0.1,0.1,0.1,1}
 		, const Color4f LightColor = {});
 
+		//Draws a run built by layoutText, same output as renderText with the
+		//arguments the run was built for
+		void renderTextRun(glm::vec2 position, const TextRun &run, const Color4f color,
+			const Color4f ShadowColor = {0.1,0.1,0.1,1}, const Color4f LightColor = {});
+
+		TextLayoutCache textLayoutCache;
+		bool textLayoutCaching = true;
+		TextRun textRunScratch; //layout of the last uncached renderText
+
 		//determines the text size so that it fits in the given box,
 		//the x and y components of the transform are ignored
 		float determineTextRescaleFitSmaller(const std::string &str,
@@ -470,6 +647,12 @@ namespace gl2d
 			renderRectangle(transforms, c, origin, rotationDegrees);
 		}
 
+		//Same result as renderRectangle with a single colour, but records one
+		//SpriteInstance instead of 4 vertices and leaves the corners and the rotation
+		//to the vertex shader. Meant for large numbers of sprites.
+		void renderSprite(const Rect transforms, const Texture texture, const Color4f color = {1,1,1,1}, const glm::vec2 origin = {}, const float rotationDegrees = 0, const glm::vec4 textureCoords = GL2D_DefaultTextureCoords);
+		void renderSprite(const Rect transforms, const Color4f color, const glm::vec2 origin = {}, const float rotationDegrees = 0);
+
 		//abs rotation means that the rotaion is relative to the screen rather than object
 		void renderRectangleAbsRotation(const Rect transforms, const Color4f colors[4], const glm::vec2 origin = { 0,0 }, const float rotationDegrees = 0);
 		inline void renderRectangleAbsRotation(const Rect transforms, const Color4f colors, const glm::vec2 origin = { 0,0 }, const float rotationDegrees = 0)
@@ -62,21 +62,40 @@ namespace gl2d
 	};
 
 
+	//Particles are stored as arrays of floats (one array per attribute) so the
+	//movement update runs 4 particles at a time with SSE. Free slots are kept
+	//on a stack, emitting doesn't look for dead particles.
 	struct ParticleSystem
 	{
+		ParticleSystem() {};
+		~ParticleSystem() { cleanup(); }
+
+		ParticleSystem(const ParticleSystem &) = delete;
+		ParticleSystem &operator=(const ParticleSystem &) = delete;
+
 		void initParticleSystem(int size);
 		void cleanup();
 
+		//emits ps->onCreateCount particles, less if the system is full
 		void emitParticleWave(ParticleSettings *ps, glm::vec2 pos);
 
 
 		void applyMovement(float deltaTime);
 
+		//particles are queued as instanced sprites at the renderer's current layer.
+		//With postProcessing they are drawn pixelated through a frame buffer instead,
+		//that flushes the renderer, and needs initgl2dParticleSystem
 		void draw(gl2d::Renderer2D &r);
 
+		int getLiveCount() const { return liveCount; }
+		int getCapacity() const { return size; }
+
 		bool postProcessing = true;
 		float pixelateFactor = 2;
 
+		//use the sse movement kernel when GL2D_SIMD is on, the scalar loop otherwise
+		bool useSimd = true;
+
 	private:
 
 		int size = 0;
@@ -111,11 +130,19 @@ namespace gl2d
 
 		gl2d::Texture **textures = 0;
 
+		char *alive = 0;
+		int *freeSlots = 0; //stack of dead slots, the top is freeSlots[freeCount - 1]
+		int freeCount = 0;
+		int liveCount = 0;
+		int activeEnd = 0; //no live particle at or after this index
+
 		std::mt19937 random{std::random_device{}()};
 
 		gl2d::FrameBuffer fb = {};
 
 		float rand(glm::vec2 v);
+		void kill(int i);
+		void resetFreeSlots();
 	};
 
 
@@ -75,7 +75,10 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <limits>
 
 //if you are not using visual studio make shure you link to "Opengl32.lib"
 #ifdef _MSC_VER
@@ -92,6 +95,8 @@ namespace gl2d
 #pragma region shaders
 
 	static ShaderProgram defaultShader = {};
+	static ShaderProgram instancedShader = {};
+	static GLint instancedViewSizeLocation = -1;
 	static Camera defaultCamera{};
 	static Texture white1pxSquareTexture = {};
 
@@ -122,6 +127,33 @@ namespace gl2d
 		"    color = v_color * texture2D(u_sampler, v_texture);\n"
 		"}\n";
 
+	//Used by renderSprite with the default fragment shader. Corner i of the strip
+	//is (i / 2, i % 2) in units of the rect size; positions are window pixels with
+	//y pointing up, like the vertices the CPU path computes.
+	static const char* instancedVertexShader =
+		GL2D_OPNEGL_SHADER_VERSION "\n"
+		GL2D_OPNEGL_SHADER_PRECISION "\n"
+		"in vec4 instance_rect;\n"
+		"in vec2 instance_origin;\n"
+		"in float instance_rotation;\n"
+		"in vec4 instance_color;\n"
+		"in vec4 instance_textureCoords;\n"
+		"uniform vec2 u_viewSize;\n"
+		"out vec4 v_color;\n"
+		"out vec2 v_texture;\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 corner = vec2(gl_VertexID / 2, gl_VertexID % 2);\n"
+		"	vec2 local = instance_rect.xy + corner * instance_rect.zw;\n"
+		"	local.y = -local.y;\n"
+		"	float s = sin(instance_rotation);\n"
+		"	float c = cos(instance_rotation);\n"
+		"	vec2 p = instance_origin + vec2(local.x * c - local.y * s, local.x * s + local.y * c);\n"
+		"	gl_Position = vec4(p.x / u_viewSize.x * 2.0 - 1.0, p.y / u_viewSize.y * 2.0 + 1.0, 0, 1);\n"
+		"	v_color = instance_color;\n"
+		"	v_texture = mix(instance_textureCoords.xy, instance_textureCoords.zw, corner);\n"
+		"}\n";
+
 #pragma endregion
 
 	static errorFuncType* errorFunc = defaultErrorFunc;
@@ -251,6 +283,8 @@ namespace gl2d
 	#endif
 
 		defaultShader = createShaderProgram(defaultVertexShader, defaultFragmentShader);
+		instancedShader = createShaderProgram(instancedVertexShader, defaultFragmentShader);
+		instancedViewSizeLocation = glGetUniformLocation(instancedShader.id, "u_viewSize");
 		white1pxSquareTexture.create1PxSquare();
 
 		enableNecessaryGLFeatures();
@@ -260,6 +294,7 @@ namespace gl2d
 	{
 		white1pxSquareTexture.cleanup();
 		glDeleteShader(defaultShader.id);
+		glDeleteShader(instancedShader.id);
 		hasInitialized = false;
 	}
 
@@ -318,6 +353,11 @@ namespace gl2d
 		glBindAttribLocation(shader.id, 0, "quad_positions");
 		glBindAttribLocation(shader.id, 1, "quad_colors");
 		glBindAttribLocation(shader.id, 2, "texturePositions");
+		glBindAttribLocation(shader.id, 3, "instance_rect");
+		glBindAttribLocation(shader.id, 4, "instance_origin");
+		glBindAttribLocation(shader.id, 5, "instance_rotation");
+		glBindAttribLocation(shader.id, 6, "instance_color");
+		glBindAttribLocation(shader.id, 7, "instance_textureCoords");
 
 		glLinkProgram(shader.id);
 
@@ -498,6 +538,249 @@ namespace gl2d
 #pragma region Renderer2D
 
 	//won't bind any fbo
+	//Every quad uses the same index pattern, so the index buffer only changes
+	//when more quads are flushed at once than it was built for
+	static void ensureIndexCapacity(Renderer2D &renderer, size_t quadCount)
+	{
+		if (quadCount <= renderer.indexBufferQuads)
+		{
+			return;
+		}
+
+		size_t capacity = std::max(quadCount, renderer.indexBufferQuads * 2);
+
+		std::vector<GLuint> indices(capacity * 6);
+		for (size_t q = 0; q < capacity; q++)
+		{
+			GLuint v = (GLuint)(q * 4);
+			indices[q * 6 + 0] = v + 0;
+			indices[q * 6 + 1] = v + 1;
+			indices[q * 6 + 2] = v + 3;
+			indices[q * 6 + 3] = v + 1;
+			indices[q * 6 + 4] = v + 2;
+			indices[q * 6 + 5] = v + 3;
+		}
+
+		//the element buffer binding is part of the vao, which is bound here
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderer.buffers[Renderer2DBufferType::indexBuffer]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+		renderer.indexBufferQuads = capacity;
+		renderer.stats.uploadedBytes += indices.size() * sizeof(GLuint);
+	}
+
+	//Copies data into a ring buffer and returns the byte offset it was written at.
+	//Every flush appends after the previous one and when the buffer is full its
+	//storage is orphaned. It holds 3 uploads of the largest size seen so the GPU can
+	//still be reading older ones.
+	static size_t streamToRing(GLuint buffer, size_t &capacity, size_t &head, const void *data, size_t bytes)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+		if (bytes > capacity / 3)
+		{
+			capacity = std::max(bytes * 3, capacity * 2);
+			glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+			head = 0;
+		}
+		else if (head + bytes > capacity)
+		{
+			//orphan: the driver hands out fresh storage while the GPU keeps the old one
+			glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+			head = 0;
+		}
+
+		//the range was never written since the last orphan, so no need to sync
+		void *destination = glMapBufferRange(GL_ARRAY_BUFFER, head, bytes,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		if (destination)
+		{
+			std::memcpy(destination, data, bytes);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+		}
+		else
+		{
+			glBufferSubData(GL_ARRAY_BUFFER, head, bytes, data);
+		}
+
+		size_t offset = head;
+		head += bytes;
+		return offset;
+	}
+
+	//Stable LSD radix sort: fills order with the indices of keys in sorted order.
+	//Returns false, without touching order, when the keys already are sorted.
+	static bool radixSortByKeys(const std::vector<std::uint64_t> &keys,
+		std::vector<std::uint32_t> &order, std::vector<std::uint32_t> &scratch)
+	{
+		const size_t count = keys.size();
+		if (count < 2)
+		{
+			return false;
+		}
+
+		//a key byte that is the same for every entry doesn't need a pass
+		bool sorted = true;
+		std::uint64_t differentBits = 0;
+		for (size_t i = 1; i < count; i++)
+		{
+			sorted = sorted && keys[i - 1] <= keys[i];
+			differentBits |= keys[i] ^ keys[0];
+		}
+
+		if (sorted)
+		{
+			return false;
+		}
+
+		order.resize(count);
+		scratch.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			order[i] = (std::uint32_t)i;
+		}
+
+		//least significant byte first; every pass is stable so entries with equal
+		//keys stay in submission order
+		for (int shift = 0; shift < 64; shift += 8)
+		{
+			if (((differentBits >> shift) & 0xFF) == 0)
+			{
+				continue;
+			}
+
+			size_t offsets[256] = {};
+			for (size_t i = 0; i < count; i++)
+			{
+				offsets[(keys[i] >> shift) & 0xFF]++;
+			}
+
+			size_t total = 0;
+			for (size_t &offset : offsets)
+			{
+				size_t entries = offset;
+				offset = total;
+				total += entries;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				std::uint32_t entry = order[i];
+				scratch[offsets[(keys[entry] >> shift) & 0xFF]++] = entry;
+			}
+
+			order.swap(scratch);
+		}
+
+		return true;
+	}
+
+	//Reorders items (itemsPerEntry consecutive items per sorted entry), using
+	//scratch as the destination
+	template <class T>
+	static void applyOrder(std::vector<T> &items, std::vector<T> &scratch,
+		const std::vector<std::uint32_t> &order, size_t itemsPerEntry)
+	{
+		scratch.resize(items.size());
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			std::copy_n(&items[order[i] * itemsPerEntry], itemsPerEntry, &scratch[i * itemsPerEntry]);
+		}
+		items.swap(scratch);
+	}
+
+	void Renderer2D::sortDrawData()
+	{
+		if (radixSortByKeys(sortKeys, sortOrder, sortOrderScratch))
+		{
+			applyOrder(sortKeys, sortedKeys, sortOrder, 1);
+			applyOrder(spriteTextures, sortedTextures, sortOrder, 1);
+			applyOrder(vertices, sortedVertices, sortOrder, 4);
+		}
+
+		if (radixSortByKeys(spriteSortKeys, sortOrder, sortOrderScratch))
+		{
+			applyOrder(spriteSortKeys, sortedKeys, sortOrder, 1);
+			applyOrder(spriteInstanceTextures, sortedTextures, sortOrder, 1);
+			applyOrder(spriteInstances, sortedSprites, sortOrder, 1);
+		}
+	}
+
+	static void bindTexture(Renderer2D &renderer, Texture texture, GLuint &boundTexture)
+	{
+		if (texture.id != boundTexture)
+		{
+			texture.bind();
+			boundTexture = texture.id;
+			renderer.stats.textureBinds++;
+		}
+	}
+
+	//Draws the pending quads [first, end), one call per run of the same texture
+	static void drawQuadRange(Renderer2D &renderer, size_t first, size_t end,
+		GLint baseVertex, GLuint &boundTexture)
+	{
+		glBindVertexArray(renderer.vao);
+		glUseProgram(renderer.currentShader.id);
+		glUniform1i(renderer.currentShader.u_sampler, 0);
+
+		while (first < end)
+		{
+			const Texture texture = renderer.spriteTextures[first];
+			size_t runEnd = first + 1;
+			while (runEnd < end && renderer.spriteTextures[runEnd].id == texture.id)
+			{
+				runEnd++;
+			}
+
+			bindTexture(renderer, texture, boundTexture);
+			glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)((runEnd - first) * 6), GL_UNSIGNED_INT,
+				(void *)(first * 6 * sizeof(GLuint)), baseVertex);
+			renderer.stats.drawCalls++;
+
+			first = runEnd;
+		}
+	}
+
+	static void setSpriteAttributes(size_t offset)
+	{
+		const GLsizei stride = sizeof(SpriteInstance);
+		glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (void *)(offset + offsetof(SpriteInstance, rect)));
+		glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, stride, (void *)(offset + offsetof(SpriteInstance, origin)));
+		glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, stride, (void *)(offset + offsetof(SpriteInstance, rotation)));
+		glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void *)(offset + offsetof(SpriteInstance, color)));
+		glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, stride, (void *)(offset + offsetof(SpriteInstance, textureCoords)));
+	}
+
+	//Draws the pending sprites [first, end) as instanced 4 vertex strips
+	static void drawSpriteRange(Renderer2D &renderer, size_t first, size_t end,
+		size_t byteOffset, GLuint &boundTexture)
+	{
+		glBindVertexArray(renderer.instanceVao);
+		glBindBuffer(GL_ARRAY_BUFFER, renderer.buffers[Renderer2DBufferType::instanceBuffer]);
+		glUseProgram(instancedShader.id);
+		glUniform1i(instancedShader.u_sampler, 0);
+		glUniform2f(instancedViewSizeLocation, (float)renderer.windowW, (float)renderer.windowH);
+
+		while (first < end)
+		{
+			const Texture texture = renderer.spriteInstanceTextures[first];
+			size_t runEnd = first + 1;
+			while (runEnd < end && renderer.spriteInstanceTextures[runEnd].id == texture.id)
+			{
+				runEnd++;
+			}
+
+			bindTexture(renderer, texture, boundTexture);
+			//GL 3.3 has no base instance, so the attributes are pointed at the run
+			setSpriteAttributes(byteOffset + first * sizeof(SpriteInstance));
+			glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)(runEnd - first));
+			renderer.stats.drawCalls++;
+
+			first = runEnd;
+		}
+	}
+
 	void internalFlush(gl2d::Renderer2D &renderer, bool clearDrawData)
 	{
 		enableNecessaryGLFeatures();
@@ -534,51 +817,128 @@ namespace gl2d
 			return;
 		}
 
-		if(renderer.spriteTextures.empty())
+		const size_t quadCount = renderer.spriteTextures.size();
+		const size_t spriteCount = renderer.spriteInstances.size();
+		const size_t customCount = renderer.customDraws.size();
+
+		if (quadCount == 0 && spriteCount == 0 && customCount == 0)
 		{
 			return;
 		}
 
 		glViewport(0, 0, renderer.windowW, renderer.windowH);
 
-		glBindVertexArray(renderer.vao);
-
-		glUseProgram(renderer.currentShader.id);
+		if (renderer.textureSorting)
+		{
+			renderer.sortDrawData();
+			std::stable_sort(renderer.customDraws.begin(), renderer.customDraws.end(),
+				[](const Renderer2D::CustomDraw &a, const Renderer2D::CustomDraw &b) { return a.layer < b.layer; });
+		}
 
-		glUniform1i(renderer.currentShader.u_sampler, 0);
+		GLint baseVertex = 0;
+		if (quadCount)
+		{
+			//the index buffer binding is part of the vao
+			glBindVertexArray(renderer.vao);
+			ensureIndexCapacity(renderer, quadCount);
 
-		glBindBuffer(GL_ARRAY_BUFFER, renderer.buffers[Renderer2DBufferType::quadPositions]);
-		glBufferData(GL_ARRAY_BUFFER, renderer.spritePositions.size() * sizeof(glm::vec2), renderer.spritePositions.data(), GL_STREAM_DRAW);
+			const size_t bytes = renderer.vertices.size() * sizeof(Vertex2D);
+			baseVertex = (GLint)(streamToRing(renderer.buffers[Renderer2DBufferType::vertexBuffer],
+				renderer.vertexBufferCapacity, renderer.vertexBufferHead, renderer.vertices.data(), bytes)
+				/ sizeof(Vertex2D));
+			renderer.stats.uploadedBytes += bytes;
+		}
 
-		glBindBuffer(GL_ARRAY_BUFFER, renderer.buffers[Renderer2DBufferType::quadColors]);
-		glBufferData(GL_ARRAY_BUFFER, renderer.spriteColors.size() * sizeof(glm::vec4), renderer.spriteColors.data(), GL_STREAM_DRAW);
+		size_t spriteOffset = 0;
+		if (spriteCount)
+		{
+			const size_t bytes = spriteCount * sizeof(SpriteInstance);
+			spriteOffset = streamToRing(renderer.buffers[Renderer2DBufferType::instanceBuffer],
+				renderer.instanceBufferCapacity, renderer.instanceBufferHead, renderer.spriteInstances.data(), bytes);
+			renderer.stats.uploadedBytes += bytes;
+		}
 
-		glBindBuffer(GL_ARRAY_BUFFER, renderer.buffers[Renderer2DBufferType::texturePositions]);
-		glBufferData(GL_ARRAY_BUFFER, renderer.texturePositions.size() * sizeof(glm::vec2), renderer.texturePositions.data(), GL_STREAM_DRAW);
+		renderer.stats.flushes++;
+		renderer.stats.quads += quadCount;
+		renderer.stats.sprites += spriteCount;
+		renderer.stats.vertices += renderer.vertices.size();
 
-		//Instance render the textures
+		//Layer by layer: custom draws, then quads, then sprites. Without sorting the
+		//layers are ignored and each kind is drawn in one go.
 		{
-			const int size = renderer.spriteTextures.size();
-			int pos = 0;
-			unsigned int id = renderer.spriteTextures[0].id;
+			const auto layerOf = [](std::uint64_t key) { return key >> 32; };
+			GLuint boundTexture = 0;
+			size_t custom = 0;
+			size_t quad = 0;
+			size_t sprite = 0;
 
-			renderer.spriteTextures[0].bind();
-
-			for (int i = 1; i < size; i++)
+			while (custom < customCount || quad < quadCount || sprite < spriteCount)
 			{
-				if (renderer.spriteTextures[i].id != id)
+				size_t customEnd = customCount;
+				size_t quadEnd = quadCount;
+				size_t spriteEnd = spriteCount;
+
+				if (renderer.textureSorting)
 				{
-					glDrawArrays(GL_TRIANGLES, pos * 6, 6 * (i - pos));
+					std::uint64_t layer = UINT64_MAX;
+					if (custom < customCount)
+					{
+						layer = renderer.customDraws[custom].layer;
+					}
+					if (quad < quadCount)
+					{
+						layer = std::min(layer, layerOf(renderer.sortKeys[quad]));
+					}
+					if (sprite < spriteCount)
+					{
+						layer = std::min(layer, layerOf(renderer.spriteSortKeys[sprite]));
+					}
 
-					pos = i;
-					id = renderer.spriteTextures[i].id;
+					customEnd = custom;
+					while (customEnd < customCount && renderer.customDraws[customEnd].layer == layer)
+					{
+						customEnd++;
+					}
 
-					renderer.spriteTextures[i].bind();
+					quadEnd = quad;
+					while (quadEnd < quadCount && layerOf(renderer.sortKeys[quadEnd]) == layer)
+					{
+						quadEnd++;
+					}
+
+					spriteEnd = sprite;
+					while (spriteEnd < spriteCount && layerOf(renderer.spriteSortKeys[spriteEnd]) == layer)
+					{
+						spriteEnd++;
+					}
 				}
 
-			}
+				if (customEnd > custom)
+				{
+					for (size_t i = custom; i < customEnd; i++)
+					{
+						renderer.customDraws[i].draw(renderer);
+					}
+
+					//the callbacks may have changed anything gl2d relies on
+					enableNecessaryGLFeatures();
+					boundTexture = 0;
+				}
+
+				if (quadEnd > quad)
+				{
+					drawQuadRange(renderer, quad, quadEnd, baseVertex, boundTexture);
+				}
+
+				if (spriteEnd > sprite)
+				{
+					drawSpriteRange(renderer, sprite, spriteEnd, spriteOffset, boundTexture);
+				}
 
-			glDrawArrays(GL_TRIANGLES, pos * 6, 6 * (size - pos));
+				custom = customEnd;
+				quad = quadEnd;
+				sprite = spriteEnd;
+			}
 
 			glBindVertexArray(0);
 		}
@@ -589,10 +949,22 @@ namespace gl2d
 		}
 	}
 
+	void Renderer2D::swapDrawData(Renderer2D &other)
+	{
+		vertices.swap(other.vertices);
+		spriteTextures.swap(other.spriteTextures);
+		sortKeys.swap(other.sortKeys);
+		spriteInstances.swap(other.spriteInstances);
+		spriteInstanceTextures.swap(other.spriteInstanceTextures);
+		spriteSortKeys.swap(other.spriteSortKeys);
+		customDraws.swap(other.customDraws);
+	}
+
 	void gl2d::Renderer2D::flush(bool clearDrawData)
 	{
 		glBindFramebuffer(GL_FRAMEBUFFER, defaultFBO);
 		internalFlush(*this, clearDrawData);
+		textLayoutCache.endFrame();
 	}
 
 	void Renderer2D::flushFBO(FrameBuffer frameBuffer, bool clearDrawData)
@@ -606,6 +978,7 @@ namespace gl2d
 		glBindTexture(GL_TEXTURE_2D, 0); //todo investigate and remove
 
 		internalFlush(*this, clearDrawData);
+		textLayoutCache.endFrame();
 
 		glBindFramebuffer(GL_FRAMEBUFFER, defaultFBO);
 	}
@@ -628,6 +1001,23 @@ namespace gl2d
 		renderRectangleAbsRotation(transforms, texture, colors, newOrigin, rotation, textureCoords);
 	}
 
+	static std::uint8_t packColorChannel(float c)
+	{
+		return (std::uint8_t)(std::min(std::max(c, 0.f), 1.f) * 255.f + 0.5f);
+	}
+
+	static Vertex2D makeVertex(glm::vec2 position, const Color4f &color, glm::vec2 texturePosition)
+	{
+		Vertex2D vertex;
+		vertex.position = position;
+		vertex.color[0] = packColorChannel(color.r);
+		vertex.color[1] = packColorChannel(color.g);
+		vertex.color[2] = packColorChannel(color.b);
+		vertex.color[3] = packColorChannel(color.a);
+		vertex.texturePosition = texturePosition;
+		return vertex;
+	}
+
 	void gl2d::Renderer2D::renderRectangleAbsRotation(const Rect transforms, 
 		const Texture texture, const Color4f colors[4], const glm::vec2 origin, const float rotation, const glm::vec4 textureCoords)
 	{
@@ -703,29 +1093,14 @@ namespace gl2d
 		v3.y = internal::positionToScreenCoordsY(v3.y, (float)windowH);
 		v4.y = internal::positionToScreenCoordsY(v4.y, (float)windowH);
 
-		spritePositions.push_back(glm::vec2{ v1.x, v1.y });
-		spritePositions.push_back(glm::vec2{ v2.x, v2.y });
-		spritePositions.push_back(glm::vec2{ v4.x, v4.y });
-
-		spritePositions.push_back(glm::vec2{ v2.x, v2.y });
-		spritePositions.push_back(glm::vec2{ v3.x, v3.y });
-		spritePositions.push_back(glm::vec2{ v4.x, v4.y });
-
-		spriteColors.push_back(colors[0]);
-		spriteColors.push_back(colors[1]);
-		spriteColors.push_back(colors[3]);
-		spriteColors.push_back(colors[1]);
-		spriteColors.push_back(colors[2]);
-		spriteColors.push_back(colors[3]);
-
-		texturePositions.push_back(glm::vec2{ textureCoords.x, textureCoords.y }); //1
-		texturePositions.push_back(glm::vec2{ textureCoords.x, textureCoords.w }); //2
-		texturePositions.push_back(glm::vec2{ textureCoords.z, textureCoords.y }); //4
-		texturePositions.push_back(glm::vec2{ textureCoords.x, textureCoords.w }); //2
-		texturePositions.push_back(glm::vec2{ textureCoords.z, textureCoords.w }); //3
-		texturePositions.push_back(glm::vec2{ textureCoords.z, textureCoords.y }); //4
+		//drawn as triangles 1 2 4 and 2 3 4 by the shared index buffer
+		vertices.push_back(makeVertex(v1, colors[0], { textureCoords.x, textureCoords.y }));
+		vertices.push_back(makeVertex(v2, colors[1], { textureCoords.x, textureCoords.w }));
+		vertices.push_back(makeVertex(v3, colors[2], { textureCoords.z, textureCoords.w }));
+		vertices.push_back(makeVertex(v4, colors[3], { textureCoords.z, textureCoords.y }));
 
 		spriteTextures.push_back(textureCopy);
+		sortKeys.push_back(((std::uint64_t)currentLayer << 32) | textureCopy.id);
 	}
 
 	void Renderer2D::renderRectangle(const Rect transforms, const Color4f colors[4], const glm::vec2 origin, const float rotation)
@@ -738,6 +1113,60 @@ namespace gl2d
 		renderRectangleAbsRotation(transforms, white1pxSquareTexture, colors, origin, rotation);
 	}
 
+	//The camera only rotates and zooms around the window centre, so moving the
+	//pivot and scaling the size gives the same corners as transforming each one
+	static glm::vec2 spritePivotToWindow(const Renderer2D &renderer, glm::vec2 pivot)
+	{
+		const Camera &camera = renderer.currentCamera;
+		const float w = (float)renderer.windowW;
+		const float h = (float)renderer.windowH;
+
+		glm::vec2 position = { pivot.x - camera.position.x, -pivot.y + camera.position.y };
+		if (camera.rotation != 0)
+		{
+			position = rotateAroundPoint(position, { w / 2.0f, h / 2.0f }, camera.rotation);
+		}
+		return scaleAroundPoint(position, { w / 2.0f, -h / 2.0f }, camera.zoom);
+	}
+
+	void Renderer2D::renderSprite(const Rect transforms, const Texture texture, const Color4f color,
+		const glm::vec2 origin, const float rotationDegrees, const glm::vec4 textureCoords)
+	{
+		Texture textureCopy = texture;
+
+		if (textureCopy.id == 0)
+		{
+			errorFunc("Invalid texture", userDefinedData);
+			textureCopy = white1pxSquareTexture;
+		}
+
+		//same pivot as renderRectangle: the origin is relative to the centre
+		const glm::vec2 pivot = { transforms.x + transforms.z / 2 + origin.x,
+			transforms.y + transforms.w / 2 + origin.y };
+		const glm::vec2 position = spritePivotToWindow(*this, pivot);
+
+		const float zoom = currentCamera.zoom;
+		SpriteInstance instance;
+		instance.rect = { (transforms.x - pivot.x) * zoom, (transforms.y - pivot.y) * zoom,
+			transforms.z * zoom, transforms.w * zoom };
+		instance.origin = position;
+		instance.rotation = glm::radians(rotationDegrees + currentCamera.rotation);
+		instance.color[0] = packColorChannel(color.r);
+		instance.color[1] = packColorChannel(color.g);
+		instance.color[2] = packColorChannel(color.b);
+		instance.color[3] = packColorChannel(color.a);
+		instance.textureCoords = textureCoords;
+
+		spriteInstances.push_back(instance);
+		spriteInstanceTextures.push_back(textureCopy);
+		spriteSortKeys.push_back(((std::uint64_t)currentLayer << 32) | textureCopy.id);
+	}
+
+	void Renderer2D::renderSprite(const Rect transforms, const Color4f color, const glm::vec2 origin, const float rotationDegrees)
+	{
+		renderSprite(transforms, white1pxSquareTexture, color, origin, rotationDegrees);
+	}
+
 	void Renderer2D::renderLine(const glm::vec2 position, const float angleDegrees, const float length, const Color4f color, const float width)
 	{
 		renderRectangle({position - glm::vec2(0,width / 2.f), length, width},
@@ -1142,10 +1571,12 @@ namespace gl2d
 		defaultFBO = fbo;
 
 		clearDrawData();
-		spritePositions.reserve(quadCount * 6);
-		spriteColors.reserve(quadCount * 6);
-		texturePositions.reserve(quadCount * 6);
+		vertices.reserve(quadCount * 4);
 		spriteTextures.reserve(quadCount);
+		sortKeys.reserve(quadCount);
+		spriteInstances.reserve(quadCount);
+		spriteInstanceTextures.reserve(quadCount);
+		spriteSortKeys.reserve(quadCount);
 
 		this->resetCameraAndShader();
 
@@ -1154,17 +1585,38 @@ namespace gl2d
 
 		glGenBuffers(Renderer2DBufferType::bufferSize, buffers);
 
-		glBindBuffer(GL_ARRAY_BUFFER, buffers[Renderer2DBufferType::quadPositions]);
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[Renderer2DBufferType::vertexBuffer]);
+		vertexBufferCapacity = quadCount * 4 * sizeof(Vertex2D) * 3;
+		vertexBufferHead = 0;
+		glBufferData(GL_ARRAY_BUFFER, vertexBufferCapacity, nullptr, GL_STREAM_DRAW);
+
 		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), (void*)offsetof(Vertex2D, position));
 
-		glBindBuffer(GL_ARRAY_BUFFER, buffers[Renderer2DBufferType::quadColors]);
 		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+		glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex2D), (void*)offsetof(Vertex2D, color));
 
-		glBindBuffer(GL_ARRAY_BUFFER, buffers[Renderer2DBufferType::texturePositions]);
 		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), (void*)offsetof(Vertex2D, texturePosition));
+
+		indexBufferQuads = 0;
+		ensureIndexCapacity(*this, quadCount);
+
+		//The sprite attribute pointers are set for every draw since they depend on
+		//where the instances were streamed to
+		glGenVertexArrays(1, &instanceVao);
+		glBindVertexArray(instanceVao);
+
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[Renderer2DBufferType::instanceBuffer]);
+		instanceBufferCapacity = quadCount * sizeof(SpriteInstance) * 3;
+		instanceBufferHead = 0;
+		glBufferData(GL_ARRAY_BUFFER, instanceBufferCapacity, nullptr, GL_STREAM_DRAW);
+
+		for (GLuint attribute = 3; attribute <= 7; attribute++)
+		{
+			glEnableVertexAttribArray(attribute);
+			glVertexAttribDivisor(attribute, 1);
+		}
 
 		glBindVertexArray(0);
 	}
@@ -1172,7 +1624,13 @@ namespace gl2d
 	void Renderer2D::cleanup()
 	{
 		glDeleteVertexArrays(1, &vao);
+		glDeleteVertexArrays(1, &instanceVao);
 		glDeleteBuffers(Renderer2DBufferType::bufferSize, buffers);
+		vertexBufferCapacity = 0;
+		vertexBufferHead = 0;
+		indexBufferQuads = 0;
+		instanceBufferCapacity = 0;
+		instanceBufferHead = 0;
 	}
 
 	void Renderer2D::pushShader(ShaderProgram s)
@@ -1544,92 +2002,28 @@ namespace gl2d
 		return newLineCounter + 1;
 	}
 
-	void Renderer2D::renderText(glm::vec2 position, const char *text, const Font font,
-		const Color4f color, const float size, const float spacing, const float line_space, bool showInCenter,
-		const Color4f ShadowColor
-		, const Color4f LightColor
-	)
+	void layoutText(TextRun &run, const char *text, const Font &font, const float size,
+		const float spacing, const float line_space, bool showInCenter)
 	{
-		if (font.texture.id == 0)
-		{
-			errorFunc("Missing font", userDefinedData);
-			return;
-		}
+		run.fontTexture = font.texture;
+		run.size = size;
+		run.glyphRects.clear();
+		run.glyphTextureCoords.clear();
 
 		const int text_length = (int)strlen(text);
-		Rect rectangle;
-		rectangle.x = position.x;
-		float linePositionY = position.y;
-
-		if (showInCenter)
-		{
-			//This is the y position we render at because it advances when we encounter newlines
-
-			float maxPos = 0;
-			float maxPosY = 0;
-
-			for (int i = 0; i < text_length; i++)
-			{
-				if (text[i] == '\n')
-				{
-					rectangle.x = position.x;
-					linePositionY += (font.max_height + line_space) * size;
-				}
-				else if (text[i] == '\t')
-				{
-					const stbtt_aligned_quad quad = internal::fontGetGlyphQuad
-					(font, '_');
-					auto x = quad.x1 - quad.x0;
-
-					rectangle.x += x * size * 3 + spacing * size;
-				}
-				else if (text[i] == ' ')
-				{
-					const stbtt_aligned_quad quad = internal::fontGetGlyphQuad
-					(font, '_');
-					auto x = quad.x1 - quad.x0;
-
-					rectangle.x += x * size + spacing * size;
-				}
-				else if (text[i] >= ' ' && text[i] <= '~')
-				{
-					const stbtt_aligned_quad quad = internal::fontGetGlyphQuad
-					(font, text[i]);
-
-					rectangle.z = quad.x1 - quad.x0;
-					rectangle.w = quad.y1 - quad.y0;
-
-					rectangle.z *= size;
-					rectangle.w *= size;
-
-					rectangle.y = linePositionY + quad.y0 * size;
-
-
-					rectangle.x += rectangle.z + spacing * size;
-					maxPos = std::max(maxPos, rectangle.x);
-					maxPosY = std::max(maxPosY, rectangle.y);
-				}
-			}
-
-			float padd = maxPos - position.x;
-			padd /= 2;
-			position.x -= padd;
-
-			float paddY = maxPosY - position.y;
-			position.y -= paddY;
-		}
-
-		rectangle = {};
-		rectangle.x = position.x;
+		Rect rectangle = {};
 
 		//This is the y position we render at because it advances when we encounter newlines
-		linePositionY = position.y;
+		float linePositionY = 0;
+
+		float maxPos = 0;
+		float maxPosY = std::numeric_limits<float>::lowest();
 
 		for (int i = 0; i < text_length; i++)
 		{
 			if (text[i] == '\n')
 			{
-				rectangle.x = position.x;
+				rectangle.x = 0;
 				linePositionY += (font.max_height + line_space) * size;
 			}
 			else if (text[i] == '\t')
@@ -1649,7 +2043,6 @@ namespace gl2d
 			}
 			else if (text[i] >= ' ' && text[i] <= '~')
 			{
-
 				const stbtt_aligned_quad quad = internal::fontGetGlyphQuad
 				(font, text[i]);
 
@@ -1659,37 +2052,193 @@ namespace gl2d
 				rectangle.z *= size;
 				rectangle.w *= size;
 
-				//rectangle.y = linePositionY - rectangle.w;
 				rectangle.y = linePositionY + quad.y0 * size;
 
-				glm::vec4 colorData[4] = {color, color, color, color};
+				run.glyphRects.push_back(rectangle);
+				run.glyphTextureCoords.push_back({quad.s0, quad.t0, quad.s1, quad.t1});
 
-				if (ShadowColor.w)
-				{
-					glm::vec2 pos = {-5, 3};
-					pos *= size;
-					renderRectangle({rectangle.x + pos.x, rectangle.y + pos.y,  rectangle.z, rectangle.w},
-						font.texture, ShadowColor, glm::vec2{0, 0}, 0,
-						glm::vec4{quad.s0, quad.t0, quad.s1, quad.t1});
+				rectangle.x += rectangle.z + spacing * size;
+				maxPos = std::max(maxPos, rectangle.x);
+				maxPosY = std::max(maxPosY, rectangle.y);
+			}
+		}
 
-				}
+		//centered horizontally on the position, with the lowest glyph top on it
+		if (showInCenter && !run.glyphRects.empty())
+		{
+			const glm::vec2 offset = {-maxPos / 2, -maxPosY};
+			for (auto &r : run.glyphRects)
+			{
+				r.x += offset.x;
+				r.y += offset.y;
+			}
+		}
+	}
 
-				renderRectangle(rectangle, font.texture, colorData, glm::vec2{0, 0}, 0,
-					glm::vec4{quad.s0, quad.t0, quad.s1, quad.t1});
+	const TextRun &TextLayoutCache::get(const char *text, const Font &font, const float size,
+		const float spacing, const float line_space, bool showInCenter)
+	{
+		//FNV-1a over the text and the raw bits of the other parameters
+		std::uint64_t hash = 14695981039346656037ull;
+		auto mix = [&hash](const void *data, size_t bytes)
+		{
+			const unsigned char *p = static_cast<const unsigned char *>(data);
+			for (size_t i = 0; i < bytes; i++)
+			{
+				hash = (hash ^ p[i]) * 1099511628211ull;
+			}
+		};
 
-				if (LightColor.w)
-				{
-					glm::vec2 pos = {-2, 1};
-					pos *= size;
-					renderRectangle({rectangle.x + pos.x, rectangle.y + pos.y,  rectangle.z, rectangle.w},
-						font.texture,
-						LightColor, glm::vec2{0, 0}, 0,
-						glm::vec4{quad.s0, quad.t0, quad.s1, quad.t1});
+		const size_t length = strlen(text);
+		const char center = showInCenter;
+		mix(text, length);
+		mix(&font.texture.id, sizeof(font.texture.id));
+		mix(&size, sizeof(size));
+		mix(&spacing, sizeof(spacing));
+		mix(&line_space, sizeof(line_space));
+		mix(&center, sizeof(center));
 
-				}
+		//a new entry has font 0, which never matches a loaded font
+		Entry &entry = entries[hash];
+		if (entry.font == font.texture.id && entry.size == size
+			&& entry.spacing == spacing && entry.lineSpace == line_space
+			&& entry.showInCenter == showInCenter
+			&& entry.text.size() == length && memcmp(entry.text.data(), text, length) == 0)
+		{
+			hits++;
+			entry.lastUsed = frame;
+			return entry.run;
+		}
 
+		//new key, or a hash collision that replaces the older entry
+		misses++;
+		entry.text.assign(text, length);
+		entry.font = font.texture.id;
+		entry.size = size;
+		entry.spacing = spacing;
+		entry.lineSpace = line_space;
+		entry.showInCenter = showInCenter;
+		entry.lastUsed = frame;
+		layoutText(entry.run, text, font, size, spacing, line_space, showInCenter);
+		return entry.run;
+	}
 
-				rectangle.x += rectangle.z + spacing * size;
+	void TextLayoutCache::endFrame()
+	{
+		frame++;
+
+		if (entries.size() <= capacity)
+		{
+			return;
+		}
+
+		for (auto it = entries.begin(); it != entries.end();)
+		{
+			if (it->second.lastUsed + 2 < frame)
+			{
+				it = entries.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		//everything is in use, start over rather than grow without bound
+		if (entries.size() > capacity)
+		{
+			entries.clear();
+		}
+	}
+
+	void Renderer2D::renderText(glm::vec2 position, const char *text, const Font font,
+		const Color4f color, const float size, const float spacing, const float line_space, bool showInCenter,
+		const Color4f ShadowColor
+		, const Color4f LightColor
+	)
+	{
+		if (font.texture.id == 0)
+		{
+			errorFunc("Missing font", userDefinedData);
+			return;
+		}
+
+		if (textLayoutCaching)
+		{
+			renderTextRun(position,
+				textLayoutCache.get(text, font, size, spacing, line_space, showInCenter),
+				color, ShadowColor, LightColor);
+		}
+		else
+		{
+			layoutText(textRunScratch, text, font, size, spacing, line_space, showInCenter);
+			renderTextRun(position, textRunScratch, color, ShadowColor, LightColor);
+		}
+	}
+
+	void Renderer2D::renderTextRun(glm::vec2 position, const TextRun &run, const Color4f color,
+		const Color4f ShadowColor, const Color4f LightColor)
+	{
+		if (run.glyphRects.empty())
+		{
+			return;
+		}
+
+		if (run.fontTexture.id == 0)
+		{
+			errorFunc("Missing font", userDefinedData);
+			return;
+		}
+
+		//Same instances renderSprite would record, but the camera transform is
+		//affine, so the run's origin and axes are mapped once and every glyph
+		//pivot is placed from them
+		const glm::vec2 origin = spritePivotToWindow(*this, position);
+		const glm::vec2 axisX = spritePivotToWindow(*this, position + glm::vec2{1, 0}) - origin;
+		const glm::vec2 axisY = spritePivotToWindow(*this, position + glm::vec2{0, 1}) - origin;
+		const float zoom = currentCamera.zoom;
+		const float rotation = glm::radians(currentCamera.rotation);
+		const std::uint64_t sortKey = ((std::uint64_t)currentLayer << 32) | run.fontTexture.id;
+
+		struct Pass
+		{
+			glm::vec2 offset;
+			std::uint8_t color[4];
+		};
+		Pass passes[3];
+		int passCount = 0;
+		auto addPass = [&](glm::vec2 offset, const Color4f &c)
+		{
+			passes[passCount++] = {offset, {packColorChannel(c.r), packColorChannel(c.g),
+				packColorChannel(c.b), packColorChannel(c.a)}};
+		};
+		if (ShadowColor.w) { addPass(glm::vec2{-5, 3} * run.size, ShadowColor); }
+		addPass({}, color);
+		if (LightColor.w) { addPass(glm::vec2{-2, 1} * run.size, LightColor); }
+
+		const size_t count = run.glyphRects.size() * passCount;
+		spriteInstances.reserve(spriteInstances.size() + count);
+		spriteInstanceTextures.reserve(spriteInstanceTextures.size() + count);
+		spriteSortKeys.reserve(spriteSortKeys.size() + count);
+
+		SpriteInstance instance;
+		instance.rotation = rotation;
+		for (size_t i = 0; i < run.glyphRects.size(); i++)
+		{
+			const glm::vec4 &r = run.glyphRects[i];
+			instance.rect = { -r.z / 2 * zoom, -r.w / 2 * zoom, r.z * zoom, r.w * zoom };
+			instance.textureCoords = run.glyphTextureCoords[i];
+
+			//shadow, glyph, light, like renderText always drew them
+			for (int p = 0; p < passCount; p++)
+			{
+				const glm::vec2 pivot = glm::vec2{r.x + r.z / 2, r.y + r.w / 2} + passes[p].offset;
+				instance.origin = origin + axisX * pivot.x + axisY * pivot.y;
+				std::memcpy(instance.color, passes[p].color, sizeof(instance.color));
+
+				spriteInstances.push_back(instance);
+				spriteInstanceTextures.push_back(run.fontTexture);
+				spriteSortKeys.push_back(sortKey);
 			}
 		}
 	}
@@ -1761,16 +2310,8 @@ namespace gl2d
 		return s;
 	}
 
-	void Texture::createFromBuffer(const char* image_data, const int width, const int height
-		,bool pixelated, bool useMipMaps)
+	static void setTextureSampling(bool pixelated, bool useMipMaps)
 	{
-		GLuint id = 0;
-
-		glActiveTexture(GL_TEXTURE0);
-
-		glGenTextures(1, &id);
-		glBindTexture(GL_TEXTURE_2D, id);
-
 		if (pixelated)
 		{
 			if (useMipMaps)
@@ -1798,6 +2339,19 @@ namespace gl2d
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	void Texture::createFromBuffer(const char* image_data, const int width, const int height
+		,bool pixelated, bool useMipMaps)
+	{
+		GLuint id = 0;
+
+		glActiveTexture(GL_TEXTURE0);
+
+		glGenTextures(1, &id);
+		glBindTexture(GL_TEXTURE_2D, id);
+
+		setTextureSampling(pixelated, useMipMaps);
 
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
 		glGenerateMipmap(GL_TEXTURE_2D);
@@ -1806,6 +2360,64 @@ namespace gl2d
 		this->id = id;
 	}
 
+	void Texture::createFromMipChain(const unsigned char* const* levels, const int levelCount,
+		const int width, const int height, bool pixelated, bool useMipMaps)
+	{
+		GLuint id = 0;
+
+		glActiveTexture(GL_TEXTURE0);
+
+		glGenTextures(1, &id);
+		glBindTexture(GL_TEXTURE_2D, id);
+
+		setTextureSampling(pixelated, useMipMaps && levelCount > 1);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+		//rows of the smaller levels are not 4 byte aligned
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		int w = width;
+		int h = height;
+		for (int i = 0; i < levelCount; i++)
+		{
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, levels[i]);
+			w = std::max(1, w / 2);
+			h = std::max(1, h / 2);
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		this->id = id;
+	}
+
+	void Texture::createFromCompressedMipChain(GLenum internalFormat, const unsigned char* const* levels,
+		const int* levelSizes, const int levelCount, const int width, const int height,
+		bool pixelated, bool useMipMaps)
+	{
+		GLuint id = 0;
+
+		glActiveTexture(GL_TEXTURE0);
+
+		glGenTextures(1, &id);
+		glBindTexture(GL_TEXTURE_2D, id);
+
+		setTextureSampling(pixelated, useMipMaps && levelCount > 1);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+		int w = width;
+		int h = height;
+		for (int i = 0; i < levelCount; i++)
+		{
+			glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, w, h, 0, levelSizes[i], levels[i]);
+			w = std::max(1, w / 2);
+			h = std::max(1, h / 2);
+		}
+
+		this->id = id;
+	}
+
 	void Texture::create1PxSquare(const char* b)
 	{
 		if (b == nullptr)
@@ -1,4 +1,12 @@
 #include <gl2d/gl2dParticleSystem.h>
+#include <algorithm>
+
+#if GL2D_SIMD != 0
+#include <emmintrin.h>
+#if defined(__FMA__)
+#include <immintrin.h>
+#endif
+#endif
 
 namespace gl2d
 {
@@ -74,280 +82,193 @@ void ParticleSystem::initParticleSystem(int size)
 
 
 	//simdize size
-	size += 4 - (size % 4);
+	size = (size + 3) & ~3;
 	this->size = size;
 
 
 #pragma region allocations
 
-
-	int size32Aligned = size + (4 - (size % 4));
-
-	posX = new float[size32Aligned];
-	posY = new float[size32Aligned];
-	directionX = new float[size32Aligned];
-	directionY = new float[size32Aligned];
-	rotation = new float[size32Aligned];
-	sizeXY = new float[size32Aligned];
-	dragX = new float[size32Aligned];
-	dragY = new float[size32Aligned];
-	duration = new float[size32Aligned];
-	durationTotal = new float[size32Aligned];
+	posX = new float[size];
+	posY = new float[size];
+	directionX = new float[size];
+	directionY = new float[size];
+	rotation = new float[size];
+	sizeXY = new float[size];
+	dragX = new float[size];
+	dragY = new float[size];
+	duration = new float[size];
+	durationTotal = new float[size];
 	color = new glm::vec4[size];
-	rotationSpeed = new float[size32Aligned];
-	rotationDrag = new float[size32Aligned];
-	deathRattle = new ParticleSettings * [size32Aligned];
-	thisParticleSettings = new ParticleSettings * [size32Aligned];
-	emitParticle = new ParticleSettings * [size32Aligned];
-	tranzitionType = new char[size32Aligned];
-	textures = new gl2d::Texture * [size32Aligned];
-	emitTime = new float[size32Aligned];
+	rotationSpeed = new float[size];
+	rotationDrag = new float[size];
+	deathRattle = new ParticleSettings * [size];
+	thisParticleSettings = new ParticleSettings * [size];
+	emitParticle = new ParticleSettings * [size];
+	tranzitionType = new char[size];
+	textures = new gl2d::Texture * [size];
+	emitTime = new float[size];
+	alive = new char[size];
+	freeSlots = new int[size];
 
 #pragma endregion
 
+	//dead slots are still moved by the simd kernel, keep them at 0 so they
+	//never hold nans or denormals
+	float *floats[] = {posX, posY, directionX, directionY, rotation, sizeXY, dragX, dragY,
+		duration, durationTotal, rotationSpeed, rotationDrag, emitTime};
+	for (float *f : floats)
+	{
+		std::fill(f, f + size, 0.f);
+	}
+
 	for (int i = 0; i < size; i++)
 	{
-		duration[i] = 0;
-		sizeXY[i] = 0;
+		color[i] = {};
+		tranzitionType[i] = 0;
 		deathRattle[i] = 0;
 		textures[i] = nullptr;
 		thisParticleSettings[i] = nullptr;
 		emitParticle[i] = nullptr;
+		alive[i] = 0;
 	}
 
-	fb.create(100, 100);
+	resetFreeSlots();
 
+	//the frame buffer is created by draw, only if postProcessing is used
 }
 
-#if GL2D_SIMD != 0
+void ParticleSystem::resetFreeSlots()
+{
+	//pushed in reverse so slots are handed out from 0 upwards
+	freeCount = size;
+	for (int i = 0; i < size; i++)
+	{
+		freeSlots[i] = size - 1 - i;
+	}
 
-#if defined(_MSC_VER)
-/* Microsoft C/C++-compatible compiler */
-#include <intrin.h>
-#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
-/* GCC-compatible compiler, targeting x86/x86-64 */
-#include <x86intrin.h>
-#elif defined(__GNUC__) && defined(__ARM_NEON__)
-/* GCC-compatible compiler, targeting ARM with NEON */
-#include <arm_neon.h>
-#elif defined(__GNUC__) && defined(__IWMMXT__)
-/* GCC-compatible compiler, targeting ARM with WMMX */
-#include <mmintrin.h>
-#elif (defined(__GNUC__) || defined(__xlC__)) && (defined(__VEC__) || defined(__ALTIVEC__))
-/* XLC or GCC-compatible compiler, targeting PowerPC with VMX/VSX */
-#include <altivec.h>
-#elif defined(__GNUC__) && defined(__SPE__)
-/* GCC-compatible compiler, targeting PowerPC with SPE */
-#include <spe.h>
-#elif
-#undef GL2D_SIMD
-#define GL2D_SIMD 0
-#endif
+	liveCount = 0;
+	activeEnd = 0;
+}
+
+void ParticleSystem::kill(int i)
+{
+	alive[i] = 0;
+	duration[i] = 0;
+	sizeXY[i] = 0;
+	deathRattle[i] = nullptr;
+	emitParticle[i] = nullptr;
+
+	freeSlots[freeCount++] = i;
+	liveCount--;
+}
 
+//a * b + c on 4 floats, fused when the compiler targets fma
+#if GL2D_SIMD != 0
+static inline __m128 multiplyAdd(__m128 a, __m128 b, __m128 c)
+{
+#if defined(__FMA__)
+	return _mm_fmadd_ps(a, b, c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
 #endif
 
 void ParticleSystem::applyMovement(float deltaTime)
 {
 
-#pragma region newParticles
-
-	int recreatedParticlesThisFrame = 0;
-
-	//if(createdPosition < size && createTimeCountdown <= 0 && emitParticles)
-	//{
-	//	createTimeCountdown = rand(ps.emisSpeed);
-	//
-	//	for(int i=createdPosition; i<createdPosition+ maxCreatePerEvent; i++)
-	//	{
-	//		//reset particle
-	//		posX[i] = position.x;
-	//		posY[i] = position.y;
-	//		directionX[i] = rand(ps.directionX);
-	//		directionY[i] = rand(ps.directionY);
-	//		rotation[i] = rand(ps.rotation);;
-	//		sizeXY[i] = rand(ps.createApearence.size);
-	//		dragX[i] = rand(ps.dragX);
-	//		dragY[i] = rand(ps.dragY);
-	//		color[i].x = rand({ ps.createApearence.color1.x, ps.createApearence.color2.x });
-	//		color[i].y = rand({ ps.createApearence.color1.y, ps.createApearence.color2.y });
-	//		color[i].z = rand({ ps.createApearence.color1.z, ps.createApearence.color2.z });
-	//		color[i].w = rand({ ps.createApearence.color1.w, ps.createApearence.color2.w });
-	//		rotationSpeed[i] = rand(ps.rotationSpeed);
-	//		rotationDrag[i] = rand(ps.rotationDrag);
-	//		deathRattle[i] = 1;
-	//
-	//		duration[i] = rand(ps.particleLifeTime);
-	//		durationTotal[i] = duration[i];
-	//
-	//		recreatedParticlesThisFrame++;
-	//	}
-	//	
-	//	createdPosition++;
-	//
-	//
-	//}
-
-
-#pragma endregion
+#pragma region lifetime
 
-
-	for (int i = 0; i < size; i++)
+	//only live slots are visited. Particles emitted from here (death rattles
+	//and subemitters) take free slots and start moving on the next update
+	int end = activeEnd;
+	for (int i = 0; i < end; i++)
 	{
+		if (!alive[i]) { continue; }
 
-		if (duration[i] > 0)
-			duration[i] -= deltaTime;
-
-		if (emitTime[i] > 0 && emitParticle[i])
-			emitTime[i] -= deltaTime;
+		duration[i] -= deltaTime;
 
 		if (duration[i] <= 0)
 		{
-			if (deathRattle[i] != nullptr && deathRattle[i]->onCreateCount)
-			{
+			ParticleSettings *rattle = deathRattle[i];
+			glm::vec2 pos = {posX[i], posY[i]};
 
-				this->emitParticleWave(deathRattle[i], {posX[i], posY[i]});
+			kill(i);
 
+			if (rattle != nullptr && rattle->onCreateCount)
+			{
+				this->emitParticleWave(rattle, pos);
 			}
-
-			deathRattle[i] = nullptr;
-			duration[i] = 0;
-			sizeXY[i] = 0;
-			emitParticle[i] = nullptr;
-
 		}
-		else if (emitTime[i] <= 0 && emitParticle[i])
+		else if (emitParticle[i])
 		{
-			emitTime[i] = rand(thisParticleSettings[i]->subemitParticleTime);
+			emitTime[i] -= deltaTime;
 
-			//emit particle
-			this->emitParticleWave(emitParticle[i], {posX[i], posY[i]});
+			if (emitTime[i] <= 0)
+			{
+				emitTime[i] = rand(thisParticleSettings[i]->subemitParticleTime);
 
+				//emit particle
+				this->emitParticleWave(emitParticle[i], {posX[i], posY[i]});
+			}
 		}
-
 	}
 
-	__m128 _deltaTime = _mm_set1_ps(deltaTime);
-
-#pragma region applyDrag
-
-#if GL2D_SIMD == 0
-	for (int i = 0; i < size; i++)
+	if (liveCount == 0)
 	{
-		//if (duration[i] > 0)
-		directionX[i] += deltaTime * dragX[i];
+		resetFreeSlots();
 	}
-
-	for (int i = 0; i < size; i++)
+	else
 	{
-		//if (duration[i] > 0)
-		directionY[i] += deltaTime * dragY[i];
-
+		while (activeEnd > 0 && !alive[activeEnd - 1]) { activeEnd--; }
 	}
 
-	for (int i = 0; i < size; i++)
-	{
-
-		//if (duration[i] > 0)
-		rotationSpeed[i] += deltaTime * rotationDrag[i];
-	}
-#else
+#pragma endregion
 
-	for (int i = 0; i < size; i += 4)
-	{
-		//directionX[i] += deltaTime * dragX[i];
 
-		__m128 *dir = (__m128 *) & (directionX[i]);
-		__m128 *drag = (__m128 *) & (dragX[i]);
+#pragma region apply drag and movement
 
-		*dir = _mm_fmadd_ps(_deltaTime, *drag, *dir);
-	}
+	//dead slots in [0, activeEnd) are moved too, that is cheaper than
+	//branching and they are reset when emitted. The arrays are allocated in
+	//multiples of 4 so count never runs past them, loads are unaligned
+	int count = (activeEnd + 3) & ~3;
+	int i = 0;
 
-	for (int i = 0; i < size; i += 4)
+#if GL2D_SIMD != 0
+	if (useSimd)
 	{
-		//directionY[i] += deltaTime * dragY[i];
-
-		__m128 *dir = (__m128 *) & (directionY[i]);
-		__m128 *drag = (__m128 *) & (dragY[i]);
-
-		*dir = _mm_fmadd_ps(_deltaTime, *drag, *dir);
-	}
+		__m128 dt = _mm_set1_ps(deltaTime);
 
-	for (int i = 0; i < size; i += 4)
-	{
-		//rotationSpeed[i] += deltaTime * rotationDrag[i];
+		for (; i < count; i += 4)
+		{
+			__m128 dirX = multiplyAdd(dt, _mm_loadu_ps(dragX + i), _mm_loadu_ps(directionX + i));
+			__m128 dirY = multiplyAdd(dt, _mm_loadu_ps(dragY + i), _mm_loadu_ps(directionY + i));
+			__m128 spin = multiplyAdd(dt, _mm_loadu_ps(rotationDrag + i), _mm_loadu_ps(rotationSpeed + i));
 
-		__m128 *dir = (__m128 *) & (rotationSpeed[i]);
-		__m128 *drag = (__m128 *) & (rotationDrag[i]);
+			_mm_storeu_ps(directionX + i, dirX);
+			_mm_storeu_ps(directionY + i, dirY);
+			_mm_storeu_ps(rotationSpeed + i, spin);
 
-		*dir = _mm_fmadd_ps(_deltaTime, *drag, *dir);
+			_mm_storeu_ps(posX + i, multiplyAdd(dt, dirX, _mm_loadu_ps(posX + i)));
+			_mm_storeu_ps(posY + i, multiplyAdd(dt, dirY, _mm_loadu_ps(posY + i)));
+			_mm_storeu_ps(rotation + i, multiplyAdd(dt, spin, _mm_loadu_ps(rotation + i)));
+		}
 	}
 #endif
 
-
-
-#pragma endregion
-
-
-#pragma region apply movement
-
-
-#if GL2D_SIMD == 0
-	for (int i = 0; i < size; i++)
+	for (; i < count; i++)
 	{
-		//if (duration[i] > 0)
-		posX[i] += deltaTime * directionX[i];
-
-	}
-
+		directionX[i] += deltaTime * dragX[i];
+		directionY[i] += deltaTime * dragY[i];
+		rotationSpeed[i] += deltaTime * rotationDrag[i];
 
-	for (int i = 0; i < size; i++)
-	{
-		//if (duration[i] > 0)
+		posX[i] += deltaTime * directionX[i];
 		posY[i] += deltaTime * directionY[i];
-
-	}
-
-	for (int i = 0; i < size; i++)
-	{
-		//if (duration[i] > 0)
 		rotation[i] += deltaTime * rotationSpeed[i];
-
-	}
-#else 
-	for (int i = 0; i < size; i += 4)
-	{
-		//posX[i] += deltaTime * directionX[i];
-		__m128 *dir = (__m128 *) & (posX[i]);
-		__m128 *drag = (__m128 *) & (directionX[i]);
-
-		*dir = _mm_fmadd_ps(_deltaTime, *drag, *dir);
 	}
 
-
-	for (int i = 0; i < size; i++)
-	{
-		//posY[i] += deltaTime * directionY[i];
-		__m128 *dir = (__m128 *) & (posY[i]);
-		__m128 *drag = (__m128 *) & (directionY[i]);
-
-		*dir = _mm_fmadd_ps(_deltaTime, *drag, *dir);
-	}
-
-	for (int i = 0; i < size; i++)
-	{
-		//rotation[i] += deltaTime * rotationSpeed[i];
-		__m128 *dir = (__m128 *) & (rotation[i]);
-		__m128 *drag = (__m128 *) & (rotationSpeed[i]);
-
-		*dir = _mm_fmadd_ps(_deltaTime, *drag, *dir);
-	}
-
-#endif
-
 #pragma endregion
 
-
-
 }
 
 void ParticleSystem::cleanup()
@@ -374,6 +295,8 @@ void ParticleSystem::cleanup()
 	delete[] thisParticleSettings;
 	delete[] emitParticle;
 	delete[] textures;
+	delete[] alive;
+	delete[] freeSlots;
 
 
 	posX = 0;
@@ -395,57 +318,59 @@ void ParticleSystem::cleanup()
 	thisParticleSettings = 0;
 	emitParticle = 0;
 	textures = 0;
+	alive = 0;
+	freeSlots = 0;
 
 	size = 0;
+	freeCount = 0;
+	liveCount = 0;
+	activeEnd = 0;
 
 
-	fb.cleanup();
+	if (fb.fbo)
+	{
+		fb.cleanup();
+	}
 }
 
 void ParticleSystem::emitParticleWave(ParticleSettings *ps, glm::vec2 pos)
 {
-	int recreatedParticlesThisFrame = 0;
+	int count = std::min(ps->onCreateCount, freeCount);
 
-	for (int i = 0; i < size; i++)
+	for (int n = 0; n < count; n++)
 	{
-
-		if (recreatedParticlesThisFrame < ps->onCreateCount &&
-			sizeXY[i] == 0)
-		{
-
-			duration[i] = rand(ps->particleLifeTime);
-			durationTotal[i] = duration[i];
-
-			//reset particle
-			posX[i] = pos.x + rand(ps->positionX);
-			posY[i] = pos.y + rand(ps->positionY);
-			directionX[i] = rand(ps->directionX);
-			directionY[i] = rand(ps->directionY);
-			rotation[i] = rand(ps->rotation);;
-			sizeXY[i] = rand(ps->createApearence.size);
-			dragX[i] = rand(ps->dragX);
-			dragY[i] = rand(ps->dragY);
-			color[i].x = rand({ps->createApearence.color1.x, ps->createApearence.color2.x});
-			color[i].y = rand({ps->createApearence.color1.y, ps->createApearence.color2.y});
-			color[i].z = rand({ps->createApearence.color1.z, ps->createApearence.color2.z});
-			color[i].w = rand({ps->createApearence.color1.w, ps->createApearence.color2.w});
-			rotationSpeed[i] = rand(ps->rotationSpeed);
-			rotationDrag[i] = rand(ps->rotationDrag);
-			textures[i] = ps->texturePtr;
-			deathRattle[i] = ps->deathRattle;
-			tranzitionType[i] = ps->tranzitionType;
-			thisParticleSettings[i] = ps;
-			emitParticle[i] = ps->subemitParticle;
-			emitTime[i] = rand(thisParticleSettings[i]->subemitParticleTime);
-
-			recreatedParticlesThisFrame++;
-		}
-
-
-
+		int i = freeSlots[--freeCount];
+
+		duration[i] = rand(ps->particleLifeTime);
+		durationTotal[i] = duration[i];
+
+		//reset particle
+		posX[i] = pos.x + rand(ps->positionX);
+		posY[i] = pos.y + rand(ps->positionY);
+		directionX[i] = rand(ps->directionX);
+		directionY[i] = rand(ps->directionY);
+		rotation[i] = rand(ps->rotation);;
+		sizeXY[i] = rand(ps->createApearence.size);
+		dragX[i] = rand(ps->dragX);
+		dragY[i] = rand(ps->dragY);
+		color[i].x = rand({ps->createApearence.color1.x, ps->createApearence.color2.x});
+		color[i].y = rand({ps->createApearence.color1.y, ps->createApearence.color2.y});
+		color[i].z = rand({ps->createApearence.color1.z, ps->createApearence.color2.z});
+		color[i].w = rand({ps->createApearence.color1.w, ps->createApearence.color2.w});
+		rotationSpeed[i] = rand(ps->rotationSpeed);
+		rotationDrag[i] = rand(ps->rotationDrag);
+		textures[i] = ps->texturePtr;
+		deathRattle[i] = ps->deathRattle;
+		tranzitionType[i] = ps->tranzitionType;
+		thisParticleSettings[i] = ps;
+		emitParticle[i] = ps->subemitParticle;
+		emitTime[i] = rand(thisParticleSettings[i]->subemitParticleTime);
+
+		alive[i] = 1;
+		liveCount++;
+		activeEnd = std::max(activeEnd, i + 1);
 	}
 
-
 }
 
 float interpolate(float a, float b, float perc)
@@ -467,7 +392,11 @@ void ParticleSystem::draw(Renderer2D &r)
 
 		r.flush();
 
-		if (fb.texture.GetSize() != glm::ivec2{w / pixelateFactor,h / pixelateFactor})
+		if (!fb.fbo)
+		{
+			fb.create(w / pixelateFactor, h / pixelateFactor);
+		}
+		else if (fb.texture.GetSize() != glm::ivec2{w / pixelateFactor,h / pixelateFactor})
 		{
 			fb.resize(w / pixelateFactor, h / pixelateFactor);
 
@@ -478,9 +407,9 @@ void ParticleSystem::draw(Renderer2D &r)
 	}
 
 
-	for (int i = 0; i < size; i++)
+	for (int i = 0; i < activeEnd; i++)
 	{
-		if (sizeXY[i] == 0) { continue; }
+		if (!alive[i]) { continue; }
 
 		float lifePerc = duration[i] / durationTotal[i]; //close to 0 when gone, 1 when full
 
@@ -580,11 +509,11 @@ void ParticleSystem::draw(Renderer2D &r)
 
 		if (textures[i] != nullptr)
 		{
-			r.renderRectangle(p, *textures[i], c, { 0, 0 }, rotation[i]);
+			r.renderSprite(p, *textures[i], c, { 0, 0 }, rotation[i]);
 		}
 		else
 		{
-			r.renderRectangle(p, c, {0,0}, rotation[i]);
+			r.renderSprite(p, c, {0,0}, rotation[i]);
 		}
 
 